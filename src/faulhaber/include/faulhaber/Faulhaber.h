@@ -0,0 +1,101 @@
+#ifndef FAULHABER_H
+#define FAULHABER_H
+
+/*--------------------------------------------------------------
+ * class faulhaber::Faulhaber
+ * ros2_control ActuatorInterface of a single drive.
+ * The serial line is run by a MCBus in its own thread. read() and
+ * write() only exchange the latest values with it and never wait
+ * for the bus, so the cycle of the controller_manager isn't
+ * affected by the time the drive takes to respond.
+ *
+ * Parameters of the <hardware> tag:
+ *   port         serial device, default /dev/ttyUSB0
+ *   baud_rate    default 115200
+ *   poll_rate    rate of the position and velocity reads in Hz, default 50
+ *   reset_on_configure  reset the drive before configuring, default false
+ *   homing_timeout      home the drive on activate within ms, default 0 for none
+ *   extrapolation_horizon ms a position is carried forward at most, default 20
+ *   stale_timeout       ms without a new position before it is stale, default 100
+ *   simulation   off, launch to run the drives by a MCDriveSim of its own
+ *                with the nodes of the joints, or attach to a simulation
+ *                already running at port; default off
+ *   sim_time_scale  simulated time per real time, 1..1000, default 1
+ *   sim_latency_us  processing latency of a launched simulation, default 500
+ *   latency_profile, sdo_timeout, cw_timeout, timeout_retries and
+ *   busy_retries, see FaulhaberParams
+ *   shm_name     export the state of the drives into shared memory under
+ *                this name, e.g. /faulhaber_arm, for other processes, see
+ *                MCShmReader; optional
+ * Parameters of the <joint> tag:
+ *   node_id         NodeId of the drive, 1..127
+ *   position_factor drive units per rad, default 1
+ *   velocity_factor drive units per rad/s, default 60/2pi for rpm, see
+ *                   FaulhaberRpmPerRadS
+ *   homing_method   written to 0x6098 when configuring, -4..-1 or
+ *                   1..37, optional
+ *   extrapolate     estimate the position between the samples by a
+ *                   MCExtrapolator, default false
+ *   poll_rate, poll_priority, poll_objects and the timeouts and retries
+ *   of the drive, see FaulhaberParams
+ * Besides position and velocity, the joint has the state interfaces
+ *   position_stamp, velocity_stamp  time the value is valid for, in s
+ *                                   of the time of read()
+ *   stale                           1 if the position is outdated
+ * and one per object of its poll_objects.
+ * The diagnostics of the bus are exported by a FaulhaberDiagnostics.
+ * The line and the interfaces are run by a FaulhaberLine, shared with
+ * FaulhaberSystem.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include <string>
+#include <vector>
+
+#include "hardware_interface/actuator_interface.hpp"
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/hardware_info.hpp"
+#include "hardware_interface/types/hardware_interface_return_values.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp_lifecycle/state.hpp"
+
+#include "faulhaber/FaulhaberLine.h"
+
+namespace faulhaber
+{
+
+class Faulhaber : public hardware_interface::ActuatorInterface
+{
+	public:
+		RCLCPP_SHARED_PTR_DEFINITIONS(Faulhaber)
+
+		hardware_interface::CallbackReturn on_init(const hardware_interface::HardwareInfo &info) override;
+		hardware_interface::CallbackReturn on_configure(const rclcpp_lifecycle::State &previous_state) override;
+		hardware_interface::CallbackReturn on_cleanup(const rclcpp_lifecycle::State &previous_state) override;
+		hardware_interface::CallbackReturn on_activate(const rclcpp_lifecycle::State &previous_state) override;
+		hardware_interface::CallbackReturn on_deactivate(const rclcpp_lifecycle::State &previous_state) override;
+
+		std::vector<hardware_interface::StateInterface> export_state_interfaces() override;
+		std::vector<hardware_interface::CommandInterface> export_command_interfaces() override;
+
+		hardware_interface::return_type prepare_command_mode_switch(
+			const std::vector<std::string> &start_interfaces,
+			const std::vector<std::string> &stop_interfaces) override;
+		hardware_interface::return_type perform_command_mode_switch(
+			const std::vector<std::string> &start_interfaces,
+			const std::vector<std::string> &stop_interfaces) override;
+
+		hardware_interface::return_type read(const rclcpp::Time &time, const rclcpp::Duration &period) override;
+		hardware_interface::return_type write(const rclcpp::Time &time, const rclcpp::Duration &period) override;
+
+	private:
+		FaulhaberLine Line{rclcpp::get_logger("Faulhaber")};
+};
+
+}  // namespace faulhaber
+
+#endif
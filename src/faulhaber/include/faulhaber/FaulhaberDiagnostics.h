@@ -0,0 +1,85 @@
+#ifndef FAULHABER_DIAGNOSTICS_H
+#define FAULHABER_DIAGNOSTICS_H
+
+/*--------------------------------------------------------------
+ * class faulhaber::FaulhaberDiagnostics
+ * makes the MCBusDiagnostics of a MCBus visible to ROS, used by both
+ * hardware interfaces.
+ * Update() is called from read(). It only copies the latest counters
+ * into the exported state interfaces and hands them over to the
+ * diagnostic_updater, so it doesn't allocate or wait. The updater
+ * publishes /diagnostics from a node and an executor thread of its own.
+ *
+ * State interfaces per joint:
+ *   sdo_rtt_p50, sdo_rtt_p99  SDO round trip in ms
+ *   sdo_timeouts, sdo_retries since the configure
+ *   statusword_age            ms since the last SW
+ * and of the line, named after the hardware:
+ *   bus_load                  share of the line used, 0..1
+ *   crc_errors, lease_expiries
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "diagnostic_updater/diagnostic_updater.hpp"
+#include "hardware_interface/handle.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "faulhaber/MCBus.h"
+#include "faulhaber/MCTripleBuffer.h"
+
+namespace faulhaber
+{
+
+const uint8_t FaulhaberDiagAxisValues = 5;
+const uint8_t FaulhaberDiagBusValues = 3;
+
+class FaulhaberDiagnostics
+{
+	public:
+		~FaulhaberDiagnostics();
+
+		void Init(const std::string &, const std::vector<std::string> &);
+		void ExportStates(std::vector<hardware_interface::StateInterface> &);
+
+		bool Start();
+		void Stop();
+
+		void Update(MCBus &);
+
+	private:
+		void ProduceBus(diagnostic_updater::DiagnosticStatusWrapper &);
+		void ProduceAxis(diagnostic_updater::DiagnosticStatusWrapper &, uint8_t);
+
+		std::string HwName;
+		std::vector<std::string> Joints;
+
+		//owned by read()
+		MCBusDiagnostics Act = {};
+		double AxisValues[MCBusMaxAxes][FaulhaberDiagAxisValues] = {};
+		double BusValues[FaulhaberDiagBusValues] = {};
+
+		//written by read(), read by the updater
+		MCTripleBuffer<MCBusDiagnostics> Shared;
+
+		//owned by the updater, the counters of its last report
+		uint32_t ReportedCrcErrors = 0;
+		uint32_t ReportedTimeOuts[MCBusMaxAxes] = {};
+
+		rclcpp::Node::SharedPtr Node;
+		std::shared_ptr<diagnostic_updater::Updater> Updater;
+		std::shared_ptr<rclcpp::executors::SingleThreadedExecutor> Executor;
+		std::thread Spinner;
+};
+
+}  // namespace faulhaber
+
+#endif
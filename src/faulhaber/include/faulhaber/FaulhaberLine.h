@@ -0,0 +1,125 @@
+#ifndef FAULHABERLINE_H
+#define FAULHABERLINE_H
+
+/*--------------------------------------------------------------
+ * class faulhaber::FaulhaberLine
+ * the serial line shared by Faulhaber and FaulhaberSystem: its MCBus
+ * with the drives of the joints, a launched simulation, the shared
+ * memory export and the diagnostics, and the command and state
+ * interfaces of each joint.
+ * The plugins only check the number of joints and hand over their
+ * lifecycle and cycle calls, each with its own logger and timeouts.
+ * For the parameters see Faulhaber and FaulhaberParams.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/hardware_info.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+#include "faulhaber/FaulhaberDiagnostics.h"
+#include "faulhaber/FaulhaberParams.h"
+#include "faulhaber/MCBus.h"
+#include "faulhaber/MCDriveSim.h"
+#include "faulhaber/MCExtrapolator.h"
+#include "faulhaber/MCShmExport.h"
+
+namespace faulhaber
+{
+
+//drive units of a speed in rpm per rad/s, the default velocity_factor
+const double FaulhaberRpmPerRadS = 60.0 / (2.0 * 3.14159265358979);
+
+//the interfaces of a joint and the state of its drive
+typedef struct FaulhaberJoint {
+	uint8_t NodeId = 0;
+	double PositionFactor = 1.0;
+	double VelocityFactor = FaulhaberRpmPerRadS;
+	bool isExtrapolated = false;
+
+	double PositionCmd = 0.0;
+	double VelocityCmd = 0.0;
+	double PositionState = 0.0;
+	double VelocityState = 0.0;
+	double PositionStamp = 0.0;
+	double VelocityStamp = 0.0;
+	double StaleState = 1.0;
+
+	MCExtrapolator Extrapolator;
+	//ms from the time each value is valid for to the last UpdateStates()
+	uint32_t PositionAge = 0;
+	uint32_t VelocityAge = 0;
+
+	MCBusCmdModes CmdMode = eBusCmdNone;
+} FaulhaberJoint;
+
+class FaulhaberLine
+{
+	public:
+		explicit FaulhaberLine(const rclcpp::Logger &);
+
+		bool Init(const hardware_interface::HardwareInfo &);
+		bool Open(uint32_t);
+		void Close();
+		bool Activate(uint32_t);
+		bool Deactivate(uint32_t);
+
+		void ExportStates(std::vector<hardware_interface::StateInterface> &);
+		void ExportCommands(std::vector<hardware_interface::CommandInterface> &);
+
+		bool CheckModes(const std::vector<std::string> &);
+		bool SwitchModes(const std::vector<std::string> &, const std::vector<std::string> &, uint32_t);
+
+		bool Read(const rclcpp::Time &);
+		void Write();
+
+	private:
+		void ReadHwParams(const FaulhaberParamMap &);
+		void AddJoint(const hardware_interface::ComponentInfo &);
+		void UpdateStates();
+		bool StartSim();
+		bool WaitForPhase(MCBusPhases, uint32_t);
+		bool WaitForSwitch(uint32_t);
+		MCBusCmdModes FindMode(uint8_t, const std::vector<std::string> &);
+
+		rclcpp::Logger Log;
+		std::vector<std::string> Names;
+
+		MCShmExport Shm;       //outlives the worker of the bus
+		MCBus Bus;
+		std::unique_ptr<MCDriveSim> Sim;
+		FaulhaberDiagnostics Diag;
+
+		std::string Port = "/dev/ttyUSB0";
+		uint32_t BaudRate = 115200;
+		uint16_t PollRate = 50;
+		bool isResetOnConfigure = false;
+		uint16_t HomingTimeOut = 0;
+		uint16_t Horizon = 20;
+		uint16_t StaleTimeOut = 100;
+		bool isSimLaunched = false;
+		uint16_t TimeScale = 1;
+		uint16_t SimLatency = 500;
+		std::string ShmName;
+
+		FaulhaberJoint Joints[MCBusMaxAxes];
+		uint8_t Count = 0;
+		MCBusCommand Cmd[MCBusMaxAxes] = {};
+
+		//further objects polled, as state interfaces
+		std::vector<FaulhaberPollObject> Polls;
+		MCBusPollValue PollValue[MCBusMaxPolls] = {};
+		double PollState[MCBusMaxPolls] = {};
+};
+
+}  // namespace faulhaber
+
+#endif
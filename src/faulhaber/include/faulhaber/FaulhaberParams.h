@@ -0,0 +1,65 @@
+#ifndef FAULHABERPARAMS_H
+#define FAULHABERPARAMS_H
+
+/*--------------------------------------------------------------
+ * FaulhaberParams
+ * the tuning of the bus and of its drives taken from the
+ * parameters of the <hardware> and <joint> tags, shared by
+ * Faulhaber and FaulhaberSystem. Invalid values throw a
+ * std::invalid_argument, as do numbers out of their range or
+ * followed by anything, see ToNumber().
+ *
+ * Parameters of the <hardware> tag:
+ *   latency_profile  default, or low_latency for the low latency mode
+ *                    of the serial driver, e.g. of an FTDI
+ * Parameters of the <hardware> tag, each may be overridden per <joint>:
+ *   sdo_timeout      ms a SDO response may take, default 12
+ *   cw_timeout       ms a CW response may take, default 5
+ *   timeout_retries  resends after a timeout, default 1
+ *   busy_retries     resends while the line is in use, default 1 for a
+ *                    CW and 3 for a SDO
+ * Parameters of the <joint> tag:
+ *   poll_rate        rate of the position and velocity reads in Hz,
+ *                    default the one of the <hardware> tag
+ *   poll_priority    priority of these reads, default 0
+ *   poll_objects     further objects to be read, separated by blanks
+ *                    or commas, each as name=Idx.SubIdx@RateHz[:Priority]
+ *                    with Idx and SubIdx in hex, e.g.
+ *                    current=0x6078.0@100:1 temperature=0x2326.3@5
+ *                    Each is exported as a state interface of the joint
+ *                    named by its name, with the raw signed value.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hardware_interface/hardware_info.hpp"
+
+#include "faulhaber/MCBus.h"
+
+namespace faulhaber
+{
+
+typedef std::unordered_map<std::string, std::string> FaulhaberParamMap;
+
+//a further object polled, exported as a state interface of its joint
+typedef struct FaulhaberPollObject {
+	std::string Joint;
+	std::string Name;
+	uint8_t Slot;           //of MCBus::AddPoll()
+} FaulhaberPollObject;
+
+uint32_t ToNumber(const std::string &, uint32_t, uint32_t, int Base = 10);
+void ApplyBusParams(const FaulhaberParamMap &, MCBus &);
+void ApplyJointParams(const FaulhaberParamMap &, const hardware_interface::ComponentInfo &, MCBus &, uint8_t,
+	std::vector<FaulhaberPollObject> &);
+
+}  // namespace faulhaber
+
+#endif
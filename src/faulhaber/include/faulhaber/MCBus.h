@@ -0,0 +1,280 @@
+#ifndef MCBUS_H
+#define MCBUS_H
+
+/*--------------------------------------------------------------
+ * class MCBus
+ * runs a MsgHandler with all the drives on its serial line in a
+ * worker thread of its own. Callers with a cycle of their own, like
+ * the read() and write() of ros2_control, only exchange the latest
+ * commands and states with the worker through MCTripleBuffers. So
+ * neither side is ever blocked by the other or by the bus, and the
+ * caller's side does no allocation, locking or I/O.
+ *
+ * Commands are the latest setpoint per axis. A target position is
+ * handed over as an immediate PP move, a speed is streamed in PV.
+ * Position and speed are polled by a MCPollScheduler shared by all
+ * axes; the SW is taken from the nodes. Each value carries the time
+ * it has been received, in ms of the clock of the worker, GetTime().
+ * Further objects may be polled by AddPoll(), each at a rate and a
+ * priority of its own; their values are handed over with the states.
+ *
+ * The OpMode of a command mode is set explicitly by SwitchModes(),
+ * PP for a position and PV for a speed. Once switched, commands of
+ * the other mode are ignored, so late commands can't switch back.
+ * A switch not finished in time can be given up by CancelSwitch().
+ *
+ * Open() brings up all drives concurrently by a MCDriveGroup: an
+ * optional reset, then the desired configuration of each drive written
+ * as a single batch. Activate() enables them the same way and may home
+ * them. The time each phase took is reported by GetTiming().
+ *
+ * The counters of the nodes and of the line are collected into
+ * MCBusDiagnostics once per MCBusDiagPeriod and handed over the
+ * same way as the states.
+ *
+ * For a simulated line its clock may run faster than real time, see
+ * SetTimeScale() and MCDriveSim.
+ *
+ * The worker may also export the state of each node into shared
+ * memory for other processes, see SetShmExport() and MCShmExport.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCDrive.h"
+#include "faulhaber/MCDriveGroup.h"
+#include "faulhaber/MCPollScheduler.h"
+#include "faulhaber/MCShmExport.h"
+#include "faulhaber/MCTripleBuffer.h"
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+//--- service define ---
+
+const uint8_t MCBusMaxAxes = MsgHandler_MaxNodes;
+const uint8_t MCBusNone = 0xff;
+//the entries of the poll set left besides position and speed of each axis
+const uint8_t MCBusMaxPolls = MCPollMaxEntries - 2 * MCBusMaxAxes;
+
+typedef enum MCBusCmdModes {
+	eBusCmdNone,
+	eBusCmdPosition,
+	eBusCmdVelocity
+} MCBusCmdModes;
+
+typedef enum MCBusPhases {
+	eBusClosed,
+	eBusConfiguring,
+	eBusIdle,
+	eBusEnabling,
+	eBusHoming,
+	eBusRunning,
+	eBusDisabling,
+	eBusError
+} MCBusPhases;
+
+typedef enum MCBusSwitchStates {
+	eBusSwitchIdle,
+	eBusSwitchPending,
+	eBusSwitchDone,
+	eBusSwitchError,
+	eBusSwitchCancelled
+} MCBusSwitchStates;
+
+typedef struct MCBusCommand {
+	MCBusCmdModes Mode;
+	int32_t Position;       //in drive units
+	int32_t Velocity;       //in drive units
+} MCBusCommand;
+
+typedef struct MCBusState {
+	int32_t Position;
+	int32_t Velocity;
+	uint16_t StatusWord;
+	uint32_t PositionAt;    //time each value has been received, see GetTime()
+	uint32_t VelocityAt;
+	uint32_t StatusWordAt;
+	uint32_t RxAt;          //time of the older one of position and velocity
+	bool isValid;           //both have been read at least once
+} MCBusState;
+
+typedef struct MCBusPollValue {
+	int32_t Value;
+	uint32_t RxAt;
+	bool isValid;
+} MCBusPollValue;
+
+//the sets exchanged with the worker as a whole
+typedef struct MCBusCommandSet {
+	MCBusCommand Cmd[MCBusMaxAxes];
+} MCBusCommandSet;
+
+typedef struct MCBusStateSet {
+	MCBusState State[MCBusMaxAxes];
+	MCBusPollValue Poll[MCBusMaxPolls];
+} MCBusStateSet;
+
+//time in ms each phase of the bring-up took, 0 if skipped
+typedef struct MCBusTiming {
+	uint32_t ResetMs;       //reset until all drives are booted and restored
+	uint32_t ConfigureMs;   //longest configuration of a drive
+	uint32_t EnableMs;
+	uint32_t HomingMs;
+	uint32_t DisableMs;
+} MCBusTiming;
+
+//counters since the bus has been opened, collected every MCBusDiagPeriod ms
+const uint32_t MCBusDiagPeriod = 100;
+
+typedef struct MCBusAxisDiag {
+	uint32_t RttP50;        //SDO round trip in ms
+	uint32_t RttP99;
+	uint32_t RttMax;
+	uint32_t Requests;
+	uint32_t Retries;       //resends after a timeout
+	uint32_t BusyRetries;   //sends refused as the line was in use
+	uint32_t TimeOuts;
+	uint32_t Errors;
+	uint32_t SWAge;         //ms since the last SW
+	uint32_t SwitchLatency; //ms the last OpMode switch took
+} MCBusAxisDiag;
+
+typedef struct MCBusDiagnostics {
+	uint32_t At;
+	uint32_t TxFrames;
+	uint32_t RxFrames;
+	uint32_t CrcErrors;
+	uint32_t LeaseExpiries;
+	uint16_t LoadPermille;      //share of the line used within the last period
+	uint16_t PollLoadPermille;  //share planned for the polls
+	MCBusAxisDiag Axis[MCBusMaxAxes];
+} MCBusDiagnostics;
+
+class MCBus {
+	public:
+		MCBus();
+		~MCBus();
+
+		uint8_t AddAxis(uint8_t);
+		uint8_t GetAxisCount();
+		MCDrive *GetDrive(uint8_t);
+		void SetPollRate(uint16_t);
+		bool SetAxisPolling(uint8_t, uint16_t, uint8_t);
+		uint8_t AddPoll(uint8_t, uint16_t, uint8_t, uint16_t, uint8_t);
+		void SetLowLatency(bool);
+		void SetResetOnOpen(bool);
+		void SetHomingOnActivate(uint16_t);
+		void SetTimeScale(uint16_t);
+		void SetShmExport(MCShmExport *);
+
+		bool Open(const char *, uint32_t);
+		void Close();
+
+		bool Activate();
+		bool Deactivate();
+		MCBusPhases GetPhase();
+		uint32_t GetTime();
+		MCBusTiming GetTiming();
+
+		bool SetCommands(const MCBusCommand *, uint8_t);
+		bool GetStates(MCBusState *, uint8_t);
+		void GetPolls(MCBusPollValue *, uint8_t);
+		bool GetDiagnostics(MCBusDiagnostics *);
+
+		bool SwitchModes(const MCBusCmdModes *, uint8_t);
+		void CancelSwitch();
+		MCBusSwitchStates GetSwitchState();
+		uint32_t GetSwitchLatency(uint8_t);
+
+	private:
+		void Run();
+		void Cycle(uint32_t);
+		void StepConfigure();
+		void StepAxis(uint8_t);
+		void StartRunning();
+		void StepSwitch();
+		void AbortSwitch(MCBusSwitchStates);
+		bool IsSwitching(uint8_t);
+		void Publish();
+		void PublishDiagnostics();
+		void ExportShm();
+
+		MsgHandler Handler;
+		MCDrive Drives[MCBusMaxAxes];
+		uint8_t AxisNodeId[MCBusMaxAxes] = {};
+		MCDriveGroup Group;
+		uint8_t AxisCount = 0;
+
+		bool isResetOnOpen = false;
+		bool isResetPending = false;
+		uint16_t HomingTimeOut = 0;
+		uint16_t TimeScale = 1;
+
+		MCPollScheduler Poll;
+		uint16_t PollRate = 50;
+		uint16_t AxisPollRate[MCBusMaxAxes] = {};     //0 for PollRate
+		uint8_t AxisPollPriority[MCBusMaxAxes] = {};
+		uint8_t PosHandle[MCBusMaxAxes];
+		uint8_t VelHandle[MCBusMaxAxes];
+
+		//further objects polled, see AddPoll()
+		uint8_t PollCount = 0;
+		uint8_t PollAxis[MCBusMaxPolls];
+		uint16_t PollIdx[MCBusMaxPolls];
+		uint8_t PollSubIdx[MCBusMaxPolls];
+		uint16_t PollObjRate[MCBusMaxPolls];
+		uint8_t PollPriority[MCBusMaxPolls];
+		uint8_t PollHandle[MCBusMaxPolls];
+
+		//written by SetCommands(), read by the worker
+		MCTripleBuffer<MCBusCommandSet> Commands;
+
+		//owned by the worker
+		MCBusCommand ActCmd[MCBusMaxAxes] = {};
+		int32_t MoveTarget[MCBusMaxAxes] = {};
+		bool isMoving[MCBusMaxAxes] = {};
+		bool isTargetSet[MCBusMaxAxes] = {};
+		MCBusState ActState[MCBusMaxAxes] = {};
+		MCBusPollValue ActPoll[MCBusMaxPolls] = {};
+		MCBusCmdModes AxisMode[MCBusMaxAxes] = {};
+		bool isSwitchStarted[MCBusMaxAxes] = {};
+		bool isSwitchDone[MCBusMaxAxes] = {};
+
+		//written by SwitchModes() before the switch is set pending
+		MCBusCmdModes SwitchMode[MCBusMaxAxes] = {};
+		std::atomic<MCBusSwitchStates> Switch{eBusSwitchIdle};
+		std::atomic<bool> isSwitchCancel{false};    //set by CancelSwitch()
+		std::atomic<uint32_t> SwitchLatency[MCBusMaxAxes];
+
+		//written by the worker, read by GetStates()
+		MCTripleBuffer<MCBusStateSet> States;
+
+		//written by the worker, read by GetDiagnostics()
+		MCTripleBuffer<MCBusDiagnostics> Diagnostics;
+		MCFrameCounts DiagCounts = {};
+		uint32_t DiagAt = 0;
+		uint32_t BaudRate = 115200;
+
+		//written by the worker into the region of ShmExport, see ExportShm()
+		MCShmExport *ShmExport = NULL;
+		MCShmNodeState ShmState[MCBusMaxAxes] = {};
+		uint32_t ShmEmcyNext[MCBusMaxAxes] = {};
+		bool isShmWritten[MCBusMaxAxes] = {};
+
+		//written by the worker before it changes the phase
+		MCBusTiming Timing = {};
+
+		std::atomic<MCBusPhases> Phase{eBusClosed};
+		std::atomic<bool> isRunning{false};
+		std::thread Worker;
+		std::chrono::steady_clock::time_point OpenedAt;
+
+		uint32_t actTime = 0;
+};
+
+#endif
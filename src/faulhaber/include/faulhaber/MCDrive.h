@@ -26,6 +26,23 @@ typedef enum DriveCommStates {
 	eMCTimeout
 } DriveCommStates;
 
+const uint8_t MCDriveMaxBatch = 8;
+const uint8_t MCDrivePPQueueSize = 8;
+const uint8_t MCDriveMaxDesiredParams = 8;
+//custom parameters, profile, homing method and OpMode
+const uint8_t MCDriveMaxRestore = MCDriveMaxDesiredParams + 6;
+//time a drive gets to send its boot Msg after a reset
+const uint32_t MCDriveBootTimeOut = 3000;
+
+//frames and time used to start a PP move
+typedef struct MCMoveStats {
+	uint32_t TxFrames;
+	uint32_t RxFrames;
+	uint32_t WireUs;
+	uint32_t DurationMs;
+	bool isFastPath;
+} MCMoveStats;
+
 typedef struct MCDriveParameter {
 	uint16_t index;
 	uint8_t subIndex;
@@ -44,6 +61,7 @@ class MCDrive {
 		void ResetComState(); 
 		void SetTORetryMax(uint8_t);
 		void SetBusyRetryMax(uint8_t);
+		void SetRespTimeOuts(uint16_t, uint16_t);
 		
 		DriveCommStates UpdateDriveStatus();		
 		DriveCommStates SendReset();
@@ -64,16 +82,33 @@ class MCDrive {
   	DriveCommStates WriteObject(uint16_t idx, uint8_t subIdx, uint32_t value);
 
 		DriveCommStates SetOpMode(int8_t);
+		DriveCommStates SwitchOpMode(int8_t);
+		uint32_t GetSwitchLatency();
 		DriveCommStates SetProfile(uint32_t, uint32_t, uint32_t, int16_t);		
 		
 		DriveCommStates StartAbsMove(int32_t, bool);
 		DriveCommStates StartRelMove(int32_t, bool);
+		DriveCommStates FastMovePP(int32_t, bool, bool);
+		void GetLastMoveStats(MCMoveStats *);
+
+		DriveCommStates PreloadMovePP(int32_t);
+		uint16_t GetPPStartCW(bool, bool);
+		void PPStartSent(uint16_t, uint32_t TxDelay = 0);
+		DriveCommStates FinishMovePP(bool, bool);
+		uint32_t GetPPAckAt();
+
+		bool PushPPTarget(int32_t);
+		uint8_t GetPPQueueFree();
+		void ClearPPQueue();
+		DriveCommStates RunPPQueue(bool relative = false);
 	
   	DriveCommStates ConfigureHoming(int8_t);
 		DriveCommStates DoHoming(uint16_t);
 
     DriveCommStates MoveAtSpeed(int32_t);
-		
+		DriveCommStates StreamSpeed(int32_t, uint32_t);
+		DriveCommStates SetCyclicMode(int8_t, uint8_t);
+
 		DriveCommStates IsInPos();
 		DriveCommStates IsHomingFinished();
 		
@@ -88,6 +123,15 @@ class MCDrive {
 		
 		bool IsLive();
 		uint16_t GetLastError();
+
+		void SetDesiredOpMode(int8_t);
+		void SetDesiredProfile(uint32_t, uint32_t, uint32_t, int16_t);
+		void SetDesiredHoming(int8_t);
+		bool AddDesiredParam(uint16_t, uint8_t, uint8_t, uint32_t);
+		void ClearDesiredConfig();
+		DriveCommStates GetRestoreState();
+		uint32_t GetRestoreLatency();
+		DriveCommStates ConfigureDrive();
 			
 		MCNode ThisNode;
 
@@ -95,17 +139,27 @@ class MCDrive {
 		void OnTimeOut();
 		DriveCommStates Wait4Status(uint16_t, uint16_t);
 		DriveCommStates MovePP(int32_t,bool, bool);
+		void SetBatchEntry(uint8_t, MCMsgCommands, uint16_t, uint8_t, uint8_t, uint32_t);
+		DriveCommStates RunBatch(uint8_t);
+		void BeginMoveStats(bool);
+		DriveCommStates EndMoveStats(DriveCommStates);
+		bool AbortOnFault();
+		void OnBoot();
+		void BuildRestore(uint32_t);
+		void RunRestore();
 		
 		DriveCommStates MCDriveRxTxState = eMCIdle;
 		
 		uint8_t AccessStep = 0;
 		
-		int8_t OpModeRequested;
-		int8_t OpModeReported;		
+		int8_t OpModeRequested = 0;
+		int8_t OpModeReported = 0;		
 		
 		SDOCommStates SDOAccessState = eSDOIdle;
 		CWCommStates CWAccessState = eCWIdle;
 
+		SDOBatchEntry Batch[MCDriveMaxBatch];
+
 		uint8_t TORetryCounter = 0;
 		uint8_t TORetryMax = 1;
 		uint8_t BusyRetryCounter = 0;
@@ -116,6 +170,55 @@ class MCDrive {
 		uint32_t actTime;
 
 		bool isLive = false;
+
+		//targets of RunPPQueue()
+		int32_t PPQueue[MCDrivePPQueueSize];
+		uint8_t PPQueueHead = 0;
+		uint8_t PPQueueCount = 0;
+
+		MsgHandler *Handler = NULL;
+
+		//last speed written by StreamSpeed()
+		int32_t SpeedRequested = 0;
+		int32_t SpeedSent = 0;
+		uint32_t SpeedSentAt = 0;
+		bool isSpeedSent = false;
+
+		bool isFastFallback = false;
+		bool isMoveStatsActive = false;
+		bool isMoveFast = false;
+		uint32_t MoveStartedAt = 0;
+		MCFrameCounts MoveStartCounts = {};
+		MCMoveStats LastMove = {};
+
+		bool isPPPreloaded = false;
+		uint32_t PPAckAt = 0;
+
+		//configuration to be restored whenever the drive boots
+		int8_t DesiredOpMode = 0;
+		bool hasDesiredProfile = false;
+		uint32_t DesiredProfile[3];
+		int16_t DesiredProfileType = 0;
+		bool hasDesiredHoming = false;
+		int8_t DesiredHoming = 0;
+		SDOBatchEntry DesiredParams[MCDriveMaxDesiredParams];
+		uint8_t DesiredParamCount = 0;
+
+		SDOBatchEntry RestoreBatch[MCDriveMaxRestore];
+		uint8_t RestoreCount = 0;
+		uint32_t BootsSeen = 0;
+		DriveCommStates RestoreState = eMCIdle;
+		uint32_t RestoreLatency = 0;
+		uint32_t RestoreStartedAt = 0;
+
+		//SendReset() waits for the boot Msg
+		bool isBootExpected = false;
+		uint32_t BootsAtReset = 0;
+		uint32_t ResetSentAt = 0;
+
+		//timing of SwitchOpMode()
+		uint32_t SwitchStartedAt = 0;
+		uint32_t SwitchLatency = 0;
 };
 
 #endif
@@ -0,0 +1,128 @@
+#ifndef MCDRIVEGROUP_H
+#define MCDRIVEGROUP_H
+
+/*--------------------------------------------------------------
+ * class MCDriveGroup
+ * runs the same step sequence on several drives at once.
+ * Each call steps all drives which are not yet finished, starting
+ * with a different drive each call. While one drive waits for its
+ * response or for its StatusWord to change, the others can use the
+ * bus. So the frames of the different nodes are interleaved and a
+ * group sequence takes about as long as the slowest drive.
+ *
+ * The group calls follow the pattern of MCDrive:
+ * --> eMCWaiting while any drive is still busy
+ * --> eMCDone when all drives are finished
+ * --> eMCError/eMCTimeout at the first drive failing. The other drives
+ *     are stopped in their sequence then. See GetFailedDrive().
+ * After eMCDone/eMCError/eMCTimeout the next call starts over.
+ *
+ * Bringing up the drives by ResetDrives() and ConfigureDrives() is
+ * pipelined the same way: each drive gets its next request as soon as
+ * its last one is answered, independent of the others.
+ *
+ * A synchronised PP start is done in two phases: PreloadAbsMoves()
+ * writes the targets to all drives, StartPreloaded() sends all start
+ * CWs in a single write and waits for all drives to acknowledge.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCDrive.h"
+#include <stdint.h>
+
+//--- service define ---
+
+const uint8_t MCGroupMaxDrives = MsgHandler_MaxNodes;
+const uint8_t MCGroupNone = 0xff;
+
+typedef enum MCGroupOps {
+	eGroupNone,
+	eGroupEnable,
+	eGroupDisable,
+	eGroupStop,
+	eGroupSetProfile,
+	eGroupAbsMove,
+	eGroupRelMove,
+	eGroupInPos,
+	eGroupConfigureHoming,
+	eGroupHoming,
+	eGroupPreload,
+	eGroupFinishPP,
+	eGroupReset,
+	eGroupConfigure
+} MCGroupOps;
+
+class MCDriveGroup {
+	public:
+		MCDriveGroup();
+
+		void Connect2MsgHandler(MsgHandler *);
+		bool AddDrive(MCDrive *);
+		uint8_t GetCount();
+		MCDrive *GetDrive(uint8_t);
+
+		void SetActTime(uint32_t);
+		void ResetComState();
+
+		DriveCommStates ResetDrives();
+		DriveCommStates ConfigureDrives();
+		DriveCommStates EnableDrives();
+		DriveCommStates DisableDrives();
+		DriveCommStates StopDrives();
+		DriveCommStates SetProfiles(uint32_t, uint32_t, uint32_t, int16_t);
+		DriveCommStates StartAbsMoves(const int32_t *, bool);
+		DriveCommStates StartRelMoves(const int32_t *, bool);
+		DriveCommStates AreInPos();
+		DriveCommStates ConfigureHoming(int8_t);
+		DriveCommStates DoHoming(uint16_t);
+
+		DriveCommStates PreloadAbsMoves(const int32_t *);
+		DriveCommStates StartPreloaded(bool, bool);
+		uint32_t GetStartSkewUs();
+		uint32_t GetAckSpread();
+
+		uint8_t GetFailedDrive();
+		DriveCommStates GetDriveState(uint8_t);
+		uint32_t GetDuration();
+		uint32_t GetDriveDuration(uint8_t);
+
+	private:
+		DriveCommStates Run(MCGroupOps);
+		DriveCommStates StepDrive(uint8_t);
+		DriveCommStates SendStartBurst(bool, bool);
+		void ReleaseBurst(bool);
+
+		MsgHandler *Handler = NULL;
+
+		MCDrive *Drives[MCGroupMaxDrives];
+		DriveCommStates DriveState[MCGroupMaxDrives];
+		uint32_t DriveDoneAt[MCGroupMaxDrives];
+		uint8_t Count = 0;
+
+		MCGroupOps ActOp = eGroupNone;
+		uint8_t FirstDrive = 0;
+		uint8_t FailedDrive = MCGroupNone;
+
+		//arguments of the running sequence
+		int32_t Targets[MCGroupMaxDrives];
+		uint32_t ProfileArg[3];
+		int16_t ProfileType = 0;
+		int8_t HomingMethod = 0;
+		uint16_t HomingTimeout = 0;
+		bool isImmediate = false;
+		bool isRelative = false;
+
+		uint32_t StartSkewUs = 0;
+		uint32_t AckSpread = 0;
+		bool isBurstLocked = false;     //the lock taken by SendStartBurst() is held
+
+		uint32_t StartedAt = 0;
+		uint32_t FinishedAt = 0;
+		uint32_t actTime = 0;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef MCDRIVESIM_H
+#define MCDRIVESIM_H
+
+/*--------------------------------------------------------------
+ * class MCDriveSim
+ * simulates the drives of a serial line behind a pseudo terminal,
+ * so the complete MsgHandler/SDOHandler/MCDrive path can be run
+ * without any hardware. The slave side of the PTY is opened like a
+ * real port, see GetPortName().
+ *
+ * Each node answers SDOs from a small object dictionary, runs the
+ * CiA 402 state machine on its CW, pushes its SW whenever it changes
+ * and moves in PP, PV and homing. A reset request is answered by a
+ * boot Msg after the boot time.
+ * Each response is sent when the request would have been received on
+ * the wire, plus the processing latency, plus the time the response
+ * itself takes on the wire at the baud rate. The responses are sent
+ * one after another like on a real line.
+ *
+ * With a TimeScale > 1 the simulated clock runs that much faster than
+ * real time. The MCBus talking to it has to be scaled the same, see
+ * MCBus::SetTimeScale().
+ *
+ * Positions are in increments, velocities in increments/s scaled by
+ * the VelocityScale.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MsgHandler.h"
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+//--- service define ---
+
+const uint8_t MCSimMaxNodes = MsgHandler_MaxNodes;
+const uint8_t MCSimMaxObjects = 32;
+const uint8_t MCSimTxQueueSize = 32;
+const uint8_t MCSimPortNameLen = 64;
+
+typedef struct MCSimObject {
+	uint16_t Idx;
+	uint8_t SubIdx;
+	uint8_t Len;
+	uint32_t Value;
+} MCSimObject;
+
+typedef struct MCSimNode {
+	uint8_t NodeId;
+	MCSimObject Objects[MCSimMaxObjects];
+	uint8_t ObjectCount;
+
+	uint16_t State;         //CiA 402 state bits of the SW
+	uint16_t ModeBits;      //bits of the OpMode
+	uint16_t ControlWord;
+	uint16_t ReportedSW;    //last one sent
+
+	double Position;
+	double Velocity;
+	double Target;
+	bool isMoving;
+
+	uint64_t BootDueUs;     //0 if none pending
+	uint64_t HomingDueUs;   //0 if not homing
+} MCSimNode;
+
+typedef struct MCSimFrame {
+	uint64_t DueUs;
+	uint8_t Len;
+	uint8_t Data[UART_MAX_MSG_SIZE];
+} MCSimFrame;
+
+class MCDriveSim {
+	public:
+		MCDriveSim();
+		~MCDriveSim();
+
+		bool AddNode(uint8_t);
+		void Configure(uint32_t, uint16_t, uint16_t);
+		void SetBootTime(uint16_t);
+		void SetVelocityScale(double);
+
+		bool Start();
+		void Stop();
+		const char *GetPortName();
+		bool LinkPort(const char *);
+
+		void InjectFault(uint8_t, uint16_t);
+		uint32_t GetRxFrames();
+		uint32_t GetTxFrames();
+
+	private:
+		void Run();
+		uint64_t GetSimUs();
+
+		void OnRxByte(uint8_t, uint64_t);
+		void OnRxFrame(uint64_t);
+		void OnSdo(MCSimNode *, uint8_t, const uint8_t *, uint8_t, uint64_t);
+		void OnCw(MCSimNode *, uint16_t, uint64_t);
+		void ApplyCw(MCSimNode *, uint16_t, uint64_t);
+		void Tick(uint64_t);
+		void Boot(MCSimNode *);
+
+		MCSimNode *FindNode(uint8_t);
+		MCSimObject *FindObject(MCSimNode *, uint16_t, uint8_t);
+		bool ReadObject(MCSimNode *, uint16_t, uint8_t, uint32_t *, uint8_t *);
+		bool WriteObject(MCSimNode *, uint16_t, uint8_t, uint32_t, uint8_t);
+		void SetObject(MCSimNode *, uint16_t, uint8_t, uint8_t, uint32_t);
+		uint16_t GetSW(MCSimNode *);
+		int8_t GetOpMode(MCSimNode *);
+		void PushSW(MCSimNode *, uint64_t);
+
+		void Send(uint8_t, uint8_t, const uint8_t *, uint8_t, uint64_t);
+		void Flush(uint64_t);
+		static uint8_t CalcCRC(const uint8_t *, int);
+
+		MCSimNode Nodes[MCSimMaxNodes];
+		uint8_t NodeCount = 0;
+
+		uint32_t BaudRate = 115200;
+		uint16_t LatencyUs = 500;
+		uint16_t TimeScale = 1;
+		uint16_t BootTime = 200;
+		double VelocityScale = 1.0;
+
+		int MasterFd = -1;
+		int SlaveFd = -1;
+		char PortName[MCSimPortNameLen] = {};
+
+		//frame being received
+		uint8_t RxFrame[UART_MAX_MSG_SIZE];
+		uint8_t RxIdx = 0;
+		uint8_t RxSize = 0;
+
+		//responses waiting for their time on the wire
+		MCSimFrame TxQueue[MCSimTxQueueSize];
+		uint8_t TxHead = 0;
+		uint8_t TxCount = 0;
+		uint64_t TxFreeAt = 0;
+		uint64_t LastTickUs = 0;
+
+		std::atomic<uint16_t> PendingFault[MCSimMaxNodes];
+		std::atomic<uint32_t> RxFrames{0};
+		std::atomic<uint32_t> TxFrames{0};
+
+		std::chrono::steady_clock::time_point StartedAt;
+		std::atomic<bool> isRunning{false};
+		std::thread Worker;
+};
+
+#endif
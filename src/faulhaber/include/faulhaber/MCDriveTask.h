@@ -0,0 +1,184 @@
+#ifndef MCDRIVETASK_H
+#define MCDRIVETASK_H
+
+/*--------------------------------------------------------------
+ * coroutine interface for the step sequences of MCDrive
+ *
+ * MCTask         a coroutine returning the final DriveCommStates
+ * MCExecutor     single-threaded executor driving the MsgHandler and
+ *                the operations awaited by the tasks
+ * MCAsyncDrive   awaitable versions of the MCDrive operations,
+ *                e.g. co_await Drive.Enable()
+ *
+ * The executor keeps a queue of awaited operations per drive. Only the
+ * first operation of each queue is stepped with each Update(), so
+ * several tasks using the same drive do not mix their step sequences
+ * and drives without pending operations cost nothing.
+ *
+ * Requires C++20. Is empty for older standards.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCDrive.h"
+#include <stdint.h>
+
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+
+class MCExecutor;
+
+//--- operations which can be awaited ---
+
+typedef enum MCDriveOps {
+	eOpEnable,
+	eOpDisable,
+	eOpStop,
+	eOpUpdateStatus,
+	eOpSetOpMode,
+	eOpSetProfile,
+	eOpMoveAbs,
+	eOpMoveRel,
+	eOpMoveAtSpeed,
+	eOpConfigureHoming,
+	eOpHoming,
+	eOpWaitInPos,
+	eOpReadObject,
+	eOpWriteObject
+} MCDriveOps;
+
+//--- a single awaited operation ---
+//lives in the frame of the awaiting coroutine while it is queued
+
+class MCDriveAwaiter {
+	public:
+		MCDriveAwaiter(MCExecutor *, MCDrive *, MCDriveOps);
+
+		bool await_ready() { return false; }
+		bool await_suspend(std::coroutine_handle<>);
+		DriveCommStates await_resume() { return State; }
+
+		MCExecutor *Executor;
+		MCDrive *Drive;
+		MCDriveOps Op;
+		int32_t Arg[4] = {0, 0, 0, 0};
+		uint32_t *Result = NULL;
+
+		DriveCommStates State = eMCIdle;
+		std::coroutine_handle<> Waiter;
+		MCDriveAwaiter *Next = NULL;
+};
+
+//--- the coroutine type ---
+
+class MCTask {
+	public:
+		struct promise_type {
+			DriveCommStates Result = eMCIdle;
+			std::coroutine_handle<> Continuation;
+			bool isDetached = false;
+
+			MCTask get_return_object() {
+				return MCTask(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+			std::suspend_always initial_suspend() noexcept { return {}; }
+
+			struct FinalAwaiter {
+				bool await_ready() noexcept { return false; }
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+					promise_type &p = h.promise();
+					if(p.Continuation)
+						return p.Continuation;
+					if(p.isDetached)
+						h.destroy();
+					return std::noop_coroutine();
+				}
+				void await_resume() noexcept {}
+			};
+			FinalAwaiter final_suspend() noexcept { return {}; }
+
+			void return_value(DriveCommStates state) { Result = state; }
+			void unhandled_exception() { std::terminate(); }
+		};
+
+		explicit MCTask(std::coroutine_handle<promise_type> h) : Handle(h) {}
+		MCTask(MCTask &&other) noexcept : Handle(other.Handle) { other.Handle = nullptr; }
+		MCTask(const MCTask &) = delete;
+		MCTask &operator=(const MCTask &) = delete;
+		~MCTask() { if(Handle) Handle.destroy(); }
+
+		//awaiting a task from another task runs it as a sub-sequence
+		bool await_ready() { return !Handle || Handle.done(); }
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> h) {
+			Handle.promise().Continuation = h;
+			return Handle;
+		}
+		DriveCommStates await_resume() { return Handle.promise().Result; }
+
+		bool IsDone() { return !Handle || Handle.done(); }
+		DriveCommStates GetResult() { return Handle ? Handle.promise().Result : eMCIdle; }
+
+	private:
+		friend class MCExecutor;
+		std::coroutine_handle<promise_type> Handle;
+};
+
+//--- the executor ---
+
+class MCExecutor {
+	public:
+		MCExecutor(MsgHandler *);
+
+		bool AddDrive(MCDrive *);
+		void Spawn(MCTask &&);
+		void Start(MCTask &);
+		void Update(uint32_t);
+		bool IsIdle();
+
+		bool Enqueue(MCDriveAwaiter *);
+
+	private:
+		uint8_t FindDrive(MCDrive *);
+		DriveCommStates Step(MCDriveAwaiter *);
+
+		MsgHandler *Handler;
+		MCDrive *Drives[MsgHandler_MaxNodes];
+		MCDriveAwaiter *Head[MsgHandler_MaxNodes];
+		MCDriveAwaiter *Tail[MsgHandler_MaxNodes];
+};
+
+//--- awaitable operations of a single drive ---
+
+class MCAsyncDrive {
+	public:
+		MCAsyncDrive(MCDrive *, MCExecutor *);
+
+		MCDriveAwaiter Enable();
+		MCDriveAwaiter Disable();
+		MCDriveAwaiter Stop();
+		MCDriveAwaiter UpdateStatus();
+		MCDriveAwaiter SetOpMode(int8_t);
+		MCDriveAwaiter SetProfile(uint32_t, uint32_t, uint32_t, int16_t);
+		MCDriveAwaiter MoveAbs(int32_t, bool immediate = false);
+		MCDriveAwaiter MoveRel(int32_t, bool immediate = false);
+		MCDriveAwaiter MoveAtSpeed(int32_t);
+		MCDriveAwaiter ConfigureHoming(int8_t);
+		MCDriveAwaiter DoHoming(uint16_t);
+		MCDriveAwaiter WaitInPos();
+		MCDriveAwaiter Read(uint16_t, uint8_t, uint32_t *);
+		MCDriveAwaiter Write(uint16_t, uint8_t, uint32_t, uint8_t);
+
+		MCDrive *Drive;
+
+	private:
+		MCExecutor *Executor;
+};
+
+#endif //__cpp_impl_coroutine
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef MCEXTRAPOLATOR_H
+#define MCEXTRAPOLATOR_H
+
+/*--------------------------------------------------------------
+ * class MCExtrapolator
+ * estimates the position of an axis between two samples of the bus.
+ * The position is read only every few ms per axis, while a controller
+ * may want a value each ms. So the last position is carried forward
+ * with the last velocity, assuming the speed to stay constant.
+ * The estimate is carried forward for Horizon ms at most, so a lost
+ * axis isn't moved on and on. An axis without a new position for
+ * longer than StaleTime ms is reported as stale.
+ *
+ * The velocity is in position units per s, e.g. rad and rad/s; times are
+ * in ms of the same clock as the samples.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include <stdint.h>
+
+class MCExtrapolator {
+	public:
+		void Configure(uint16_t, uint16_t);
+		void Reset();
+
+		void AddSample(double, uint32_t, double);
+		void Update(uint32_t);
+
+		double GetPosition();
+		double GetVelocity();
+		uint32_t GetAge();
+		bool IsStale();
+
+	private:
+		uint16_t Horizon = 20;
+		uint16_t StaleTime = 100;
+
+		//last sample
+		double Position = 0.0;
+		double Velocity = 0.0;
+		uint32_t PositionAt = 0;
+		bool hasSample = false;
+
+		//estimate of the last Update()
+		double EstPosition = 0.0;
+		uint32_t Age = 0;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef MCLIVEWATCHDOG_H
+#define MCLIVEWATCHDOG_H
+
+/*--------------------------------------------------------------
+ * class MCLiveWatchdog
+ * monitors whether the drives connected to a MsgHandler are still
+ * alive. Any valid frame of a node counts, so a node with regular
+ * traffic is never probed. Only a node quiet for longer than the
+ * QuietTime gets a read of its SW as a probe. A node without any
+ * frame for QuietTime + ProbeWindow is reported as lost.
+ * So a silent node is detected within GetDetectionTime() plus one
+ * cycle of Update().
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCDrive.h"
+#include <stdint.h>
+
+//--- service define ---
+
+const uint8_t MCLiveMaxNodes = MsgHandler_MaxNodes;
+const uint8_t MCLiveNone = 0xff;
+
+typedef enum MCLiveStates {
+	eLiveUnknown,
+	eLiveAlive,
+	eLiveLost
+} MCLiveStates;
+
+//handed over to the OnChangeCb
+typedef struct MCLiveEvent {
+	MCDrive *Drive;
+	MCLiveStates State;
+	uint32_t At;
+	uint32_t Silence;       //ms since the last frame of the node
+} MCLiveEvent;
+
+class MCLiveWatchdog {
+	public:
+		MCLiveWatchdog();
+
+		bool AddDrive(MCDrive *);
+		void Configure(uint16_t, uint16_t);
+		uint32_t GetDetectionTime();
+
+		void Update(uint32_t);
+
+		MCLiveStates GetState(MCDrive *);
+		uint32_t GetSilence(MCDrive *);
+		uint32_t GetProbeCount(MCDrive *);
+		uint32_t GetMissedCount(MCDrive *);
+
+		void Register_OnChangeCb(pfunction_holder *);
+
+	private:
+		uint8_t FindNode(MCDrive *);
+		void Probe(uint8_t);
+		void SetState(uint8_t, MCLiveStates);
+
+		MCDrive *Nodes[MCLiveMaxNodes];
+		MCLiveStates State[MCLiveMaxNodes];
+		uint32_t RxSeen[MCLiveMaxNodes];
+		uint32_t LastRxAt[MCLiveMaxNodes];
+		uint32_t ProbeAt[MCLiveMaxNodes];
+		uint32_t Ticket[MCLiveMaxNodes];
+		uint32_t Probes[MCLiveMaxNodes];
+		uint32_t Missed[MCLiveMaxNodes];
+		uint8_t Count = 0;
+
+		uint16_t QuietTime = 100;
+		uint16_t ProbeWindow = 50;
+
+		pfunction_holder OnChangeCb;
+
+		bool isRunning = false;
+		uint32_t actTime = 0;
+};
+
+#endif
@@ -15,7 +15,9 @@
 
 #include "faulhaber/MsgHandler.h"
 #include "faulhaber/SDOHandler.h"
+#include "faulhaber/MCShmLayout.h"
 #include <stdint.h>
+#include <atomic>
 
 //--- service define ---
 
@@ -24,6 +26,7 @@
 #define MCNodeTxMsg UART_Msg
 
 const uint8_t MaxDeviceNameLen = 32;
+const uint32_t SWPushWatchdogTime = 500;
 
 typedef struct __attribute__((packed)) CwSwMsg {
    uint8_t u8Prefix  : 8;
@@ -35,6 +38,11 @@ typedef struct __attribute__((packed)) CwSwMsg {
    uint8_t u8Suffix;
 } CwSwMsg;
 
+//the EMCY history of a node, of MCEmcyRecord, see MCShmLayout.h
+const uint8_t MCEmcyRingSize = 16;
+
+struct EMCYMsg;
+
 typedef struct __attribute__((packed)) ResetReqMsg {
    uint8_t u8Prefix  : 8;
    uint8_t u8Len     : 8;
@@ -72,20 +80,49 @@ class MCNode {
 		void ResetSDOState();
 		void SetTORetryMax(uint8_t);
 		void SetBusyRetryMax(uint8_t);
+		void SetRespTimeOuts(uint16_t, uint16_t);
 
 		CWCommStates SendCw(uint16_t,uint32_t);
 		CWCommStates PullSW(uint32_t);
+		MCMsg *PrepareCw(uint16_t);
+		void CwSentExternally(uint16_t, uint32_t TxDelay = 0);
+		bool IsCwPending();
+		bool IsBurstCwWaiting();
+		uint8_t GetChannel();
+		void SetSWPushMode(bool, uint32_t watchdogTime = SWPushWatchdogTime);
+		bool IsSWPushMode();
 
 		CWCommStates SendReset();
 						
 		SDOCommStates ReadSDO(unsigned int, unsigned char);
+		SDOCommStates ReadSDOShared(unsigned int, unsigned char, uint32_t *, uint32_t *);
 		SDOCommStates WriteSDO(unsigned int, unsigned char, uint32_t *,unsigned char);
+		SDOCommStates RunBatch(SDOBatchEntry *, uint8_t);
+		void CancelBatch(SDOBatchEntry *);
+		void StartStream(uint16_t, uint8_t, uint8_t);
+		bool StreamValue(uint32_t);
+		void StopStream();
+		uint32_t GetStreamSent();
+		uint32_t GetStreamAcks();
+		uint32_t GetStreamErrors();
 		SDOCommStates GetSDOState();
+		void GetSDOStats(SDOStats *);
 
 		unsigned long GetObjValue();
 
 		bool IsLive();
 		uint16_t GetLastError();
+		uint32_t GetBootCount();
+		uint32_t GetBootAt();
+		uint32_t GetLastRxAt();
+		uint32_t GetRxCount();
+		uint32_t GetSWAge();
+
+		void Register_OnEmcyCb(pfunction_holder *);
+		uint8_t ReadEmcy(uint32_t *, MCEmcyRecord *, uint8_t);
+		uint32_t GetEmcyCount();
+		bool IsFaultPending();
+		void ClearFault();
 
 		uint16_t StatusWord;
 		uint16_t ControlWord;
@@ -96,6 +133,7 @@ class MCNode {
 			
 	private:
 		void OnRxHandler(MCMsg *);
+		void StoreEmcy(EMCYMsg *);
 
 		CwSwMsg CwMsgBuffer;
 		ResetReqMsg ResetReqBuffer;
@@ -111,11 +149,18 @@ class MCNode {
 		uint8_t Channel = InvalidSlot;
 		int16_t NodeId = invalidNodeId;
 
-		uint16_t EMCYCode;
+		uint16_t EMCYCode = 0;
+
+		//history of EMCYs written by the Rx path only
+		MCEmcyRecord EmcyRing[MCEmcyRingSize] = {};
+		std::atomic<uint32_t> EmcyCount{0};
+		bool isFaultPending = false;
+		pfunction_holder OnEmcyCb;
 		uint8_t DeviceName[MaxDeviceNameLen];
 		uint8_t firstCWAccess = 1;
 		
 		bool hasMsgHandlerLocked = false;
+		bool isBurstCw = false;          //the CW has been sent in a burst, see CwSentExternally()
 		
 		SDOHandler RWSDO;
 
@@ -132,9 +177,26 @@ class MCNode {
 		uint8_t BusyRetryMax = 1;
 
 		uint32_t CWSentAt;
-		uint32_t SWRxAt;
+		uint16_t CwTimeOut;
+		uint32_t SWRxAt = 0;
+
+		//time the StatusWord has last been received by any means
+		uint32_t SWUpdatedAt = 0;
+
+		bool isSWPushMode = false;
+		uint32_t SWWatchdogTime = SWPushWatchdogTime;
+
+		//tickets of the shared reads of the SW
+		uint32_t CWSWTicket = 0;
+		uint32_t PullSWTicket = 0;
 
 		bool isLive = false;
+		uint32_t BootCount = 0;
+		uint32_t BootAt = 0;
+
+		//states last reported by the debug output of SendCw()
+		CWCommStates LastCWState = eCWIdle;
+		SDOCommStates LastSDOState = eSDOIdle;
 };
  
 
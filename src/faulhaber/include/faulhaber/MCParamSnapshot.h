@@ -0,0 +1,73 @@
+#ifndef MCPARAMSNAPSHOT_H
+#define MCPARAMSNAPSHOT_H
+
+/*--------------------------------------------------------------
+ * class MCParamSnapshot
+ * saves a list of drive parameters into a versioned binary file
+ * and restores it onto a drive by writing the differences only.
+ * Snapshot files are memory-mapped when loaded.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCDrive.h"
+#include <stdint.h>
+
+//--- file format ---
+
+const uint32_t MCSnapshotMagic = 0x53504846;	// "FHPS"
+const uint16_t MCSnapshotVersion = 1;
+
+typedef struct __attribute__((packed)) MCSnapshotHdr {
+	uint32_t Magic;
+	uint16_t Version;
+	uint8_t Count;
+	uint8_t Reserved;
+	uint32_t Checksum;
+} MCSnapshotHdr;
+
+typedef struct __attribute__((packed)) MCSnapshotEntry {
+	uint16_t Idx;
+	uint8_t SubIdx;
+	uint8_t Len;
+	uint32_t Value;
+} MCSnapshotEntry;
+
+class MCParamSnapshot {
+	public:
+		MCParamSnapshot();
+		~MCParamSnapshot();
+		MCParamSnapshot(const MCParamSnapshot &) = delete;
+		MCParamSnapshot &operator=(const MCParamSnapshot &) = delete;
+
+		DriveCommStates Save(MCDrive *, MCDriveParameter *, uint8_t, const char *);
+		bool Load(const char *);
+		void Unload();
+
+		DriveCommStates Restore(MCDrive *);
+		void ResetRestore();
+
+		bool IsLoaded();
+		uint8_t GetCount();
+		const MCSnapshotEntry *GetEntries();
+		uint8_t GetWriteCount();
+
+	private:
+		bool WriteFile(MCDriveParameter *, uint8_t, const char *);
+		static uint32_t CalcChecksum(const MCSnapshotEntry *, uint8_t);
+
+		const uint8_t *MapBase = NULL;
+		uint32_t MapSize = 0;
+		const MCSnapshotEntry *Entries = NULL;
+		uint8_t Count = 0;
+
+		uint8_t RestoreStep = 0;
+		bool RestoreWritePending = false;
+		uint32_t ActValue = 0;
+		uint8_t WriteCount = 0;
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef MCPOLLSCHEDULER_H
+#define MCPOLLSCHEDULER_H
+
+/*--------------------------------------------------------------
+ * class MCPollScheduler
+ * cyclic reads of registered objects of one or several drives.
+ * Each object is registered once with its rate and optionally a
+ * priority. Due reads are issued by priority, then earliest-
+ * deadline-first per node and the results are
+ * published with their time stamps into a per-node snapshot
+ * which can be read lock-free from any other thread.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCDrive.h"
+#include <stdint.h>
+#include <atomic>
+
+//--- service define ---
+
+const uint8_t MCPollMaxEntries = 16;
+const uint8_t MCPollMaxNodes = MsgHandler_MaxNodes;
+const uint8_t MCPollNone = 0xff;
+
+typedef struct MCPollSample {
+	uint16_t Idx;
+	uint8_t SubIdx;
+	uint32_t Value;
+	uint32_t RxAt;
+	bool isValid;
+} MCPollSample;
+
+typedef struct MCPollNodeSnapshot {
+	uint8_t Count;
+	MCPollSample Samples[MCPollMaxEntries];
+} MCPollNodeSnapshot;
+
+typedef struct MCPollEntry {
+	uint16_t Idx;
+	uint8_t SubIdx;
+	uint8_t NodeSlot;
+	uint8_t SampleSlot;
+	uint16_t Period;
+	uint8_t Priority;       //higher ones first, 0 by default
+	uint32_t Deadline;
+	uint32_t Missed;
+} MCPollEntry;
+
+class MCPollScheduler {
+	public:
+		MCPollScheduler();
+
+		uint8_t RegisterObject(MCDrive *, uint16_t, uint8_t, uint16_t);
+		bool SetPriority(uint8_t, uint8_t);
+		void SetNodeEnabled(MCDrive *, bool);
+		bool IsNodeIdle(MCDrive *);
+
+		void Update(uint32_t);
+
+		bool ReadSnapshot(MCDrive *, MCPollNodeSnapshot *);
+		bool GetSample(uint8_t, MCPollSample *);
+		uint32_t GetMissedCount(uint8_t);
+		uint16_t GetLoadPermille(uint32_t);
+
+		void Register_OnMissCb(ifunction_holder *);
+
+	private:
+		uint8_t FindNode(MCDrive *);
+		uint8_t FindDueEntry(uint8_t);
+		void Publish(uint8_t, uint32_t);
+		void CheckDeadline(uint8_t);
+
+		MCPollEntry Entries[MCPollMaxEntries];
+		uint8_t EntryCount = 0;
+
+		MCDrive *Nodes[MCPollMaxNodes];
+		bool NodeEnabled[MCPollMaxNodes];
+		uint8_t InFlight[MCPollMaxNodes];
+		uint32_t Ticket[MCPollMaxNodes];
+
+		//per node snapshot guarded by a sequence counter
+		MCPollNodeSnapshot Snapshot[MCPollMaxNodes];
+		std::atomic<uint32_t> SnapshotSeq[MCPollMaxNodes];
+
+		ifunction_holder OnMissCb;
+
+		uint8_t FirstNode = 0;
+		bool isRunning = false;
+		uint32_t actTime = 0;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef MCSETPOINTSTREAM_H
+#define MCSETPOINTSTREAM_H
+
+/*--------------------------------------------------------------
+ * class MCSetpointStream
+ * streams setpoints of an external trajectory generator to a drive
+ * in one of the cyclic synchronous modes CSP (8) or CSV (9).
+ * Setpoints are written at a fixed period as pre-encoded SDO write
+ * frames. Each of them is a full request/response exchange: the bus
+ * is held until it is answered, and the next setpoint can't be sent
+ * before. GetMaxRateHz() accounts for this.
+ * A deadline monitor counts setpoints sent late, periods without
+ * a setpoint and setpoints not acknowledged by the drive.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCDrive.h"
+#include <stdint.h>
+
+//--- service define ---
+
+const int8_t MCStreamCSP = 8;
+const int8_t MCStreamCSV = 9;
+
+typedef struct MCStreamStats {
+	uint32_t Sent;
+	uint32_t Acked;
+	uint32_t Errors;        //error responses or no response in time
+	uint32_t Late;          //sent more than half a period after the deadline
+	uint32_t Dropped;       //periods passed without a setpoint
+	uint32_t Unacked;       //sent but not acknowledged so far
+	uint32_t MaxLateness;   //in ms
+} MCStreamStats;
+
+class MCSetpointStream {
+	public:
+		MCSetpointStream();
+
+		void Connect2Drive(MCDrive *);
+		DriveCommStates Configure(int8_t, uint8_t);
+		bool Start();
+		void Stop();
+		bool Update(uint32_t, int32_t);
+
+		void GetStats(MCStreamStats *);
+		void Register_OnLateCb(ifunction_holder *);
+
+		static uint16_t GetMaxRateHz(uint32_t);
+		bool IsRateAchievable(uint32_t);
+
+	private:
+		MCDrive *Drive = NULL;
+
+		int8_t Mode = MCStreamCSP;
+		uint8_t Period = 0;
+		bool isConfigured = false;
+		bool isRunning = false;
+		bool isFirst = true;
+
+		uint32_t NextDue = 0;
+		uint32_t Late = 0;
+		uint32_t Dropped = 0;
+		uint32_t MaxLateness = 0;
+
+		ifunction_holder OnLateCb;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef MCSHMEXPORT_H
+#define MCSHMEXPORT_H
+
+/*--------------------------------------------------------------
+ * class MCShmExport
+ * publishes the state of each node of a bus into a POSIX shared
+ * memory region, so other processes can watch the drives without
+ * touching the serial line. See MCShmReader for their side.
+ *
+ * Each node has a block of its own guarded by a sequence counter
+ * which is odd while the block is written. A single writer, the
+ * worker of the MCBus, never waits for the readers; a reader copies
+ * a block and repeats the copy if the counter has changed meanwhile.
+ *
+ * All times are in ms of the clock of the bus, see MCBus::GetTime().
+ * ClockBaseNs is the CLOCK_MONOTONIC time the bus has been opened at,
+ * so a reader can relate them to its own clock. The region is only
+ * published once it is set.
+ * A region is owned by the writer holding the lock on it; another
+ * one can't take it over before that has closed it or has died.
+ * The layout is in MCShmLayout.h.
+ * Heartbeat is the bus time of the last cycle written; a writer gone
+ * is told by it no longer advancing.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCShmLayout.h"
+#include "faulhaber/MsgHandler.h"
+#include <stdint.h>
+
+//--- service define ---
+
+static_assert(MCShmMaxNodes == MsgHandler_MaxNodes, "a block per node of the MsgHandler");
+
+class MCShmExport {
+	public:
+		~MCShmExport();
+
+		bool Open(const char *, uint8_t);
+		void Close();
+		bool IsOpen();
+
+		bool SetClockBase(uint64_t, uint16_t);
+		void SetHeartbeat(uint32_t);
+		void Write(uint8_t, const MCShmNodeState *);
+
+	private:
+		static bool IsNamed(int, const char *);
+
+		MCShmRegion *Region = NULL;
+		int Fd = -1;            //holds the lock of the owner
+		char Name[64] = {};
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef MCSHMLAYOUT_H
+#define MCSHMLAYOUT_H
+
+/*--------------------------------------------------------------
+ * MCShmLayout
+ * the layout of the shared memory region written by a MCShmExport
+ * and read by a MCShmReader, and the EMCY record of a node exported
+ * with it. Needs nothing but the standard headers, so a process
+ * watching the drives builds without the serial line and libserial.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include <stdint.h>
+#include <atomic>
+
+//--- service define ---
+
+//an EMCY as kept in the history of a node
+typedef struct MCEmcyRecord {
+   uint32_t RxAt;
+   uint16_t ErrorCode;
+   uint8_t ErrorRegister;
+   uint16_t FaulhaberErrorReg;
+} MCEmcyRecord;
+
+const uint32_t MCShmMagic = 0x4D435348;      // == MCSH
+const uint16_t MCShmVersion = 1;
+const uint8_t MCShmMaxNodes = 4;             // == MsgHandler_MaxNodes
+const uint8_t MCShmEmcyHistory = 8;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "the counters are shared between processes");
+
+typedef struct MCShmNodeState {
+	uint8_t NodeId;
+	int8_t OpMode;
+	uint16_t StatusWord;
+	int32_t Position;
+	int32_t Velocity;
+	uint32_t StatusWordAt;
+	uint32_t PositionAt;
+	uint32_t VelocityAt;
+	uint32_t WrittenAt;
+	uint32_t EmcyCount;                     //received since the drive has been added
+	uint8_t EmcyValid;                      //records in Emcy, the oldest first
+	MCEmcyRecord Emcy[MCShmEmcyHistory];
+} MCShmNodeState;
+
+typedef struct MCShmNodeBlock {
+	std::atomic<uint32_t> Seq;
+	MCShmNodeState State;
+} MCShmNodeBlock;
+
+typedef struct MCShmRegion {
+	uint32_t Magic;
+	uint16_t Version;
+	uint8_t NodeCount;
+	uint16_t TimeScale;
+	uint32_t WriterPid;
+	uint64_t ClockBaseNs;
+	std::atomic<uint32_t> Heartbeat;
+	MCShmNodeBlock Node[MCShmMaxNodes];
+} MCShmRegion;
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef MCSHMREADER_H
+#define MCSHMREADER_H
+
+/*--------------------------------------------------------------
+ * class MCShmReader
+ * maps the region of a MCShmExport read only, for processes
+ * watching the drives, e.g. a HMI or a safety monitor. Reading
+ * needs neither a system call nor a lock and never delays the
+ * writer; only this header and MCShmLayout.h are needed, neither
+ * the serial line nor libserial.
+ *
+ * Read() copies the block of a node and retries while it is being
+ * written. After MCShmReadRetries it gives up, e.g. if the writer has
+ * died in the middle of a write.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include "faulhaber/MCShmLayout.h"
+
+//--- service define ---
+
+const uint16_t MCShmReadRetries = 1000;
+
+class MCShmReader {
+	public:
+		~MCShmReader();
+
+		bool Open(const char *);
+		void Close();
+		bool IsOpen();
+
+		uint8_t GetNodeCount();
+		uint32_t GetHeartbeat();
+		uint32_t GetWriterPid();
+		uint64_t GetClockBaseNs();
+		uint16_t GetTimeScale();
+
+		bool Read(uint8_t, MCShmNodeState *);
+
+	private:
+		const MCShmRegion *Region = NULL;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef MCTRIPLEBUFFER_H
+#define MCTRIPLEBUFFER_H
+
+/*--------------------------------------------------------------
+ * class MCTripleBuffer
+ * hands over the latest value of a single writer to a single reader
+ * in another thread. Writer and reader each own one of three buffers;
+ * the third one is exchanged by a single atomic operation. So neither
+ * side ever waits for the other, both calls take constant time and
+ * the reader always gets a complete value.
+ * Values written faster than they are read are overwritten.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *-------------------------------------------------------------*/
+
+//--- inlcudes ----
+
+#include <stdint.h>
+#include <atomic>
+
+//--- service define ---
+
+template <typename T>
+class MCTripleBuffer {
+	public:
+		//--- writer side ---
+
+		//the buffer to be filled before Publish()
+		T *GetWriteBuffer() {
+			return &Buffer[WriteIdx];
+		};
+
+		//swap the filled buffer with the one in the middle
+		void Publish() {
+			uint8_t Old = Middle.exchange(WriteIdx | FreshBit, std::memory_order_acq_rel);
+			WriteIdx = Old & IdxMask;
+		};
+
+		void Write(const T &Value) {
+			Buffer[WriteIdx] = Value;
+			Publish();
+		};
+
+		//--- reader side ---
+
+		//take over the middle buffer if it has been published since;
+		//--> true if there is a new value
+		bool Fetch() {
+			if((Middle.load(std::memory_order_relaxed) & FreshBit) == 0)
+				return false;
+			uint8_t Old = Middle.exchange(ReadIdx, std::memory_order_acq_rel);
+			ReadIdx = Old & IdxMask;
+			return true;
+		};
+
+		const T *GetReadBuffer() {
+			return &Buffer[ReadIdx];
+		};
+
+		//copy of the latest value; --> true if it is a new one
+		bool Read(T *Value) {
+			bool isNew = Fetch();
+			*Value = Buffer[ReadIdx];
+			return isNew;
+		};
+
+	private:
+		static const uint8_t IdxMask = 0x03;
+		static const uint8_t FreshBit = 0x04;
+
+		T Buffer[3] = {};
+		std::atomic<uint8_t> Middle{1};
+		uint8_t WriteIdx = 0;
+		uint8_t ReadIdx = 2;
+};
+
+#endif
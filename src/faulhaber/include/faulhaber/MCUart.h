@@ -16,6 +16,9 @@
 
 const unsigned int UART_MAX_MSG_SIZE = 64;
 const unsigned int UART_MIN_MSG_SIZE = 6;
+const unsigned int UART_MAX_BURST = 4;
+//bytes taken from the serial port at once
+const unsigned int UART_RX_CHUNK_SIZE = 256;
 
 typedef struct __attribute__((packed)) UART_MsgHdr {
    uint8_t u8Prefix  : 8;
@@ -50,6 +53,9 @@ class MCUart
 		void Register_OnRxCb(pfunction_holder *);
 		short CheckStatus();
 		short WriteMsg(UART_Msg *);
+		short WriteMsgBurst(UART_Msg **, uint8_t);
+		uint32_t GetBaudRate();
+		void SetLowLatency(bool);
 		void Stop();
 		void Start(uint32_t baud = 115200);
 		void ResetUart();
@@ -62,11 +68,15 @@ class MCUart
 		uint8_t rxIdx = 0;
 		uint8_t rxSize = 0;
 		uint32_t BaudRate = 115200;
+		bool isLowLatency = false;
 		//an Arduino wouldn't need a TX buffer - it's part of the Serial
 		//on an bare bone embedded it would be needed though for
 		//sending via TXE interrupt
 		UART_Msg RxMsg;
 		UART_Msg TxMsg;
+		char RxChunk[UART_RX_CHUNK_SIZE];
+		//several frames to be written at once
+		uint8_t TxBurst[UART_MAX_MSG_SIZE * UART_MAX_BURST];
 		
 		pfunction_holder OnRxCb;
 	
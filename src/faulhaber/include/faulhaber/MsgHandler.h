@@ -41,6 +41,16 @@ typedef union MCMsg {
    UART_Msg Raw;
 } MCMsg;
 
+//frames and bytes on the wire since the start
+typedef struct MCFrameCounts {
+   uint32_t TxFrames;
+   uint32_t RxFrames;
+   uint32_t TxBytes;
+   uint32_t RxBytes;
+   uint32_t CrcErrors;       //frames dropped for their CRC
+   uint32_t LeaseExpiries;   //locks released by Update() as they were held too long
+} MCFrameCounts;
+
 const uint8_t MsgHandler_MaxNodes = 4;
 const int16_t invalidNodeId = -1;
 const uint8_t InvalidSlot = 0xff;
@@ -50,11 +60,18 @@ class MsgHandler {
 	public:
 		MsgHandler();
 		void Open(const char*, uint32_t);
+		void Close();
 		void Update(uint32_t);
 		uint8_t RegisterNode(uint8_t);
 		void UnRegisterNode(uint8_t);
 		int8_t GetNodeId(uint8_t);
 		bool SendMsg(uint8_t, MCMsg *);
+		bool SendMsgBurst(const uint8_t *, MCMsg **, uint8_t);
+		uint32_t GetBaudRate();
+		void SetLowLatency(bool);
+		void GetFrameCounts(MCFrameCounts *);
+		uint32_t GetLastRxAt(uint8_t);
+		uint32_t GetRxCount(uint8_t);
 		void Register_OnRxSDOCb(uint8_t,pfunction_holder *);
 		void Register_OnRxSysCb(uint8_t,pfunction_holder *);
 		void ResetMsgHandler();
@@ -83,6 +100,12 @@ class MsgHandler {
 		
 		uint32_t actTime;
 		uint32_t lockTime;
+
+		MCFrameCounts Counts = {};
+
+		//time and number of valid frames received per node
+		uint32_t LastRxAt[MsgHandler_MaxNodes] = {};
+		uint32_t RxCount[MsgHandler_MaxNodes] = {};
 };
 
 
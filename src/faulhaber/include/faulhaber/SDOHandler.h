@@ -64,6 +64,42 @@ typedef struct __attribute__((packed)) SDOTxResp_Data {
 
 typedef SDOTxResp_Data SDOErrResp_Data;
 
+//results of the last reads which can be shared by several waiters
+
+const uint8_t SDOSharedRxSlots = 4;
+
+typedef struct SDOSharedRx {
+   uint16_t Idx;
+   uint8_t SubIdx;
+   uint32_t Value;
+   uint32_t Seq;
+} SDOSharedRx;
+
+//a batch of requests to be sent back to back
+
+typedef struct SDOBatchEntry {
+   MCMsgCommands Cmd;   //eSdoReadReq or eSdoWriteReq
+   uint16_t Idx;
+   uint8_t SubIdx;
+   uint8_t Len;
+   uint32_t Value;      //value to be written or value read
+} SDOBatchEntry;
+
+//counters of the requests of a channel since the start
+
+const uint8_t SDORttBins = 16;
+
+typedef struct SDOStats {
+   uint32_t Requests;      //requests sent including resends
+   uint32_t Responses;     //matching responses
+   uint32_t Retries;       //resends after a timeout
+   uint32_t BusyRetries;   //sends refused as the MsgHandler was in use
+   uint32_t TimeOuts;      //requests given up after the last retry
+   uint32_t Errors;        //error responses or responses not expected
+   uint32_t RttMax;
+   uint32_t RttBins[SDORttBins];  //RTT in ms, the last bin takes all above
+} SDOStats;
+
 //define the enum with the Comm states
 
 typedef enum SDOCommStates {
@@ -86,13 +122,26 @@ class SDOHandler {
 		void SetActTime(uint32_t);
 		
 		SDOCommStates ReadSDO(uint16_t, uint8_t);
+		SDOCommStates ReadSDOShared(uint16_t, uint8_t, uint32_t *, uint32_t *);
 		SDOCommStates WriteSDO(uint16_t, uint8_t,uint32_t *,uint8_t);
+		SDOCommStates RunBatch(SDOBatchEntry *, uint8_t);
+		void CancelBatch(SDOBatchEntry *);
+		uint8_t GetBatchIdx();
+		void StartStream(uint16_t, uint8_t, uint8_t);
+		bool StreamValue(uint32_t);
+		void StopStream();
+		uint32_t GetStreamSent();
+		uint32_t GetStreamAcks();
+		uint32_t GetStreamErrors();
 		uint32_t GetObjValue();
+		void GetStats(SDOStats *);
+		static uint32_t GetRttPercentile(const SDOStats *, uint8_t);
 	
 		SDOCommStates GetComState();
 		void ResetComState(); 
 		void SetTORetryMax(uint8_t);
 		void SetBusyRetryMax(uint8_t);
+		void SetRespTimeOut(uint16_t);
 		
 		//handler to be registered at the Msghandler instance
 		static void OnSDOMsgRxCb(void *op,void *p) {
@@ -102,11 +151,51 @@ class SDOHandler {
 	private:
 		void OnRxHandler(MCMsg *);
     void OnTimeOut();
+		SDOCommStates SendReadRq(uint16_t, uint8_t, bool);
+		SDOCommStates SendWriteRq(uint16_t, uint8_t, uint32_t *, uint8_t);
+		void FailRequest(SDOCommStates);
+		void StoreSharedRx(uint16_t, uint8_t, uint32_t);
+		void SendBatchEntry();
+		void ContinueBatch();
+		bool IsReserved();
+		void ReleaseStream();
+		void StoreRtt();
 	  char Channel = InvalidSlot;
 
 		SDOMaxMsg TxRqMsg;
 		SDOMaxMsg RxRqMsg;
 		SDOCommStates SDORxTxState = eSDOIdle;
+		MCMsgCommands PendingCmd = eInvalidCmdCode;
+
+		//every read request sent gets a new sequence number
+		//a shared read is finished by any response with a number >= its ticket
+		bool isSharedRq = false;
+		uint32_t RqSeq = 0;
+		SDOSharedRx SharedRx[SDOSharedRxSlots] = {};
+		uint8_t SharedRxNext = 0;
+
+		//the last shared request which has failed, see FailRequest()
+		uint32_t FailedSeq = 0;
+		SDOCommStates FailedState = eSDOIdle;
+
+		//the batch being worked on, owning the channel once active
+		SDOBatchEntry *Batch = NULL;
+		uint8_t BatchCount = 0;
+		uint8_t BatchIdx = 0;
+		bool isBatchActive = false;     //the request before has ended
+		bool isBatchRq = false;         //the entry BatchIdx is on the wire
+
+		//the pre-encoded write request of a stream
+		SDOMaxMsg StreamMsg;
+		uint8_t StreamLen = 4;
+		bool isStreaming = false;
+		bool isStreamPending = false;   //holds the lease until the response
+		uint32_t StreamSentAt = 0;
+		uint32_t StreamSent = 0;
+		uint32_t StreamAcks = 0;
+		uint32_t StreamErrors = 0;     //error responses or no response at all
+
+		SDOStats Stats = {};
 
 		//unsigned long RxData;
 	  union {
@@ -120,6 +209,7 @@ class SDOHandler {
 		MsgHandler *Handler;
 		
 		uint32_t RequestSentAt;
+		uint16_t RespTimeOut;
 		uint32_t actTime;
 	  bool isTimerActive = false;
 
@@ -0,0 +1,199 @@
+/*---------------------------------------------------
+ * Faulhaber.cpp
+ * implements the ros2_control ActuatorInterface of
+ * a single drive on top of MCBus
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include "faulhaber/Faulhaber.h"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+//--- local defines ---
+
+//time the drive gets to be enabled or disabled
+const uint32_t FaulhaberPhaseTimeOut = 2000;
+//time the drive get to be reset and configured
+const uint32_t FaulhaberConfigureTimeOut = 5000;
+//time the drive gets to switch its OpMode
+const uint32_t FaulhaberSwitchTimeOut = 200;
+
+namespace faulhaber
+{
+
+static rclcpp::Logger Log = rclcpp::get_logger("Faulhaber");
+
+/*---------------------------------------------------------------------
+ * on_init()
+ * Check the single joint and read the parameters. The drive is added
+ * to the bus here, the bus itself is opened by on_configure().
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW diagnostics
+ * 2026-10-18 AW reset and homing
+ * 2026-10-18 AW simulation
+ * 2026-10-18 AW bus tuning
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::CallbackReturn Faulhaber::on_init(const hardware_interface::HardwareInfo &info)
+{
+	if(hardware_interface::ActuatorInterface::on_init(info) != hardware_interface::CallbackReturn::SUCCESS)
+		return hardware_interface::CallbackReturn::ERROR;
+
+	if(info_.joints.size() != 1)
+	{
+		RCLCPP_FATAL(Log, "exactly one joint expected, got %zu", info_.joints.size());
+		return hardware_interface::CallbackReturn::ERROR;
+	}
+	return Line.Init(info_) ? hardware_interface::CallbackReturn::SUCCESS : hardware_interface::CallbackReturn::ERROR;
+}
+
+/*---------------------------------------------------------------------
+ * on_configure()
+ * on_cleanup()
+ * Open or close the serial line. on_configure() waits for the drive
+ * being reset and configured by the worker of the bus. It polls the
+ * drive from then on, but doesn't enable it.
+ * The diagnostics are published while the line is open.
+ * A launched simulation is started before the line is opened and
+ * stopped after it has been closed, as is the shared memory export.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW diagnostics
+ * 2026-10-18 AW wait for the configuration
+ * 2026-10-18 AW simulation
+ * 2026-10-18 AW shared memory export
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::CallbackReturn Faulhaber::on_configure(const rclcpp_lifecycle::State &)
+{
+	return Line.Open(FaulhaberConfigureTimeOut) ? hardware_interface::CallbackReturn::SUCCESS :
+		hardware_interface::CallbackReturn::ERROR;
+}
+
+hardware_interface::CallbackReturn Faulhaber::on_cleanup(const rclcpp_lifecycle::State &)
+{
+	Line.Close();
+	return hardware_interface::CallbackReturn::SUCCESS;
+}
+
+/*---------------------------------------------------------------------
+ * on_activate()
+ * on_deactivate()
+ * Enable or disable the drive and wait for it, including the homing
+ * if configured. The commands start from the actual position and zero
+ * speed, so the drive doesn't move before a controller has written its
+ * first command.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW homing
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::CallbackReturn Faulhaber::on_activate(const rclcpp_lifecycle::State &)
+{
+	return Line.Activate(FaulhaberPhaseTimeOut) ? hardware_interface::CallbackReturn::SUCCESS :
+		hardware_interface::CallbackReturn::ERROR;
+}
+
+hardware_interface::CallbackReturn Faulhaber::on_deactivate(const rclcpp_lifecycle::State &)
+{
+	return Line.Deactivate(FaulhaberPhaseTimeOut) ? hardware_interface::CallbackReturn::SUCCESS :
+		hardware_interface::CallbackReturn::ERROR;
+}
+
+std::vector<hardware_interface::StateInterface> Faulhaber::export_state_interfaces()
+{
+	std::vector<hardware_interface::StateInterface> Interfaces;
+
+	Line.ExportStates(Interfaces);
+	return Interfaces;
+}
+
+std::vector<hardware_interface::CommandInterface> Faulhaber::export_command_interfaces()
+{
+	std::vector<hardware_interface::CommandInterface> Interfaces;
+
+	Line.ExportCommands(Interfaces);
+	return Interfaces;
+}
+
+/*---------------------------------------------------------------------
+ * prepare_command_mode_switch()
+ * perform_command_mode_switch()
+ * Only one of position and velocity can be commanded at a time.
+ * Stopping the active interface stops sending commands; the drive
+ * keeps its last target or speed.
+ * Starting one switches the OpMode of the drive to PP or PV by a
+ * single write and read back, skipped if it is in that mode already.
+ * A switch not done within its timeout is cancelled and reported as
+ * an error.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW OpMode switched explicitly
+ * 2026-10-18 AW a switch timed out is cancelled
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::return_type Faulhaber::prepare_command_mode_switch(
+	const std::vector<std::string> &start_interfaces,
+	const std::vector<std::string> &)
+{
+	return Line.CheckModes(start_interfaces) ? hardware_interface::return_type::OK :
+		hardware_interface::return_type::ERROR;
+}
+
+hardware_interface::return_type Faulhaber::perform_command_mode_switch(
+	const std::vector<std::string> &start_interfaces,
+	const std::vector<std::string> &stop_interfaces)
+{
+	return Line.SwitchModes(start_interfaces, stop_interfaces, FaulhaberSwitchTimeOut) ?
+		hardware_interface::return_type::OK : hardware_interface::return_type::ERROR;
+}
+
+/*---------------------------------------------------------------------
+ * read()
+ * Take over the latest state and diagnostics published by the worker.
+ * The stamps are the time of the values in the time of read(); the
+ * ages on the clock of the bus are scaled back to real time.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW states always taken over
+ * 2026-10-18 AW diagnostics
+ * 2026-10-18 AW stamps
+ * 2026-10-18 AW time scale
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::return_type Faulhaber::read(const rclcpp::Time &time, const rclcpp::Duration &)
+{
+	return Line.Read(time) ? hardware_interface::return_type::OK : hardware_interface::return_type::ERROR;
+}
+
+/*---------------------------------------------------------------------
+ * write()
+ * Hand over the command of the active interface. A command the worker
+ * hasn't taken over yet is replaced by this one.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW commands no longer skipped
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::return_type Faulhaber::write(const rclcpp::Time &, const rclcpp::Duration &)
+{
+	Line.Write();
+	return hardware_interface::return_type::OK;
+}
+
+}  // namespace faulhaber
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(faulhaber::Faulhaber, hardware_interface::ActuatorInterface)
@@ -0,0 +1,226 @@
+/*---------------------------------------------------
+ * FaulhaberDiagnostics.cpp
+ * implements the export of the diagnostics of a MCBus
+ * as state interfaces and to /diagnostics
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cctype>
+
+#include "faulhaber/FaulhaberDiagnostics.h"
+#include "diagnostic_msgs/msg/diagnostic_status.hpp"
+
+//--- local defines ---
+
+//a SW older than this is reported as a warning, in ms
+const uint32_t FaulhaberDiagSWAgeWarn = 1000;
+//a load of the line above this is reported as a warning, in permille
+const uint16_t FaulhaberDiagLoadWarn = 800;
+
+namespace faulhaber
+{
+
+static rclcpp::Logger Log = rclcpp::get_logger("FaulhaberDiagnostics");
+
+FaulhaberDiagnostics::~FaulhaberDiagnostics()
+{
+	Stop();
+}
+
+/*---------------------------------------------------------------------
+ * void Init(const std::string &Name, const std::vector<std::string> &JointNames)
+ * Name of the hardware and of the joints in the order of the axes of
+ * the bus. To be called from on_init().
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void FaulhaberDiagnostics::Init(const std::string &Name, const std::vector<std::string> &JointNames)
+{
+	HwName = Name;
+	Joints = JointNames;
+	if(Joints.size() > MCBusMaxAxes)
+		Joints.resize(MCBusMaxAxes);
+}
+
+/*---------------------------------------------------------------------
+ * void ExportStates(std::vector<hardware_interface::StateInterface> &Interfaces)
+ * Add the state interfaces of the diagnostics.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void FaulhaberDiagnostics::ExportStates(std::vector<hardware_interface::StateInterface> &Interfaces)
+{
+	for(uint8_t i = 0; i < Joints.size(); i++)
+	{
+		Interfaces.emplace_back(Joints[i], "sdo_rtt_p50", &AxisValues[i][0]);
+		Interfaces.emplace_back(Joints[i], "sdo_rtt_p99", &AxisValues[i][1]);
+		Interfaces.emplace_back(Joints[i], "sdo_timeouts", &AxisValues[i][2]);
+		Interfaces.emplace_back(Joints[i], "sdo_retries", &AxisValues[i][3]);
+		Interfaces.emplace_back(Joints[i], "statusword_age", &AxisValues[i][4]);
+	}
+	Interfaces.emplace_back(HwName, "bus_load", &BusValues[0]);
+	Interfaces.emplace_back(HwName, "crc_errors", &BusValues[1]);
+	Interfaces.emplace_back(HwName, "lease_expiries", &BusValues[2]);
+}
+
+/*---------------------------------------------------------------------
+ * bool Start()
+ * void Stop()
+ * Create the node and the updater and spin them in a thread of their
+ * own, or stop and remove them again. To be called from on_configure()
+ * and on_cleanup().
+ * --> false if the node can't be created; the state interfaces are
+ * updated anyway
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool FaulhaberDiagnostics::Start()
+{
+	std::string NodeName = HwName + "_diagnostics";
+
+	if(Node)
+		return true;
+
+	//the name of the hardware may contain what a node name must not
+	for(char &c : NodeName)
+	{
+		if(!std::isalnum((unsigned char)c))
+			c = '_';
+	}
+
+	try
+	{
+		Node = std::make_shared<rclcpp::Node>(NodeName);
+		Updater = std::make_shared<diagnostic_updater::Updater>(Node);
+		Updater->setHardwareID(HwName);
+		Updater->add("bus", this, &FaulhaberDiagnostics::ProduceBus);
+		for(uint8_t i = 0; i < Joints.size(); i++)
+		{
+			Updater->add(Joints[i],
+				[this, i](diagnostic_updater::DiagnosticStatusWrapper &Stat) { ProduceAxis(Stat, i); });
+		}
+
+		Executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+		Executor->add_node(Node);
+		Spinner = std::thread([this]() { Executor->spin(); });
+	}
+	catch(const std::exception &e)
+	{
+		RCLCPP_WARN(Log, "no diagnostics: %s", e.what());
+		Stop();
+		return false;
+	}
+	return true;
+}
+
+void FaulhaberDiagnostics::Stop()
+{
+	if(Executor)
+		Executor->cancel();
+	if(Spinner.joinable())
+		Spinner.join();
+
+	Executor.reset();
+	Updater.reset();
+	Node.reset();
+}
+
+/*---------------------------------------------------------------------
+ * void Update(MCBus &Bus)
+ * To be called from read(). Takes over the diagnostics if the bus has
+ * collected new ones and hands them over to the updater. Neither
+ * allocates nor waits.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void FaulhaberDiagnostics::Update(MCBus &Bus)
+{
+	if(!Bus.GetDiagnostics(&Act))
+		return;
+
+	for(uint8_t i = 0; i < Joints.size(); i++)
+	{
+		AxisValues[i][0] = (double)Act.Axis[i].RttP50;
+		AxisValues[i][1] = (double)Act.Axis[i].RttP99;
+		AxisValues[i][2] = (double)Act.Axis[i].TimeOuts;
+		AxisValues[i][3] = (double)Act.Axis[i].Retries;
+		AxisValues[i][4] = (double)Act.Axis[i].SWAge;
+	}
+	BusValues[0] = (double)Act.LoadPermille / 1000.0;
+	BusValues[1] = (double)Act.CrcErrors;
+	BusValues[2] = (double)Act.LeaseExpiries;
+
+	Shared.Write(Act);
+}
+
+//--- private functions ---
+
+/*---------------------------------------------------------------------
+ * void ProduceBus(DiagnosticStatusWrapper &Stat)
+ * void ProduceAxis(DiagnosticStatusWrapper &Stat, uint8_t i)
+ * Called by the updater in its own thread. A warning is raised for
+ * new CRC errors or timeouts since the last report, a line close to
+ * its limit or a SW not received for long.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void FaulhaberDiagnostics::ProduceBus(diagnostic_updater::DiagnosticStatusWrapper &Stat)
+{
+	Shared.Fetch();
+	const MCBusDiagnostics *Diag = Shared.GetReadBuffer();
+
+	if(Diag->At == 0)
+		Stat.summary(diagnostic_msgs::msg::DiagnosticStatus::STALE, "no data");
+	else if(Diag->CrcErrors != ReportedCrcErrors)
+		Stat.summary(diagnostic_msgs::msg::DiagnosticStatus::WARN, "CRC errors");
+	else if(Diag->LoadPermille > FaulhaberDiagLoadWarn)
+		Stat.summary(diagnostic_msgs::msg::DiagnosticStatus::WARN, "line close to its limit");
+	else
+		Stat.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "OK");
+	ReportedCrcErrors = Diag->CrcErrors;
+
+	Stat.add("load [permille]", Diag->LoadPermille);
+	Stat.add("poll load [permille]", Diag->PollLoadPermille);
+	Stat.add("tx frames", Diag->TxFrames);
+	Stat.add("rx frames", Diag->RxFrames);
+	Stat.add("crc errors", Diag->CrcErrors);
+	Stat.add("lease expiries", Diag->LeaseExpiries);
+}
+
+void FaulhaberDiagnostics::ProduceAxis(diagnostic_updater::DiagnosticStatusWrapper &Stat, uint8_t i)
+{
+	Shared.Fetch();
+	const MCBusAxisDiag *Axis = &Shared.GetReadBuffer()->Axis[i];
+
+	if(Shared.GetReadBuffer()->At == 0)
+		Stat.summary(diagnostic_msgs::msg::DiagnosticStatus::STALE, "no data");
+	else if(Axis->TimeOuts != ReportedTimeOuts[i])
+		Stat.summary(diagnostic_msgs::msg::DiagnosticStatus::WARN, "SDO timeouts");
+	else if(Axis->SWAge > FaulhaberDiagSWAgeWarn)
+		Stat.summary(diagnostic_msgs::msg::DiagnosticStatus::WARN, "StatusWord outdated");
+	else
+		Stat.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "OK");
+	ReportedTimeOuts[i] = Axis->TimeOuts;
+
+	Stat.add("sdo rtt p50 [ms]", Axis->RttP50);
+	Stat.add("sdo rtt p99 [ms]", Axis->RttP99);
+	Stat.add("sdo rtt max [ms]", Axis->RttMax);
+	Stat.add("sdo requests", Axis->Requests);
+	Stat.add("sdo retries", Axis->Retries);
+	Stat.add("sdo busy retries", Axis->BusyRetries);
+	Stat.add("sdo timeouts", Axis->TimeOuts);
+	Stat.add("sdo errors", Axis->Errors);
+	Stat.add("statusword age [ms]", Axis->SWAge);
+	Stat.add("opmode switch [ms]", Axis->SwitchLatency);
+}
+
+}  // namespace faulhaber
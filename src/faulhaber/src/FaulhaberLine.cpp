@@ -0,0 +1,566 @@
+/*---------------------------------------------------
+ * FaulhaberLine.cpp
+ * implements the serial line and the joint interfaces
+ * shared by the ros2_control plugins on top of MCBus
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include "faulhaber/FaulhaberLine.h"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+
+namespace faulhaber
+{
+
+//--- public functions ---
+
+FaulhaberLine::FaulhaberLine(const rclcpp::Logger &Logger) : Log(Logger)
+{
+}
+
+/*---------------------------------------------------------------------
+ * bool Init(const hardware_interface::HardwareInfo &Info)
+ * Read the parameters and add a drive to the bus for each joint.
+ * To be called from on_init() once the number of joints has been
+ * checked. The bus itself is opened by Open().
+ * --> false if a parameter or a joint is invalid
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool FaulhaberLine::Init(const hardware_interface::HardwareInfo &Info)
+{
+	try
+	{
+		ReadHwParams(Info.hardware_parameters);
+		for(const hardware_interface::ComponentInfo &Joint : Info.joints)
+		{
+			AddJoint(Joint);
+			ApplyJointParams(Info.hardware_parameters, Joint, Bus, Count, Polls);
+			Count++;
+		}
+		ApplyBusParams(Info.hardware_parameters, Bus);
+	}
+	catch(const std::exception &e)
+	{
+		RCLCPP_FATAL(Log, "invalid parameter: %s", e.what());
+		return false;
+	}
+	Diag.Init(Info.name, Names);
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * bool Open(uint32_t TimeOut)
+ * void Close()
+ * Open or close the serial line. Open() waits up to TimeOut ms for all
+ * drives being reset and configured concurrently by the worker of the
+ * bus. It polls them from then on, but doesn't enable them.
+ * The diagnostics are published while the line is open.
+ * A launched simulation is started before the line is opened and
+ * stopped after it has been closed, as is the shared memory export.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool FaulhaberLine::Open(uint32_t TimeOut)
+{
+	if(isSimLaunched && !StartSim())
+		return false;
+
+	const char *OpenPort = Sim ? Sim->GetPortName() : Port.c_str();
+
+	Bus.SetPollRate(PollRate);
+	Bus.SetResetOnOpen(isResetOnConfigure);
+	Bus.SetHomingOnActivate(HomingTimeOut);
+	Bus.SetTimeScale(TimeScale);
+	if(!ShmName.empty())
+	{
+		if(!Shm.Open(ShmName.c_str(), Count))
+		{
+			RCLCPP_ERROR(Log, "can't export to shared memory %s", ShmName.c_str());
+			Sim.reset();
+			return false;
+		}
+		Bus.SetShmExport(&Shm);
+	}
+	for(uint8_t i = 0; i < Count; i++)
+		Joints[i].Extrapolator.Reset();
+	if(!Bus.Open(OpenPort, BaudRate))
+	{
+		RCLCPP_ERROR(Log, "can't open %s", OpenPort);
+		Shm.Close();
+		Sim.reset();
+		return false;
+	}
+	if(!WaitForPhase(eBusIdle, TimeOut))
+	{
+		RCLCPP_ERROR(Log, "drives not configured");
+		Bus.Close();
+		Shm.Close();
+		Sim.reset();
+		return false;
+	}
+
+	MCBusTiming Timing = Bus.GetTiming();
+	RCLCPP_INFO(Log, "reset %u ms, configure %u ms", Timing.ResetMs, Timing.ConfigureMs);
+	RCLCPP_INFO(Log, "%s opened at %u Bd with %u drives", OpenPort, BaudRate, Count);
+	Diag.Start();
+
+	return true;
+}
+
+void FaulhaberLine::Close()
+{
+	Diag.Stop();
+	Bus.Close();
+	Shm.Close();
+	Sim.reset();
+}
+
+/*---------------------------------------------------------------------
+ * bool Activate(uint32_t TimeOut)
+ * bool Deactivate(uint32_t TimeOut)
+ * Enable or disable all drives and wait for them, including the
+ * homing if configured. The commands start from the actual positions
+ * and zero speeds, so no drive moves before a controller has written
+ * its first command.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool FaulhaberLine::Activate(uint32_t TimeOut)
+{
+	Bus.Activate();
+	if(!WaitForPhase(eBusRunning, TimeOut + HomingTimeOut))
+	{
+		RCLCPP_ERROR(Log, "drives not enabled");
+		Bus.Deactivate();
+		return false;
+	}
+
+	MCBusTiming Timing = Bus.GetTiming();
+	RCLCPP_INFO(Log, "enable %u ms, homing %u ms", Timing.EnableMs, Timing.HomingMs);
+
+	UpdateStates();
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		Joints[i].PositionCmd = Joints[i].PositionState;
+		Joints[i].VelocityCmd = 0.0;
+	}
+	return true;
+}
+
+bool FaulhaberLine::Deactivate(uint32_t TimeOut)
+{
+	for(uint8_t i = 0; i < Count; i++)
+		Joints[i].CmdMode = eBusCmdNone;
+
+	Bus.Deactivate();
+	if(!WaitForPhase(eBusIdle, TimeOut))
+	{
+		RCLCPP_ERROR(Log, "drives not disabled");
+		return false;
+	}
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void ExportStates(std::vector<hardware_interface::StateInterface> &Interfaces)
+ * void ExportCommands(std::vector<hardware_interface::CommandInterface> &Interfaces)
+ * the interfaces of all joints, the states including the objects
+ * polled and the diagnostics
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void FaulhaberLine::ExportStates(std::vector<hardware_interface::StateInterface> &Interfaces)
+{
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		Interfaces.emplace_back(Names[i], hardware_interface::HW_IF_POSITION, &Joints[i].PositionState);
+		Interfaces.emplace_back(Names[i], hardware_interface::HW_IF_VELOCITY, &Joints[i].VelocityState);
+		Interfaces.emplace_back(Names[i], "position_stamp", &Joints[i].PositionStamp);
+		Interfaces.emplace_back(Names[i], "velocity_stamp", &Joints[i].VelocityStamp);
+		Interfaces.emplace_back(Names[i], "stale", &Joints[i].StaleState);
+	}
+	for(const FaulhaberPollObject &Poll : Polls)
+		Interfaces.emplace_back(Poll.Joint, Poll.Name, &PollState[Poll.Slot]);
+	Diag.ExportStates(Interfaces);
+}
+
+void FaulhaberLine::ExportCommands(std::vector<hardware_interface::CommandInterface> &Interfaces)
+{
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		Interfaces.emplace_back(Names[i], hardware_interface::HW_IF_POSITION, &Joints[i].PositionCmd);
+		Interfaces.emplace_back(Names[i], hardware_interface::HW_IF_VELOCITY, &Joints[i].VelocityCmd);
+	}
+}
+
+/*---------------------------------------------------------------------
+ * bool CheckModes(const std::vector<std::string> &Start)
+ * bool SwitchModes(const std::vector<std::string> &Start,
+ *		const std::vector<std::string> &Stop, uint32_t TimeOut)
+ * Each joint can be commanded by either position or velocity, so at
+ * most one interface per joint may be started.
+ * Stopping the active interface of a joint stops sending commands to
+ * it; the drive keeps its last target or speed.
+ * The drives of the joints started are switched to PP or PV together,
+ * each by a single write and read back of the OpMode, skipped if it
+ * is in that mode already. A switch not done within TimeOut ms is
+ * cancelled.
+ * --> false if too many interfaces are started or the switch failed
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool FaulhaberLine::CheckModes(const std::vector<std::string> &Start)
+{
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		uint8_t Started = 0;
+
+		for(const std::string &Interface : Start)
+		{
+			if(Interface.rfind(Names[i] + "/", 0) == 0)
+				Started++;
+		}
+		if(Started > 1)
+			return false;
+	}
+	return true;
+}
+
+bool FaulhaberLine::SwitchModes(const std::vector<std::string> &Start, const std::vector<std::string> &Stop,
+	uint32_t TimeOut)
+{
+	MCBusCmdModes NewMode[MCBusMaxAxes];
+	bool isAnyNew = false;
+
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		if(FindMode(i, Stop) == Joints[i].CmdMode)
+			Joints[i].CmdMode = eBusCmdNone;
+
+		NewMode[i] = FindMode(i, Start);
+		if(NewMode[i] != eBusCmdNone)
+			isAnyNew = true;
+	}
+	if(!isAnyNew)
+		return true;
+
+	//the OpModes of all joints started are switched together
+	if(!Bus.SwitchModes(NewMode, Count) || !WaitForSwitch(TimeOut))
+	{
+		RCLCPP_ERROR(Log, "OpModes not switched");
+		return false;
+	}
+
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		if(NewMode[i] == eBusCmdNone)
+			continue;
+
+		RCLCPP_INFO(Log, "%s switched to %s in %u ms", Names[i].c_str(),
+			(NewMode[i] == eBusCmdPosition) ? "PP" : "PV", Bus.GetSwitchLatency(i));
+
+		Joints[i].CmdMode = NewMode[i];
+		Joints[i].PositionCmd = Joints[i].PositionState;
+		Joints[i].VelocityCmd = 0.0;
+	}
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * bool Read(const rclcpp::Time &Time)
+ * Take over the latest states of all joints at once and the diagnostics.
+ * The stamps are the time of the values in the time of read(); the
+ * ages on the clock of the bus are scaled back to real time.
+ * --> false if the bus has failed
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool FaulhaberLine::Read(const rclcpp::Time &Time)
+{
+	UpdateStates();
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		Joints[i].PositionStamp = Time.seconds() - (double)Joints[i].PositionAge / (1000.0 * TimeScale);
+		Joints[i].VelocityStamp = Time.seconds() - (double)Joints[i].VelocityAge / (1000.0 * TimeScale);
+	}
+	Diag.Update(Bus);
+	return (Bus.GetPhase() != eBusError);
+}
+
+/*---------------------------------------------------------------------
+ * void Write()
+ * Hand over the commands of all joints as a single set. The worker
+ * starts all of them within the same cycle. A set the worker hasn't
+ * taken over yet is replaced by this one.
+ * A joint with an invalid command keeps its previous one.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void FaulhaberLine::Write()
+{
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		Cmd[i].Mode = Joints[i].CmdMode;
+		if(std::isnan(Joints[i].PositionCmd) || std::isnan(Joints[i].VelocityCmd))
+			continue;
+
+		Cmd[i].Position = (int32_t)std::lround(Joints[i].PositionCmd * Joints[i].PositionFactor);
+		Cmd[i].Velocity = (int32_t)std::lround(Joints[i].VelocityCmd * Joints[i].VelocityFactor);
+	}
+	Bus.SetCommands(Cmd, Count);
+}
+
+//--- private functions ---
+
+/*---------------------------------------------------------------------
+ * void ReadHwParams(const FaulhaberParamMap &Hw)
+ * the parameters of the <hardware> tag besides the tuning of the bus
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW numbers checked for their range
+ *--------------------------------------------------------------------*/
+
+void FaulhaberLine::ReadHwParams(const FaulhaberParamMap &Hw)
+{
+	auto Param = Hw.find("port");
+	if(Param != Hw.end())
+		Port = Param->second;
+	Param = Hw.find("baud_rate");
+	if(Param != Hw.end())
+		BaudRate = ToNumber(Param->second, 1, 1000000);
+	Param = Hw.find("poll_rate");
+	if(Param != Hw.end())
+		PollRate = (uint16_t)ToNumber(Param->second, 1, 1000);
+	Param = Hw.find("reset_on_configure");
+	if(Param != Hw.end())
+		isResetOnConfigure = (Param->second == "true") || (Param->second == "1");
+	Param = Hw.find("homing_timeout");
+	if(Param != Hw.end())
+		HomingTimeOut = (uint16_t)ToNumber(Param->second, 0, 0xffff);
+	Param = Hw.find("extrapolation_horizon");
+	if(Param != Hw.end())
+		Horizon = (uint16_t)ToNumber(Param->second, 0, 0xffff);
+	Param = Hw.find("stale_timeout");
+	if(Param != Hw.end())
+		StaleTimeOut = (uint16_t)ToNumber(Param->second, 0, 0xffff);
+	Param = Hw.find("simulation");
+	if(Param != Hw.end())
+	{
+		if((Param->second != "off") && (Param->second != "launch") && (Param->second != "attach"))
+			throw std::invalid_argument("simulation must be off, launch or attach, not " + Param->second);
+
+		isSimLaunched = (Param->second == "launch");
+		if(Param->second != "off")
+		{
+			Param = Hw.find("sim_time_scale");
+			if(Param != Hw.end())
+				TimeScale = (uint16_t)ToNumber(Param->second, 1, 1000);
+		}
+	}
+	Param = Hw.find("sim_latency_us");
+	if(Param != Hw.end())
+		SimLatency = (uint16_t)ToNumber(Param->second, 0, 0xffff);
+	Param = Hw.find("shm_name");
+	if(Param != Hw.end())
+		ShmName = Param->second;
+}
+
+/*---------------------------------------------------------------------
+ * void AddJoint(const hardware_interface::ComponentInfo &Joint)
+ * Check the command interfaces and read the parameters of the joint,
+ * then add its drive to the bus as axis Count.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW node_id and homing_method checked for their range
+ *--------------------------------------------------------------------*/
+
+void FaulhaberLine::AddJoint(const hardware_interface::ComponentInfo &Joint)
+{
+	FaulhaberJoint &This = Joints[Count];
+
+	for(const hardware_interface::InterfaceInfo &Interface : Joint.command_interfaces)
+	{
+		if((Interface.name != hardware_interface::HW_IF_POSITION) &&
+			(Interface.name != hardware_interface::HW_IF_VELOCITY))
+			throw std::invalid_argument("command interface " + Interface.name + " of " + Joint.name + " is not supported");
+	}
+
+	auto Param = Joint.parameters.find("position_factor");
+	if(Param != Joint.parameters.end())
+		This.PositionFactor = std::stod(Param->second);
+	Param = Joint.parameters.find("velocity_factor");
+	if(Param != Joint.parameters.end())
+		This.VelocityFactor = std::stod(Param->second);
+
+	if((This.PositionFactor == 0.0) || (This.VelocityFactor == 0.0))
+		throw std::invalid_argument("position_factor and velocity_factor of " + Joint.name + " must not be 0");
+
+	Param = Joint.parameters.find("node_id");
+	if(Param == Joint.parameters.end())
+		throw std::invalid_argument("joint " + Joint.name + " has no node_id");
+
+	This.NodeId = (uint8_t)ToNumber(Param->second, 1, 127);
+	if(Bus.AddAxis(This.NodeId) != Count)
+		throw std::invalid_argument("no axis for " + Joint.name);
+
+	Param = Joint.parameters.find("homing_method");
+	if(Param != Joint.parameters.end())
+	{
+		//the methods of the drive are -4..-1 and 1..37
+		int8_t Method = (Param->second.compare(0, 1, "-") == 0) ? -(int8_t)ToNumber(Param->second.substr(1), 1, 4) :
+			(int8_t)ToNumber(Param->second, 1, 37);
+
+		Bus.GetDrive(Count)->SetDesiredHoming(Method);
+	}
+	Param = Joint.parameters.find("extrapolate");
+	if(Param != Joint.parameters.end())
+		This.isExtrapolated = (Param->second == "true") || (Param->second == "1");
+	This.Extrapolator.Configure(Horizon, StaleTimeOut);
+
+	Names.push_back(Joint.name);
+}
+
+/*---------------------------------------------------------------------
+ * void UpdateStates()
+ * Take over the latest states. The position of a joint extrapolated is
+ * the estimate for now, as far as the horizon reaches.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void FaulhaberLine::UpdateStates()
+{
+	MCBusState State[MCBusMaxAxes];
+
+	Bus.GetStates(State, Count);
+	Bus.GetPolls(PollValue, MCBusMaxPolls);
+	for(uint8_t i = 0; i < MCBusMaxPolls; i++)
+	{
+		if(PollValue[i].isValid)
+			PollState[i] = (double)PollValue[i].Value;
+	}
+	//taken after the states, so none of them is newer
+	uint32_t Now = Bus.GetTime();
+
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		FaulhaberJoint &This = Joints[i];
+
+		if(!State[i].isValid)
+			continue;
+
+		This.PositionState = (double)State[i].Position / This.PositionFactor;
+		This.VelocityState = (double)State[i].Velocity / This.VelocityFactor;
+		This.PositionAge = Now - State[i].PositionAt;
+		This.VelocityAge = Now - State[i].VelocityAt;
+
+		This.Extrapolator.AddSample(This.PositionState, State[i].PositionAt, This.VelocityState);
+		This.Extrapolator.Update(Now);
+		if(This.isExtrapolated)
+		{
+			This.PositionState = This.Extrapolator.GetPosition();
+			This.PositionAge = (This.Extrapolator.GetAge() > Horizon) ? This.Extrapolator.GetAge() - Horizon : 0;
+		}
+		This.StaleState = This.Extrapolator.IsStale() ? 1.0 : 0.0;
+	}
+}
+
+/*---------------------------------------------------------------------
+ * bool StartSim()
+ * Start a simulation of the drives of all joints at the baud rate and
+ * the time scale of the bus. The bus opens its PTY instead of the port.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool FaulhaberLine::StartSim()
+{
+	Sim = std::make_unique<MCDriveSim>();
+	Sim->Configure(BaudRate, SimLatency, TimeScale);
+	for(uint8_t i = 0; i < Count; i++)
+		Sim->AddNode(Joints[i].NodeId);
+	if(!Sim->Start())
+	{
+		RCLCPP_ERROR(Log, "can't start the simulation");
+		Sim.reset();
+		return false;
+	}
+	RCLCPP_INFO(Log, "%u drives simulated at %s, x%u", Count, Sim->GetPortName(), TimeScale);
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * bool WaitForPhase(MCBusPhases Phase, uint32_t TimeOut)
+ * bool WaitForSwitch(uint32_t TimeOut)
+ * wait up to TimeOut ms for the bus to reach the Phase or to finish
+ * the switch of the OpModes. A switch timed out is cancelled, so the
+ * next one can be requested.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool FaulhaberLine::WaitForPhase(MCBusPhases Phase, uint32_t TimeOut)
+{
+	for(uint32_t t = 0; t < TimeOut; t += 10)
+	{
+		MCBusPhases Act = Bus.GetPhase();
+
+		if(Act == Phase)
+			return true;
+		if(Act == eBusError)
+			return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return false;
+}
+
+bool FaulhaberLine::WaitForSwitch(uint32_t TimeOut)
+{
+	for(uint32_t t = 0; t < TimeOut; t++)
+	{
+		MCBusSwitchStates Act = Bus.GetSwitchState();
+
+		if(Act == eBusSwitchDone)
+			return true;
+		if(Act == eBusSwitchError)
+			return false;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	Bus.CancelSwitch();
+	RCLCPP_ERROR(Log, "switch of the OpModes timed out after %u ms, cancelled", TimeOut);
+	for(uint8_t t = 0; (t < 10) && (Bus.GetSwitchState() == eBusSwitchPending); t++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	return false;
+}
+
+MCBusCmdModes FaulhaberLine::FindMode(uint8_t i, const std::vector<std::string> &Interfaces)
+{
+	for(const std::string &Interface : Interfaces)
+	{
+		if(Interface == Names[i] + "/" + hardware_interface::HW_IF_POSITION)
+			return eBusCmdPosition;
+		if(Interface == Names[i] + "/" + hardware_interface::HW_IF_VELOCITY)
+			return eBusCmdVelocity;
+	}
+	return eBusCmdNone;
+}
+
+}  // namespace faulhaber
@@ -0,0 +1,185 @@
+/*---------------------------------------------------
+ * FaulhaberParams.cpp
+ * implements the tuning of a MCBus and its drives
+ * by the parameters of the hardware description
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+#include "faulhaber/FaulhaberParams.h"
+
+namespace faulhaber
+{
+
+//--- local functions ---
+
+//the parameter of the joint if given, else the one of the hardware
+static const std::string *FindParam(const FaulhaberParamMap &Hw, const FaulhaberParamMap &Joint, const char *Name)
+{
+	auto Param = Joint.find(Name);
+
+	if(Param != Joint.end())
+		return &Param->second;
+	Param = Hw.find(Name);
+	return (Param != Hw.end()) ? &Param->second : NULL;
+}
+
+/*---------------------------------------------------------------------
+ * void AddPollObject(const std::string &Entry, const std::string &Joint, MCBus &Bus, uint8_t Axis,
+ *		std::vector<FaulhaberPollObject> &Polls)
+ * one entry of the poll_objects as name=Idx.SubIdx@RateHz[:Priority]
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+static void AddPollObject(const std::string &Entry, const std::string &Joint, MCBus &Bus, uint8_t Axis,
+	std::vector<FaulhaberPollObject> &Polls)
+{
+	size_t Eq = Entry.find('=');
+	size_t Dot = Entry.find('.', Eq);
+	size_t At = Entry.find('@', Dot);
+	size_t Colon = Entry.find(':', At);
+
+	if((Eq == 0) || (Eq == std::string::npos) || (Dot == std::string::npos) || (At == std::string::npos))
+		throw std::invalid_argument("poll_objects entry " + Entry);
+
+	uint16_t Idx = (uint16_t)ToNumber(Entry.substr(Eq + 1, Dot - Eq - 1), 0, 0xffff, 16);
+	uint8_t SubIdx = (uint8_t)ToNumber(Entry.substr(Dot + 1, At - Dot - 1), 0, 0xff, 16);
+	uint16_t RateHz = (uint16_t)ToNumber(Entry.substr(At + 1, Colon - At - 1), 0, 1000);
+	uint8_t Priority = (Colon != std::string::npos) ? (uint8_t)ToNumber(Entry.substr(Colon + 1), 0, 0xff) : 0;
+
+	if(RateHz == 0)
+		throw std::invalid_argument("poll_objects entry " + Entry + " without a rate");
+
+	uint8_t Slot = Bus.AddPoll(Axis, Idx, SubIdx, RateHz, Priority);
+
+	if(Slot == MCBusNone)
+		throw std::invalid_argument("more than " + std::to_string(MCBusMaxPolls) + " poll_objects");
+
+	Polls.push_back({Joint, Entry.substr(0, Eq), Slot});
+}
+
+//--- public functions ---
+
+/*---------------------------------------------------------------------
+ * uint32_t ToNumber(const std::string &Value, uint32_t Min, uint32_t Max, int Base)
+ * the whole of Value as an unsigned number within Min..Max. Neither
+ * blanks nor a sign nor anything following the number are accepted.
+ * --> throws a std::invalid_argument otherwise
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW shared with the line, with a minimum
+ *--------------------------------------------------------------------*/
+
+uint32_t ToNumber(const std::string &Value, uint32_t Min, uint32_t Max, int Base)
+{
+	size_t Used = 0;
+	unsigned long Number = 0;
+
+	if(!Value.empty() && std::isxdigit((unsigned char)Value[0]))
+	{
+		try
+		{
+			Number = std::stoul(Value, &Used, Base);
+		}
+		catch(const std::out_of_range &)
+		{
+			Used = 0;
+		}
+	}
+	if((Used == 0) || (Used != Value.size()) || (Number < Min) || (Number > Max))
+		throw std::invalid_argument(Value + " out of range " + std::to_string(Min) + ".." + std::to_string(Max));
+	return (uint32_t)Number;
+}
+
+/*---------------------------------------------------------------------
+ * void ApplyBusParams(const FaulhaberParamMap &Hw, MCBus &Bus)
+ * the parameters of the <hardware> tag for the line itself. To be
+ * called from on_init(), the bus isn't open yet.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void ApplyBusParams(const FaulhaberParamMap &Hw, MCBus &Bus)
+{
+	auto Param = Hw.find("latency_profile");
+
+	if(Param == Hw.end())
+		return;
+
+	if(Param->second == "low_latency")
+		Bus.SetLowLatency(true);
+	else if(Param->second == "default")
+		Bus.SetLowLatency(false);
+	else
+		throw std::invalid_argument("latency_profile must be default or low_latency, not " + Param->second);
+}
+
+/*---------------------------------------------------------------------
+ * void ApplyJointParams(const FaulhaberParamMap &Hw, const ComponentInfo &Joint, MCBus &Bus,
+ *		uint8_t Axis, std::vector<FaulhaberPollObject> &Polls)
+ * the timeouts and retries of the drive of a joint, and its polling.
+ * The objects polled are added to the Polls. To be called from
+ * on_init() once the axis has been added.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void ApplyJointParams(const FaulhaberParamMap &Hw, const hardware_interface::ComponentInfo &Joint, MCBus &Bus,
+	uint8_t Axis, std::vector<FaulhaberPollObject> &Polls)
+{
+	MCDrive *Drive = Bus.GetDrive(Axis);
+	const std::string *SdoTimeOut = FindParam(Hw, Joint.parameters, "sdo_timeout");
+	const std::string *CwTimeOut = FindParam(Hw, Joint.parameters, "cw_timeout");
+	const std::string *Param;
+
+	if(Drive == NULL)
+		throw std::invalid_argument("no axis for " + Joint.name);
+
+	if((SdoTimeOut != NULL) || (CwTimeOut != NULL))
+	{
+		Drive->SetRespTimeOuts((SdoTimeOut != NULL) ? (uint16_t)ToNumber(*SdoTimeOut, 0, 0xffff) : 0,
+			(CwTimeOut != NULL) ? (uint16_t)ToNumber(*CwTimeOut, 0, 0xffff) : 0);
+	}
+	if((Param = FindParam(Hw, Joint.parameters, "timeout_retries")) != NULL)
+		Drive->SetTORetryMax((uint8_t)ToNumber(*Param, 0, 0xff));
+	if((Param = FindParam(Hw, Joint.parameters, "busy_retries")) != NULL)
+		Drive->SetBusyRetryMax((uint8_t)ToNumber(*Param, 0, 0xff));
+
+	auto Rate = Joint.parameters.find("poll_rate");
+	auto Priority = Joint.parameters.find("poll_priority");
+
+	if((Rate != Joint.parameters.end()) || (Priority != Joint.parameters.end()))
+	{
+		Bus.SetAxisPolling(Axis,
+			(Rate != Joint.parameters.end()) ? (uint16_t)ToNumber(Rate->second, 0, 1000) : 0,
+			(Priority != Joint.parameters.end()) ? (uint8_t)ToNumber(Priority->second, 0, 0xff) : 0);
+	}
+
+	auto Objects = Joint.parameters.find("poll_objects");
+
+	if(Objects != Joint.parameters.end())
+	{
+		std::string List = Objects->second;
+		std::string Entry;
+
+		for(char &c : List)
+		{
+			if(c == ',')
+				c = ' ';
+		}
+
+		std::istringstream Entries(List);
+		while(Entries >> Entry)
+			AddPollObject(Entry, Joint.name, Bus, Axis, Polls);
+	}
+}
+
+}  // namespace faulhaber
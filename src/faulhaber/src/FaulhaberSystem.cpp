@@ -0,0 +1,200 @@
+/*---------------------------------------------------
+ * FaulhaberSystem.cpp
+ * implements the ros2_control SystemInterface of all
+ * drives of a serial line on top of MCBus
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include "faulhaber/FaulhaberSystem.h"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+//--- local defines ---
+
+//time all drives get to be enabled or disabled
+const uint32_t FaulhaberSystemPhaseTimeOut = 3000;
+//time all drives get to be reset and configured
+const uint32_t FaulhaberSystemConfigureTimeOut = 5000;
+//time all drives get to switch their OpModes
+const uint32_t FaulhaberSystemSwitchTimeOut = 300;
+
+namespace faulhaber
+{
+
+static rclcpp::Logger Log = rclcpp::get_logger("FaulhaberSystem");
+
+/*---------------------------------------------------------------------
+ * on_init()
+ * Read the parameters and add a drive to the bus for each joint.
+ * The bus itself is opened by on_configure().
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW diagnostics
+ * 2026-10-18 AW reset and homing
+ * 2026-10-18 AW simulation
+ * 2026-10-18 AW bus tuning
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::CallbackReturn FaulhaberSystem::on_init(const hardware_interface::HardwareInfo &info)
+{
+	if(hardware_interface::SystemInterface::on_init(info) != hardware_interface::CallbackReturn::SUCCESS)
+		return hardware_interface::CallbackReturn::ERROR;
+
+	if((info_.joints.size() == 0) || (info_.joints.size() > MCBusMaxAxes))
+	{
+		RCLCPP_FATAL(Log, "1 to %u joints expected, got %zu", MCBusMaxAxes, info_.joints.size());
+		return hardware_interface::CallbackReturn::ERROR;
+	}
+	return Line.Init(info_) ? hardware_interface::CallbackReturn::SUCCESS : hardware_interface::CallbackReturn::ERROR;
+}
+
+/*---------------------------------------------------------------------
+ * on_configure()
+ * on_cleanup()
+ * Open or close the serial line. on_configure() waits for all drives
+ * being reset and configured concurrently by the worker of the bus.
+ * It polls them from then on, but doesn't enable them.
+ * The diagnostics are published while the line is open.
+ * A launched simulation is started before the line is opened and
+ * stopped after it has been closed, as is the shared memory export.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW diagnostics
+ * 2026-10-18 AW wait for the configuration
+ * 2026-10-18 AW simulation
+ * 2026-10-18 AW shared memory export
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::CallbackReturn FaulhaberSystem::on_configure(const rclcpp_lifecycle::State &)
+{
+	return Line.Open(FaulhaberSystemConfigureTimeOut) ? hardware_interface::CallbackReturn::SUCCESS :
+		hardware_interface::CallbackReturn::ERROR;
+}
+
+hardware_interface::CallbackReturn FaulhaberSystem::on_cleanup(const rclcpp_lifecycle::State &)
+{
+	Line.Close();
+	return hardware_interface::CallbackReturn::SUCCESS;
+}
+
+/*---------------------------------------------------------------------
+ * on_activate()
+ * on_deactivate()
+ * Enable or disable all drives and wait for them, including the
+ * homing if configured. The commands start from the actual positions
+ * and zero speeds.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW homing
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::CallbackReturn FaulhaberSystem::on_activate(const rclcpp_lifecycle::State &)
+{
+	return Line.Activate(FaulhaberSystemPhaseTimeOut) ? hardware_interface::CallbackReturn::SUCCESS :
+		hardware_interface::CallbackReturn::ERROR;
+}
+
+hardware_interface::CallbackReturn FaulhaberSystem::on_deactivate(const rclcpp_lifecycle::State &)
+{
+	return Line.Deactivate(FaulhaberSystemPhaseTimeOut) ? hardware_interface::CallbackReturn::SUCCESS :
+		hardware_interface::CallbackReturn::ERROR;
+}
+
+std::vector<hardware_interface::StateInterface> FaulhaberSystem::export_state_interfaces()
+{
+	std::vector<hardware_interface::StateInterface> Interfaces;
+
+	Line.ExportStates(Interfaces);
+	return Interfaces;
+}
+
+std::vector<hardware_interface::CommandInterface> FaulhaberSystem::export_command_interfaces()
+{
+	std::vector<hardware_interface::CommandInterface> Interfaces;
+
+	Line.ExportCommands(Interfaces);
+	return Interfaces;
+}
+
+/*---------------------------------------------------------------------
+ * prepare_command_mode_switch()
+ * perform_command_mode_switch()
+ * Each joint can be commanded by either position or velocity.
+ * Stopping the active interface of a joint stops sending commands to
+ * it; the drive keeps its last target or speed.
+ * The drives of the joints started are switched to PP or PV together,
+ * each by a single write and read back of the OpMode, skipped if it
+ * is in that mode already.
+ * A switch not done within its timeout is cancelled and reported as
+ * an error.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW OpModes switched explicitly
+ * 2026-10-18 AW a switch timed out is cancelled
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::return_type FaulhaberSystem::prepare_command_mode_switch(
+	const std::vector<std::string> &start_interfaces,
+	const std::vector<std::string> &)
+{
+	return Line.CheckModes(start_interfaces) ? hardware_interface::return_type::OK :
+		hardware_interface::return_type::ERROR;
+}
+
+hardware_interface::return_type FaulhaberSystem::perform_command_mode_switch(
+	const std::vector<std::string> &start_interfaces,
+	const std::vector<std::string> &stop_interfaces)
+{
+	return Line.SwitchModes(start_interfaces, stop_interfaces, FaulhaberSystemSwitchTimeOut) ?
+		hardware_interface::return_type::OK : hardware_interface::return_type::ERROR;
+}
+
+/*---------------------------------------------------------------------
+ * read()
+ * Take over the latest states of all joints at once and the diagnostics.
+ * The stamps are the time of the values in the time of read().
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW states always taken over
+ * 2026-10-18 AW diagnostics
+ * 2026-10-18 AW stamps
+ * 2026-10-18 AW ages scaled back to real time
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::return_type FaulhaberSystem::read(const rclcpp::Time &time, const rclcpp::Duration &)
+{
+	return Line.Read(time) ? hardware_interface::return_type::OK : hardware_interface::return_type::ERROR;
+}
+
+/*---------------------------------------------------------------------
+ * write()
+ * Hand over the commands of all joints as a single set. The worker
+ * starts all of them within the same cycle. A set the worker hasn't
+ * taken over yet is replaced by this one.
+ * A joint with an invalid command keeps its previous one.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW commands no longer skipped
+ * 2026-10-18 AW by the FaulhaberLine
+ *--------------------------------------------------------------------*/
+
+hardware_interface::return_type FaulhaberSystem::write(const rclcpp::Time &, const rclcpp::Duration &)
+{
+	Line.Write();
+	return hardware_interface::return_type::OK;
+}
+
+}  // namespace faulhaber
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(faulhaber::FaulhaberSystem, hardware_interface::SystemInterface)
@@ -0,0 +1,1055 @@
+/*---------------------------------------------------
+ * MCBus.cpp
+ * implements the worker thread running the serial
+ * line with all its drives
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cstdio>
+#include <chrono>
+#include <exception>
+#include "faulhaber/MCBus.h"
+
+//--- local defines ---
+
+#define DEBUG_PHASE		0x0001
+#define DEBUG_CMD		0x0002
+#define DEBUG_ERROR		0x0004
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_BUS 0
+#else
+#define DEBUG_BUS (DEBUG_PHASE | DEBUG_ERROR)
+#endif
+
+//cycle of the worker; the Uart is read once per cycle
+const uint32_t BusCycleUs = 1000;
+//a speed is sent at most once per cycle
+const uint32_t BusSpeedInterval = 1;
+
+//--- public functions ---
+
+MCBus::MCBus()
+{
+	for(uint8_t i = 0; i < MCBusMaxAxes; i++)
+	{
+		PosHandle[i] = MCPollNone;
+		VelHandle[i] = MCPollNone;
+		SwitchLatency[i].store(0);
+	}
+	for(uint8_t i = 0; i < MCBusMaxPolls; i++)
+		PollHandle[i] = MCPollNone;
+	Group.Connect2MsgHandler(&Handler);
+}
+
+MCBus::~MCBus()
+{
+	Close();
+}
+
+/*---------------------------------------------------------------------
+ * uint8_t AddAxis(uint8_t NodeId)
+ * Add the drive with the given NodeId. Has to be done before Open().
+ * Returns the index of the axis or MCBusNone if all are used.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW the drives are run as a group
+ *--------------------------------------------------------------------*/
+
+uint8_t MCBus::AddAxis(uint8_t NodeId)
+{
+	if((AxisCount >= MCBusMaxAxes) || (Phase.load() != eBusClosed))
+		return MCBusNone;
+
+	Drives[AxisCount].SetNodeId(NodeId);
+	AxisNodeId[AxisCount] = NodeId;
+	Drives[AxisCount].Connect2MsgHandler(&Handler);
+	Group.AddDrive(&Drives[AxisCount]);
+
+	return AxisCount++;
+}
+
+uint8_t MCBus::GetAxisCount()
+{
+	return AxisCount;
+}
+
+/*---------------------------------------------------------------------
+ * MCDrive *GetDrive(uint8_t Axis)
+ * Direct access to a drive, e.g. to set its desired configuration.
+ * Must not be used from another thread while the bus is open.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+MCDrive *MCBus::GetDrive(uint8_t Axis)
+{
+	return (Axis < AxisCount) ? &Drives[Axis] : NULL;
+}
+
+/*---------------------------------------------------------------------
+ * void SetPollRate(uint16_t RateHz)
+ * rate position and speed of each axis are read with. Each read takes
+ * about 2 ms of the bus at 115200 Bd, so the total of all axes has to
+ * be kept well below 250 Hz there.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::SetPollRate(uint16_t RateHz)
+{
+	PollRate = RateHz;
+}
+
+/*---------------------------------------------------------------------
+ * bool SetAxisPolling(uint8_t Axis, uint16_t RateHz, uint8_t Priority)
+ * rate and priority position and speed of a single axis are read
+ * with; a rate of 0 keeps the one of SetPollRate(). See
+ * MCPollScheduler::SetPriority(). Has to be set before the first
+ * Open().
+ * --> false for an invalid axis
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCBus::SetAxisPolling(uint8_t Axis, uint16_t RateHz, uint8_t Priority)
+{
+	if(Axis >= AxisCount)
+		return false;
+
+	AxisPollRate[Axis] = RateHz;
+	AxisPollPriority[Axis] = Priority;
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * uint8_t AddPoll(uint8_t Axis, uint16_t Idx, uint8_t SubIdx, uint16_t RateHz, uint8_t Priority)
+ * Poll a further object of an axis, handed over by GetPolls() as a
+ * signed 32 bit value. Has to be done before the first Open().
+ * Returns the index of the poll or MCBusNone if all are used.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint8_t MCBus::AddPoll(uint8_t Axis, uint16_t Idx, uint8_t SubIdx, uint16_t RateHz, uint8_t Priority)
+{
+	if((PollCount >= MCBusMaxPolls) || (Axis >= AxisCount) || (Phase.load() != eBusClosed))
+		return MCBusNone;
+
+	PollAxis[PollCount] = Axis;
+	PollIdx[PollCount] = Idx;
+	PollSubIdx[PollCount] = SubIdx;
+	PollObjRate[PollCount] = RateHz;
+	PollPriority[PollCount] = Priority;
+
+	return PollCount++;
+}
+
+/*---------------------------------------------------------------------
+ * void SetLowLatency(bool isLow)
+ * Open the serial line in the low latency mode of its driver, see
+ * MCUart. Has to be set before Open().
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::SetLowLatency(bool isLow)
+{
+	Handler.SetLowLatency(isLow);
+}
+
+/*---------------------------------------------------------------------
+ * void SetResetOnOpen(bool isReset)
+ * void SetHomingOnActivate(uint16_t TimeOut)
+ * Reset all drives when the bus is opened, so they start from their
+ * boot configuration. Home all drives by their desired homing method
+ * after enabling them, each within TimeOut ms; 0 for no homing.
+ * Both have to be set before Open().
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::SetResetOnOpen(bool isReset)
+{
+	isResetOnOpen = isReset;
+}
+
+void MCBus::SetHomingOnActivate(uint16_t TimeOut)
+{
+	HomingTimeOut = TimeOut;
+}
+
+/*---------------------------------------------------------------------
+ * void SetTimeScale(uint16_t Scale)
+ * Run the clock of the worker Scale times faster than real time, with
+ * the cycles that much shorter, for drives simulated at the same scale
+ * by a MCDriveSim. 1 for real drives. Has to be set before Open().
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::SetTimeScale(uint16_t Scale)
+{
+	TimeScale = (Scale > 0) ? Scale : 1;
+}
+
+/*---------------------------------------------------------------------
+ * void SetShmExport(MCShmExport *Export)
+ * Export the state of each node into the region of Export, opened by
+ * the caller for at least the axes added. NULL for no export. Has to
+ * be set before Open() and the region must stay open until Close().
+ * Open() publishes the region with its clock base, so it has to be
+ * opened anew for each Open() of the bus.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::SetShmExport(MCShmExport *Export)
+{
+	if(Phase.load() == eBusClosed)
+		ShmExport = Export;
+}
+
+/*---------------------------------------------------------------------
+ * bool Open(const char *Port, uint32_t Baud)
+ * Open the serial line, register the objects to be polled and start
+ * the worker. The worker brings up the drives in eBusConfiguring and
+ * reports eBusIdle once all are configured. They are not enabled yet.
+ * --> false if the port can't be opened or the shared memory export
+ *     not be published
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW keep the baud rate for the load
+ * 2026-10-18 AW configure the drives first
+ * 2026-10-18 AW rate and priority per axis, further polls
+ * 2026-10-18 AW clock base of the shared memory export
+ * 2026-10-18 AW export published once
+ * 2026-10-18 AW baud rate kept in the member
+ *--------------------------------------------------------------------*/
+
+bool MCBus::Open(const char *Port, uint32_t Baud)
+{
+	if(Phase.load() != eBusClosed)
+		return false;
+
+	try
+	{
+		Handler.Open(Port, Baud);
+	}
+	catch(const std::exception &e)
+	{
+		#if(DEBUG_BUS & DEBUG_ERROR)
+		std::printf("Bus: can't open %s: %s\n", Port, e.what());
+		#endif
+		return false;
+	}
+	BaudRate = Handler.GetBaudRate();
+
+	for(uint8_t i = 0; i < AxisCount; i++)
+	{
+		uint16_t RateHz = (AxisPollRate[i] > 0) ? AxisPollRate[i] : PollRate;
+
+		if(PosHandle[i] == MCPollNone)
+		{
+			PosHandle[i] = Poll.RegisterObject(&Drives[i], 0x6064, 0x00, RateHz);
+			Poll.SetPriority(PosHandle[i], AxisPollPriority[i]);
+		}
+		if(VelHandle[i] == MCPollNone)
+		{
+			VelHandle[i] = Poll.RegisterObject(&Drives[i], 0x606C, 0x00, RateHz);
+			Poll.SetPriority(VelHandle[i], AxisPollPriority[i]);
+		}
+	}
+	for(uint8_t i = 0; i < PollCount; i++)
+	{
+		if(PollHandle[i] == MCPollNone)
+		{
+			PollHandle[i] = Poll.RegisterObject(&Drives[PollAxis[i]], PollIdx[i], PollSubIdx[i], PollObjRate[i]);
+			Poll.SetPriority(PollHandle[i], PollPriority[i]);
+		}
+	}
+
+	Timing = {};
+	isResetPending = isResetOnOpen;
+	OpenedAt = std::chrono::steady_clock::now();
+	if(ShmExport != NULL)
+	{
+		for(uint8_t i = 0; i < AxisCount; i++)
+			isShmWritten[i] = false;
+		if(!ShmExport->SetClockBase((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			OpenedAt.time_since_epoch()).count(), TimeScale))
+		{
+			#if(DEBUG_BUS & DEBUG_ERROR)
+			std::printf("Bus: shared memory export not published\n");
+			#endif
+			Handler.Close();
+			return false;
+		}
+	}
+	Phase.store(eBusConfiguring);
+	isRunning.store(true);
+	Worker = std::thread(&MCBus::Run, this);
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void Close()
+ * Stop the worker and close the serial port. The drives are left as
+ * they are, so they should be disabled by Deactivate() before.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW closes the serial port
+ *--------------------------------------------------------------------*/
+
+void MCBus::Close()
+{
+	isRunning.store(false);
+	if(Worker.joinable())
+		Worker.join();
+	Handler.Close();
+	Phase.store(eBusClosed);
+}
+
+/*---------------------------------------------------------------------
+ * bool Activate()
+ * bool Deactivate()
+ * Request the worker to enable or disable all drives. The progress is
+ * reported by GetPhase(): eBusRunning once all are enabled and homed,
+ * eBusIdle once all are disabled again or eBusError if a drive failed.
+ * --> false if the bus isn't open or the drives are being configured
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW not while configuring
+ *--------------------------------------------------------------------*/
+
+bool MCBus::Activate()
+{
+	MCBusPhases Act = Phase.load();
+
+	if((Act == eBusClosed) || (Act == eBusConfiguring))
+		return false;
+	if((Act == eBusEnabling) || (Act == eBusHoming) || (Act == eBusRunning))
+		return true;
+
+	return Phase.compare_exchange_strong(Act, eBusEnabling);
+}
+
+bool MCBus::Deactivate()
+{
+	MCBusPhases Act = Phase.load();
+
+	if((Act == eBusClosed) || (Act == eBusConfiguring))
+		return false;
+	if((Act == eBusDisabling) || (Act == eBusIdle))
+		return true;
+
+	return Phase.compare_exchange_strong(Act, eBusDisabling);
+}
+
+MCBusPhases MCBus::GetPhase()
+{
+	return Phase.load();
+}
+
+/*---------------------------------------------------------------------
+ * uint32_t GetTime()
+ * ms since the bus has been opened, the clock of the worker the times
+ * of the states are taken from. Can be called from any thread.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW scaled by the TimeScale
+ *--------------------------------------------------------------------*/
+
+uint32_t MCBus::GetTime()
+{
+	return (uint32_t)(std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - OpenedAt).count() * TimeScale);
+}
+
+/*---------------------------------------------------------------------
+ * MCBusTiming GetTiming()
+ * time the phases of the bring-up took. A phase is valid once
+ * GetPhase() has reported the one following it.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+MCBusTiming MCBus::GetTiming()
+{
+	return Timing;
+}
+
+/*---------------------------------------------------------------------
+ * bool SetCommands(const MCBusCommand *Cmd, uint8_t Count)
+ * Hand over the latest commands of the first Count axes as a set.
+ * All of them are taken over by the worker in the same cycle.
+ * Wait-free; a set not yet taken over is replaced by this one.
+ * --> false if Count exceeds the axes
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW exchanged by a triple buffer
+ *--------------------------------------------------------------------*/
+
+bool MCBus::SetCommands(const MCBusCommand *Cmd, uint8_t Count)
+{
+	MCBusCommandSet *Set = Commands.GetWriteBuffer();
+
+	if(Count > AxisCount)
+		return false;
+
+	for(uint8_t i = 0; i < Count; i++)
+		Set->Cmd[i] = Cmd[i];
+	for(uint8_t i = Count; i < AxisCount; i++)
+		Set->Cmd[i].Mode = eBusCmdNone;
+
+	Commands.Publish();
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * bool GetStates(MCBusState *State, uint8_t Count)
+ * Copy the latest states of the first Count axes. Wait-free.
+ * --> true if the worker has published new states since the last call
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW exchanged by a triple buffer
+ *--------------------------------------------------------------------*/
+
+bool MCBus::GetStates(MCBusState *State, uint8_t Count)
+{
+	bool isNew = States.Fetch();
+	const MCBusStateSet *Set = States.GetReadBuffer();
+
+	for(uint8_t i = 0; (i < Count) && (i < AxisCount); i++)
+		State[i] = Set->State[i];
+
+	return isNew;
+}
+
+/*---------------------------------------------------------------------
+ * void GetPolls(MCBusPollValue *Value, uint8_t Count)
+ * Copy the values of the first Count further polls as of the states
+ * taken over by the last GetStates(). Wait-free.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::GetPolls(MCBusPollValue *Value, uint8_t Count)
+{
+	const MCBusStateSet *Set = States.GetReadBuffer();
+
+	for(uint8_t i = 0; (i < Count) && (i < PollCount); i++)
+		Value[i] = Set->Poll[i];
+}
+
+/*---------------------------------------------------------------------
+ * bool GetDiagnostics(MCBusDiagnostics *Diag)
+ * Copy the latest diagnostics. Wait-free.
+ * --> true if the worker has collected new ones since the last call
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCBus::GetDiagnostics(MCBusDiagnostics *Diag)
+{
+	return Diagnostics.Read(Diag);
+}
+
+/*---------------------------------------------------------------------
+ * bool SwitchModes(const MCBusCmdModes *Modes, uint8_t Count)
+ * Request the worker to switch the OpMode of the first Count axes to
+ * the one of their command mode; eBusCmdNone keeps an axis as it is.
+ * A move or a write on its way is finished first. The progress is
+ * reported by GetSwitchState(). Possible while the bus is idle or
+ * running.
+ * --> false if the bus isn't open or a switch is pending already
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW a cancel requested before is dropped
+ *--------------------------------------------------------------------*/
+
+bool MCBus::SwitchModes(const MCBusCmdModes *Modes, uint8_t Count)
+{
+	if((Phase.load() == eBusClosed) || (Switch.load() == eBusSwitchPending) || (Count > AxisCount))
+		return false;
+
+	for(uint8_t i = 0; i < AxisCount; i++)
+		SwitchMode[i] = (i < Count) ? Modes[i] : eBusCmdNone;
+	isSwitchCancel.store(false);
+	Switch.store(eBusSwitchPending);
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void CancelSwitch()
+ * Request the worker to give up the pending switch, e.g. after the
+ * caller has timed out waiting for it. The requests of the drives on
+ * their way are reset and the state changes to eBusSwitchCancelled
+ * within the next cycle, so a new switch can be requested. Axes
+ * switched already keep their new OpMode.
+ * A switch finished in between is left as it is.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::CancelSwitch()
+{
+	isSwitchCancel.store(true);
+}
+
+/*---------------------------------------------------------------------
+ * MCBusSwitchStates GetSwitchState()
+ * uint32_t GetSwitchLatency(uint8_t Axis)
+ * state of the last switch requested and the time in ms the drive
+ * took for the last switch of the axis; 0 if it has been skipped as
+ * the drive was in the OpMode already
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+MCBusSwitchStates MCBus::GetSwitchState()
+{
+	return Switch.load();
+}
+
+uint32_t MCBus::GetSwitchLatency(uint8_t Axis)
+{
+	return (Axis < AxisCount) ? SwitchLatency[Axis].load() : 0;
+}
+
+//--- private functions ---
+
+/*---------------------------------------------------------------------
+ * void Run()
+ * the worker: one Cycle() per BusCycleUs with the time in ms since
+ * the bus has been opened
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW the clock shared with GetTime()
+ * 2026-10-18 AW scaled by the TimeScale
+ *--------------------------------------------------------------------*/
+
+void MCBus::Run()
+{
+	auto NextCycle = OpenedAt;
+
+	while(isRunning.load())
+	{
+		auto Now = std::chrono::steady_clock::now();
+		Cycle((uint32_t)(std::chrono::duration_cast<std::chrono::milliseconds>(Now - OpenedAt).count() * TimeScale));
+
+		NextCycle += std::chrono::microseconds(BusCycleUs / TimeScale);
+		if(NextCycle < Now)
+			NextCycle = Now;
+		std::this_thread::sleep_until(NextCycle);
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void Cycle(uint32_t time)
+ * update the bus, take over new commands, step the drives according to
+ * the phase and publish the states
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW publish the diagnostics
+ * 2026-10-18 AW switch the OpModes
+ * 2026-10-18 AW bring up the drives as a group
+ * 2026-10-18 AW cancel of a pending switch
+ * 2026-10-18 AW no polls while the group steps
+ *--------------------------------------------------------------------*/
+
+void MCBus::Cycle(uint32_t time)
+{
+	MCBusPhases Act = Phase.load();
+	DriveCommStates State = eMCIdle;
+
+	actTime = time;
+	Handler.Update(actTime);
+	Group.SetActTime(actTime);
+	//the line is left to the configuration and the group steps until done,
+	//a read issued right after each response would keep their CWs off it
+	if((Act == eBusIdle) || (Act == eBusRunning))
+		Poll.Update(actTime);
+
+	if(Commands.Fetch())
+	{
+		const MCBusCommandSet *Set = Commands.GetReadBuffer();
+
+		for(uint8_t i = 0; i < AxisCount; i++)
+			ActCmd[i] = Set->Cmd[i];
+	}
+
+	if(isSwitchCancel.exchange(false) && (Switch.load() == eBusSwitchPending))
+	{
+		#if(DEBUG_BUS & DEBUG_ERROR)
+		std::printf("Bus: switch of the OpModes cancelled\n");
+		#endif
+		AbortSwitch(eBusSwitchCancelled);
+	}
+
+	if((Switch.load() == eBusSwitchPending) && ((Act == eBusIdle) || (Act == eBusRunning)))
+		StepSwitch();
+
+	switch(Act)
+	{
+		case eBusConfiguring:
+			StepConfigure();
+			break;
+		case eBusEnabling:
+			State = Group.EnableDrives();
+			if(State == eMCDone)
+			{
+				Timing.EnableMs = Group.GetDuration();
+				Timing.HomingMs = 0;
+
+				#if(DEBUG_BUS & DEBUG_PHASE)
+				std::printf("Bus: all enabled in %u ms\n", Timing.EnableMs);
+				#endif
+
+				if(HomingTimeOut > 0)
+					Phase.store(eBusHoming);
+				else
+					StartRunning();
+			}
+			break;
+		case eBusHoming:
+			State = Group.DoHoming(HomingTimeOut);
+			if(State == eMCDone)
+			{
+				Timing.HomingMs = Group.GetDuration();
+
+				#if(DEBUG_BUS & DEBUG_PHASE)
+				std::printf("Bus: all homed in %u ms\n", Timing.HomingMs);
+				#endif
+
+				StartRunning();
+			}
+			break;
+		case eBusRunning:
+			for(uint8_t i = 0; i < AxisCount; i++)
+			{
+				//a move on its way is finished before the switch
+				if(!IsSwitching(i) || isMoving[i])
+					StepAxis(i);
+			}
+			break;
+		case eBusDisabling:
+			State = Group.DisableDrives();
+			if(State == eMCDone)
+			{
+				Timing.DisableMs = Group.GetDuration();
+				Phase.store(eBusIdle);
+
+				#if(DEBUG_BUS & DEBUG_PHASE)
+				std::printf("Bus: all disabled in %u ms\n", Timing.DisableMs);
+				#endif
+			}
+			break;
+		default:
+			break;
+	}
+
+	if((State == eMCError) || (State == eMCTimeout))
+	{
+		#if(DEBUG_BUS & DEBUG_ERROR)
+		std::printf("Bus: axis %d failed in phase %d\n", Group.GetFailedDrive(), Act);
+		#endif
+		Phase.store(eBusError);
+	}
+
+	Publish();
+	if(actTime - DiagAt >= MCBusDiagPeriod)
+		PublishDiagnostics();
+}
+
+/*---------------------------------------------------------------------
+ * void StepConfigure()
+ * Bring up all drives concurrently: the reset if requested, which
+ * includes the restore of the configuration after the boot, or else
+ * the configuration on its own. Each drive writes its configuration as
+ * a single batch, so the requests of all drives are pipelined on the
+ * line. The first failing drive stops the phase with eBusError.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::StepConfigure()
+{
+	DriveCommStates State;
+
+	if(isResetPending)
+		State = Group.ResetDrives();
+	else
+		State = Group.ConfigureDrives();
+
+	if(State == eMCDone)
+	{
+		if(isResetPending)
+			Timing.ResetMs = Group.GetDuration();
+
+		//the configuration of the slowest drive, measured by the drive
+		Timing.ConfigureMs = 0;
+		for(uint8_t i = 0; i < AxisCount; i++)
+		{
+			if(Drives[i].GetRestoreLatency() > Timing.ConfigureMs)
+				Timing.ConfigureMs = Drives[i].GetRestoreLatency();
+		}
+		isResetPending = false;
+		Phase.store(eBusIdle);
+
+		#if(DEBUG_BUS & DEBUG_PHASE)
+		std::printf("Bus: reset %u ms, configured %u ms\n", Timing.ResetMs, Timing.ConfigureMs);
+		#endif
+	}
+	else if((State == eMCError) || (State == eMCTimeout))
+	{
+		#if(DEBUG_BUS & DEBUG_ERROR)
+		std::printf("Bus: axis %d failed to come up\n", Group.GetFailedDrive());
+		#endif
+		isResetPending = false;
+		Phase.store(eBusError);
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void StartRunning()
+ * all drives are enabled: start over with the commands
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::StartRunning()
+{
+	for(uint8_t i = 0; i < AxisCount; i++)
+	{
+		isMoving[i] = false;
+		isTargetSet[i] = false;
+	}
+	Phase.store(eBusRunning);
+}
+
+/*---------------------------------------------------------------------
+ * void StepSwitch()
+ * Step the OpMode switch of all axes requested and not finished yet.
+ * An axis is started once it has no move, write or batch on its way.
+ * The switch of each drive is a single write and read back of the
+ * OpMode. The first failing drive stops the switch with eBusSwitchError.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW waits for a batch reserving the channel
+ *--------------------------------------------------------------------*/
+
+void MCBus::StepSwitch()
+{
+	bool isAllDone = true;
+
+	for(uint8_t i = 0; i < AxisCount; i++)
+	{
+		if((SwitchMode[i] == eBusCmdNone) || isSwitchDone[i])
+			continue;
+
+		if(!isSwitchStarted[i])
+		{
+			SDOCommStates SDOState = Drives[i].GetSDOState();
+
+			if(isMoving[i] || (SDOState == eSDOWaiting) || (SDOState == eSDORetry) || (SDOState == eSDOBusy))
+			{
+				isAllDone = false;
+				continue;
+			}
+			Drives[i].ResetComState();
+			isSwitchStarted[i] = true;
+		}
+
+		DriveCommStates State = Drives[i].SwitchOpMode((SwitchMode[i] == eBusCmdPosition) ? 1 : 3);
+
+		if(State == eMCDone)
+		{
+			SwitchLatency[i].store(Drives[i].GetSwitchLatency());
+			Drives[i].ResetComState();
+			AxisMode[i] = SwitchMode[i];
+			isTargetSet[i] = false;
+			isSwitchDone[i] = true;
+			continue;
+		}
+		if((State == eMCError) || (State == eMCTimeout))
+		{
+			#if(DEBUG_BUS & DEBUG_ERROR)
+			std::printf("Bus: axis %d failed to switch its OpMode\n", i);
+			#endif
+			AbortSwitch(eBusSwitchError);
+			return;
+		}
+		isAllDone = false;
+	}
+
+	if(isAllDone)
+	{
+		for(uint8_t i = 0; i < AxisCount; i++)
+		{
+			isSwitchStarted[i] = false;
+			isSwitchDone[i] = false;
+		}
+		Switch.store(eBusSwitchDone);
+
+		#if(DEBUG_BUS & DEBUG_PHASE)
+		std::printf("Bus: OpModes switched\n");
+		#endif
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void AbortSwitch(MCBusSwitchStates Final)
+ * end the pending switch with Final. The drives started but not done
+ * yet get their requests reset.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::AbortSwitch(MCBusSwitchStates Final)
+{
+	for(uint8_t i = 0; i < AxisCount; i++)
+	{
+		if(isSwitchStarted[i] && !isSwitchDone[i])
+			Drives[i].ResetComState();
+		isSwitchStarted[i] = false;
+		isSwitchDone[i] = false;
+	}
+	Switch.store(Final);
+}
+
+bool MCBus::IsSwitching(uint8_t i)
+{
+	return (Switch.load() == eBusSwitchPending) && (SwitchMode[i] != eBusCmdNone) && !isSwitchDone[i];
+}
+
+/*---------------------------------------------------------------------
+ * void StepAxis(uint8_t i)
+ * Work on the latest command of an axis.
+ * A speed is streamed and only written if it has changed.
+ * A target position is started as an immediate PP move. While a move
+ * is being handed over, newer targets are not queued but only the
+ * latest one is started next.
+ * Commands of another mode than the one switched to are ignored.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW only the mode switched to
+ *--------------------------------------------------------------------*/
+
+void MCBus::StepAxis(uint8_t i)
+{
+	DriveCommStates State = eMCIdle;
+
+	if((AxisMode[i] != eBusCmdNone) && (ActCmd[i].Mode != AxisMode[i]))
+		return;
+
+	switch(ActCmd[i].Mode)
+	{
+		case eBusCmdVelocity:
+			State = Drives[i].StreamSpeed(ActCmd[i].Velocity, BusSpeedInterval);
+			isTargetSet[i] = false;
+			break;
+		case eBusCmdPosition:
+			if(!isMoving[i] && (!isTargetSet[i] || (ActCmd[i].Position != MoveTarget[i])))
+			{
+				MoveTarget[i] = ActCmd[i].Position;
+				isTargetSet[i] = true;
+				isMoving[i] = true;
+
+				#if(DEBUG_BUS & DEBUG_CMD)
+				std::printf("Bus: axis %d to %d\n", i, MoveTarget[i]);
+				#endif
+			}
+			if(isMoving[i])
+			{
+				State = Drives[i].FastMovePP(MoveTarget[i], true, false);
+				if(State != eMCWaiting)
+				{
+					isMoving[i] = false;
+					if(State == eMCDone)
+						Drives[i].ResetComState();
+				}
+			}
+			break;
+		default:
+			break;
+	}
+
+	if((State == eMCError) || (State == eMCTimeout))
+	{
+		#if(DEBUG_BUS & DEBUG_ERROR)
+		std::printf("Bus: axis %d command failed\n", i);
+		#endif
+		Drives[i].ResetComState();
+		//the target is sent again with the next cycle
+		isTargetSet[i] = false;
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void Publish()
+ * Collect the latest samples and hand them over to GetStates().
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW exchanged by a triple buffer
+ * 2026-10-18 AW time of each value
+ * 2026-10-18 AW further polls
+ * 2026-10-18 AW export into shared memory
+ *--------------------------------------------------------------------*/
+
+void MCBus::Publish()
+{
+	for(uint8_t i = 0; i < AxisCount; i++)
+	{
+		MCPollSample Pos;
+		MCPollSample Vel;
+
+		if(Poll.GetSample(PosHandle[i], &Pos) && Poll.GetSample(VelHandle[i], &Vel))
+		{
+			ActState[i].Position = (int32_t)Pos.Value;
+			ActState[i].Velocity = (int32_t)Vel.Value;
+			ActState[i].PositionAt = Pos.RxAt;
+			ActState[i].VelocityAt = Vel.RxAt;
+			ActState[i].RxAt = ((int32_t)(Pos.RxAt - Vel.RxAt) < 0) ? Pos.RxAt : Vel.RxAt;
+			ActState[i].isValid = true;
+		}
+		ActState[i].StatusWord = Drives[i].GetSW();
+		ActState[i].StatusWordAt = actTime - Drives[i].ThisNode.GetSWAge();
+	}
+
+	for(uint8_t i = 0; i < PollCount; i++)
+	{
+		MCPollSample Sample;
+
+		if(Poll.GetSample(PollHandle[i], &Sample))
+		{
+			ActPoll[i].Value = (int32_t)Sample.Value;
+			ActPoll[i].RxAt = Sample.RxAt;
+			ActPoll[i].isValid = true;
+		}
+	}
+
+	MCBusStateSet *Set = States.GetWriteBuffer();
+
+	for(uint8_t i = 0; i < AxisCount; i++)
+		Set->State[i] = ActState[i];
+	for(uint8_t i = 0; i < PollCount; i++)
+		Set->Poll[i] = ActPoll[i];
+	States.Publish();
+
+	if(ShmExport != NULL)
+		ExportShm();
+}
+
+/*---------------------------------------------------------------------
+ * void ExportShm()
+ * Write the state of each node into the region of the ShmExport, but
+ * only once something of it has changed, so readers rarely have to
+ * retry. The EMCYs received since are appended to the history of the
+ * node. The heartbeat is written each cycle.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::ExportShm()
+{
+	for(uint8_t i = 0; i < AxisCount; i++)
+	{
+		MCShmNodeState *Node = &ShmState[i];
+		MCBusState *Act = &ActState[i];
+		int8_t OpMode = Drives[i].GetOpMode();
+		uint32_t EmcyCount = Drives[i].ThisNode.GetEmcyCount();
+
+		if(isShmWritten[i] && (Node->PositionAt == Act->PositionAt) && (Node->VelocityAt == Act->VelocityAt)
+			&& (Node->StatusWord == Act->StatusWord) && (Node->OpMode == OpMode) && (Node->EmcyCount == EmcyCount))
+		{
+			continue;
+		}
+
+		if(Node->EmcyCount != EmcyCount)
+		{
+			MCEmcyRecord Records[MCShmEmcyHistory];
+			uint8_t Count;
+
+			//the ring may hold more than the history, so keep the latest
+			while((Count = Drives[i].ThisNode.ReadEmcy(&ShmEmcyNext[i], Records, MCShmEmcyHistory)) > 0)
+			{
+				uint8_t Keep = (Node->EmcyValid + Count > MCShmEmcyHistory) ? MCShmEmcyHistory - Count : Node->EmcyValid;
+
+				for(uint8_t j = 0; j < Keep; j++)
+					Node->Emcy[j] = Node->Emcy[Node->EmcyValid - Keep + j];
+				for(uint8_t j = 0; j < Count; j++)
+					Node->Emcy[Keep + j] = Records[j];
+				Node->EmcyValid = Keep + Count;
+			}
+		}
+
+		Node->NodeId = AxisNodeId[i];
+		Node->OpMode = OpMode;
+		Node->StatusWord = Act->StatusWord;
+		Node->StatusWordAt = Act->StatusWordAt;
+		Node->Position = Act->Position;
+		Node->PositionAt = Act->PositionAt;
+		Node->Velocity = Act->Velocity;
+		Node->VelocityAt = Act->VelocityAt;
+		Node->EmcyCount = EmcyCount;
+		Node->WrittenAt = actTime;
+		ShmExport->Write(i, Node);
+		isShmWritten[i] = true;
+	}
+	ShmExport->SetHeartbeat(actTime);
+}
+
+/*---------------------------------------------------------------------
+ * void PublishDiagnostics()
+ * Collect the counters of the nodes and of the line and hand them
+ * over to GetDiagnostics(). The load is taken from the bytes on the
+ * wire since the last call at 10 bits per byte.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCBus::PublishDiagnostics()
+{
+	MCBusDiagnostics *Diag = Diagnostics.GetWriteBuffer();
+	MCFrameCounts Now;
+
+	Handler.GetFrameCounts(&Now);
+
+	Diag->At = actTime;
+	Diag->TxFrames = Now.TxFrames;
+	Diag->RxFrames = Now.RxFrames;
+	Diag->CrcErrors = Now.CrcErrors;
+	Diag->LeaseExpiries = Now.LeaseExpiries;
+	Diag->LoadPermille = (uint16_t)(((uint64_t)(Now.TxBytes - DiagCounts.TxBytes + Now.RxBytes - DiagCounts.RxBytes)
+		* 10 * 1000 * 1000) / ((uint64_t)BaudRate * (actTime - DiagAt)));
+	Diag->PollLoadPermille = Poll.GetLoadPermille(BaudRate);
+
+	for(uint8_t i = 0; i < AxisCount; i++)
+	{
+		SDOStats Stats;
+		MCBusAxisDiag *Axis = &Diag->Axis[i];
+
+		Drives[i].ThisNode.GetSDOStats(&Stats);
+		Axis->RttP50 = SDOHandler::GetRttPercentile(&Stats, 50);
+		Axis->RttP99 = SDOHandler::GetRttPercentile(&Stats, 99);
+		Axis->RttMax = Stats.RttMax;
+		Axis->Requests = Stats.Requests;
+		Axis->Retries = Stats.Retries;
+		Axis->BusyRetries = Stats.BusyRetries;
+		Axis->TimeOuts = Stats.TimeOuts;
+		Axis->Errors = Stats.Errors;
+		Axis->SWAge = Drives[i].ThisNode.GetSWAge();
+		Axis->SwitchLatency = SwitchLatency[i].load();
+	}
+	Diagnostics.Publish();
+
+	DiagCounts = Now;
+	DiagAt = actTime;
+}
@@ -29,8 +29,13 @@
 #define DEBUG_PULLSW    0x1000
 #define DEBUG_WriteSDO 0x2000
 #define DEBUG_ReadSDO  0x4000
+#define DEBUG_RESTORE  0x8000
 
-#define DEBUG_DRIVE (DEBUG_TO | DEBUG_ERROR) 
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_DRIVE 0
+#else
+#define DEBUG_DRIVE (DEBUG_TO | DEBUG_ERROR)
+#endif
 
 //--- some definition to handle StatusWord and ControlWord of a drive ---
 
@@ -107,6 +112,7 @@ void MCDrive::SetNodeId(uint8_t ThisNodeId)
 void MCDrive::Connect2MsgHandler(MsgHandler *ThisHandler)
 {
 	ThisNode.Connect2MsgHandler(ThisHandler);
+	Handler = ThisHandler;
 	
 	MCDriveRxTxState = eMCIdle;
 }
@@ -116,14 +122,24 @@ void MCDrive::Connect2MsgHandler(MsgHandler *ThisHandler)
  * If no HW-timer is used this method needs to be called cyclically
  * with the latest millis() value to check for any time-outs.
  * Does the same update for the MCNode and embedded SDOhandler.
+ * Restores the desired configuration after a boot of the drive.
  *  
  * 2020-11-22 AW Done
+ * 2026-10-18 AW restore the configuration after a boot
  *--------------------------------------------------------------------*/
 
 void MCDrive::SetActTime(uint32_t time)
 {
 	actTime = time;
 	ThisNode.SetActTime(time);
+
+	if(ThisNode.GetBootCount() != BootsSeen)
+	{
+		BootsSeen = ThisNode.GetBootCount();
+		OnBoot();
+	}
+	if(RestoreState == eMCWaiting)
+		RunRestore();
 }
 
 /*-------------------------------------------------------------------
@@ -217,13 +233,16 @@ uint8_t MCDrive::GetAccessStep()
  * Reset the ComState of the Drive but do the same for the MCNode instance
  * and reset the AccessSteps to 0 too.
  * Timeout and Retry counters are reset too to have a clean drive.
+ * A batch of a sequence is cancelled; the restore isn't, see RunRestore().
  * 
  * 2020-11-22 AW Done
+ * 2026-10-18 AW cancels the batch of a sequence
  *--------------------------------------------------------------------*/
 
 void MCDrive::ResetComState()
 {
 	MCDriveRxTxState = eMCIdle;
+	ThisNode.CancelBatch(Batch);
 	ThisNode.ResetComState();
 	SDOAccessState = eSDOIdle;
 	CWAccessState = eCWIdle;
@@ -231,6 +250,9 @@ void MCDrive::ResetComState()
 
 	TORetryCounter = 0;
 	BusyRetryCounter = 0;
+
+	isFastFallback = false;
+	isMoveStatsActive = false;
 }
 
 /*---------------------------------------------------------------------
@@ -238,9 +260,10 @@ void MCDrive::ResetComState()
  * Set a different value for the number of TO the drive can have before
  * the ComState will be eMCError. Default is set in the class definition.
  * 
- * This could be extended to the MCNode instance too but is not so far.
+ * Applies to the MCNode and its SDOHandler as well.
  * 
  * 2020-11-22 AW Done
+ * 2026-10-18 AW reaches the SDOHandler
  *--------------------------------------------------------------------*/
 
 void MCDrive::SetTORetryMax(uint8_t value)
@@ -254,9 +277,10 @@ void MCDrive::SetTORetryMax(uint8_t value)
  * can have before the ComState will be eMCError. 
  * Default is set in the class definition.
  * 
- * This could be extended to the MCNode instance too but is not so far.
+ * Applies to the MCNode and its SDOHandler as well.
  * 
  * 2020-11-22 AW Done
+ * 2026-10-18 AW reaches the SDOHandler
  *--------------------------------------------------------------------*/
 
 void MCDrive::SetBusyRetryMax(uint8_t value)
@@ -264,19 +288,35 @@ void MCDrive::SetBusyRetryMax(uint8_t value)
 	ThisNode.SetBusyRetryMax(value);
 }
 
+/*---------------------------------------------------------------------
+ * void SetRespTimeOuts(uint16_t SdoTimeOut, uint16_t CwTimeOut)
+ * Time in ms the response to a SDO or to a CW of this drive may take
+ * before it is retried; 0 keeps the default. See MCNode.
+ * 
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDrive::SetRespTimeOuts(uint16_t SdoTimeOut, uint16_t CwTimeOut)
+{
+	ThisNode.SetRespTimeOuts(SdoTimeOut, CwTimeOut);
+}
+
 //---------------------------------------------------------------------
 // ----- real drive behavior ------------------------------------------
 
 /*---------------------------------------------------------------------
  * DriveCommStates UpdateDriveStatus()
  * Update the local copy of the OpMode and the StatusWord.
- * Uses a step sequence based on AccessStep to create the sequence of
- * requests.
+ * Both reads are sent as a single batch, the SW read being started
+ * directly when the OpMode has been received. The batch owns the SDO
+ * channel until its end, so a shared read of the SW in the meantime
+ * reports eSDOBusy and is sent after the batch.
  * --> will report eMCWaiting while busy
  * --> will report eMCDone when finished
  * --> needs to be reset to eMCIdle after having registered the eMCDone
  * 
  * 2020-11-22 AW Done
+ * 2026-10-18 AW both reads as a batch
  *--------------------------------------------------------------------*/
 
 DriveCommStates MCDrive::UpdateDriveStatus()
@@ -284,58 +324,24 @@ DriveCommStates MCDrive::UpdateDriveStatus()
 	switch(AccessStep)
 	{
 		case 0:
-			switch(SDOAccessState)
-			{
-				case eSDODone:
-					OpModeReported = (uint8_t)ThisNode.GetObjValue();
-					AccessStep = 1;
-					ThisNode.ResetSDOState();
-					SDOAccessState = eSDOIdle;
-					
-					#if(DEBUG_DRIVE & DEBUG_UPDATE)
-					std::printf("Drive: OpMode pulled %X\n", OpModeReported);
-					#endif
-					break;
-				case eSDOIdle:
-				case eSDORetry:
-				case eSDOWaiting:
-					#if(DDEBUG_DRIVE & DEBUG_UPDATE)
-					if(SDOAccessState == eIdle)
-						std::printf("Drive: OpMode Request ");
-					else if(SDOAccessState == eRetry)
-						std::printf("Drive: OpMode Request Retry");
-					#endif
-					
-					SDOAccessState = ThisNode.ReadSDO(0x6061, 0x00);
-					MCDriveRxTxState = eMCWaiting;
-					break;				
-			}
-			break;
+			SetBatchEntry(0, eSdoReadReq, 0x6061, 0x00, 1, 0);
+			SetBatchEntry(1, eSdoReadReq, 0x6041, 0x00, 2, 0);
+			AccessStep = 1;
+			
+			#if(DEBUG_DRIVE & DEBUG_UPDATE)
+			std::printf("Drive: OpMode + SW Request ");
+			#endif
+			[[fallthrough]];
 		case 1:
-			switch(SDOAccessState)
+			if(RunBatch(2) == eMCDone)
 			{
-				case eSDODone:
-					ThisNode.StatusWord = (uint16_t)ThisNode.GetObjValue();
-					AccessStep = 0;
-					ThisNode.ResetSDOState();
-					SDOAccessState = eSDOIdle;
-					
-					MCDriveRxTxState = eMCDone;
-					
-					#if(DEBUG_DRIVE & DEBUG_UPDATE)
-					std::printf("Drive: SW pulled %X\n", ThisNode.StatusWord);
-					#endif
-					break;
-				case eSDOIdle:
-				case eSDORetry:
-				case eSDOWaiting:
-					#if(DEBUG_DRIVE & DEBUG_UPDATE)
-					if(SDOAccessState == eSDOIdle)
-						std::printf("Drive: SW Request ");
-					#endif
+				OpModeReported = (int8_t)Batch[0].Value;
+				ThisNode.StatusWord = (uint16_t)Batch[1].Value;
+				AccessStep = 0;
 					
-					SDOAccessState = ThisNode.ReadSDO(0x6041, 0x00);
-					break;
+				#if(DEBUG_DRIVE & DEBUG_UPDATE)
+				std::printf("Drive: OpMode %X SW pulled %X\n", OpModeReported, ThisNode.StatusWord);
+				#endif
 			}
 			break;
 	}	
@@ -355,17 +361,93 @@ int8_t MCDrive::GetOpMode()
 	return OpModeReported;
 }
 
+/*---------------------------------------------------------------------
+ * DriveCommStates SendReset()
+ * Send the reset Msg and wait for the boot Msg of the drive. The
+ * restore of the desired configuration is started by the boot as usual
+ * and is waited for, too. So the drive is configured when done and its
+ * sequences don't interfere with the restore.
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when booted and restored
+ * --> will report eMCTimeout if no boot Msg within MCDriveBootTimeOut
+ * --> will report eMCError/eMCTimeout if the restore failed
+ * --> needs to be reset to eMCIdle after having registered the eMCDone
+ * 
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::SendReset()
+{
+	switch(AccessStep)
+	{
+		case 0:
+			BootsAtReset = ThisNode.GetBootCount();
+			ResetSentAt = actTime;
+			isBootExpected = true;
+			MCDriveRxTxState = eMCWaiting;
+			AccessStep = 1;
+			[[fallthrough]];
+		case 1:
+			CWAccessState = ThisNode.SendReset();
+			if(CWAccessState == eCWDone)
+			{
+				ThisNode.ResetComState();
+				CWAccessState = eCWIdle;
+				ResetSentAt = actTime;
+				AccessStep = 2;
+			}
+			else if(CWAccessState == eCWError)
+			{
+				ThisNode.ResetComState();
+				CWAccessState = eCWIdle;
+				isBootExpected = false;
+				MCDriveRxTxState = eMCError;
+				AccessStep = 0;
+			}
+			break;
+		case 2:
+			if(ThisNode.GetBootCount() != BootsAtReset)
+			{
+				#if(DEBUG_DRIVE & DEBUG_RESTORE)
+				std::printf("Drive: booted after %u ms\n", actTime - ResetSentAt);
+				#endif
+
+				AccessStep = 3;
+			}
+			else if((actTime - ResetSentAt) > MCDriveBootTimeOut)
+			{
+				isBootExpected = false;
+				MCDriveRxTxState = eMCTimeout;
+				AccessStep = 0;
+
+				#if(DEBUG_DRIVE & DEBUG_ERROR)
+				std::printf("Drive: no boot after reset\n");
+				#endif
+			}
+			break;
+		case 3:
+			if(RestoreState != eMCWaiting)
+			{
+				MCDriveRxTxState = (RestoreState == eMCIdle) ? eMCDone : RestoreState;
+				AccessStep = 0;
+			}
+			break;
+	}
+	return MCDriveRxTxState;
+}
+
 /*---------------------------------------------------------------------
  * DriveCommStates ReadObject(uint16_t idx, uint8_t subIdx, uint8_t *dataPtr)
  * DriveCommStates ReadObject(uint16_t idx, uint8_t subIdx, uint16_t *dataPtr)
  * DriveCommStates ReadObject(uint16_t idx, uint8_t subIdx, uint32_t *dataPtr)
  *
- * --> will report eMCWaiting while busy
+ * --> will report eMCWaiting while busy, also while a batch uses the channel
  * --> will report eMCDone when finished
  * --> needs to be reset to eMCIdle after having registered the eMCDone
  * 
  * 2024-05-12 AW MCDrive
  * derived from UpdateActDrive for 3-word transfers
+ * 2026-10-18 AW waits while the channel is busy
  *--------------------------------------------------------------------*/
 
 DriveCommStates MCDrive::ReadObject(uint16_t idx, uint8_t subIdx, uint8_t *dataPtr)
@@ -385,6 +467,7 @@ DriveCommStates MCDrive::ReadObject(uint16_t idx, uint8_t subIdx, uint8_t *dataP
 		case eSDOIdle:
 		case eSDORetry:
 		case eSDOWaiting:
+		case eSDOBusy:
 			#if(DEBUG_DRIVE & DEBUG_ReadSDO)
 			if(SDOAccessState == eSDOIdle)
 			std::printf("Drive: object %X.", idx);
@@ -417,6 +500,7 @@ DriveCommStates MCDrive::ReadObject(uint16_t idx, uint8_t subIdx, uint16_t *data
 		case eSDOIdle:
 		case eSDORetry:
 		case eSDOWaiting:
+		case eSDOBusy:
 			#if(DEBUG_DRIVE & DEBUG_ReadSDO)
 			if(SDOAccessState == eSDOIdle)
 			std::printf("Drive: object %X.", idx);
@@ -449,6 +533,7 @@ DriveCommStates MCDrive::ReadObject(uint16_t idx, uint8_t subIdx, uint32_t *data
 		case eSDOIdle:
 		case eSDORetry:
 		case eSDOWaiting:
+		case eSDOBusy:
 			#if(DEBUG_DRIVE & DEBUG_ReadSDO)
 			if(SDOAccessState == eSDOIdle)
 			std::printf("Drive: object %X.", idx);
@@ -633,6 +718,7 @@ DriveCommStates MCDrive::DownloadParamterList(MCDriveParameter *Parameters, uint
  * Will only return positive when all have been uploaded.
  *
  * 2024-07-23 AW
+ * 2026-10-18 AW waits while the channel is busy
  *------------------------------------------------------------------------*/
 
 DriveCommStates MCDrive::UploadParamterList(MCDriveParameter *Parameters, uint8_t count)
@@ -658,6 +744,7 @@ DriveCommStates MCDrive::UploadParamterList(MCDriveParameter *Parameters, uint8_
 		  case eSDOIdle:
 		  case eSDORetry:
 		  case eSDOWaiting:
+		  case eSDOBusy:
 			  #if(DEBUG_DRIVE & DEBUG_ReadSDO)
 			  if(SDOAccessState == eSDOIdle)
 			    std::printf("Drive: object %X.%X angefragt\n", index, subIdx);
@@ -687,6 +774,7 @@ DriveCommStates MCDrive::UploadParamterList(MCDriveParameter *Parameters, uint8_
  * --> needs to be reset to eMCIdle after having registered the eMCDone
  *
  * 2020-11-22 AW Done
+ * 2026-10-18 AW clear a pending EMCY once enabled
  *--------------------------------------------------------------------*/
 
 DriveCommStates MCDrive::EnableDrive()
@@ -699,6 +787,7 @@ DriveCommStates MCDrive::EnableDrive()
 		if((CWAccessState == eCWIdle) || (CWAccessState == eCWDone))
 		{
 			ThisNode.ResetComState();
+			ThisNode.ClearFault();
 			CWAccessState = eCWIdle;
 			MCDriveRxTxState = eMCDone;
 			
@@ -880,6 +969,69 @@ DriveCommStates MCDrive::SetOpMode(int8_t OpMode)
 	return CheckComState();				
 }
 
+/*---------------------------------------------------------------------
+ * DriveCommStates SwitchOpMode(int8_t OpMode)
+ * Change the OpMode with a single batch writing 0x6060.00 and reading
+ * back 0x6061.00. The read is sent directly with the response of the
+ * write, so the switch costs a single round trip of the caller.
+ * Nothing is sent if OpModeReported is OpMode already.
+ * Other than SetOpMode() the drive has to report the new mode.
+ *
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when the drive reports the OpMode
+ * --> will report eMCError if it reports another one
+ * --> needs to be reset to eMCIdle after having registered the eMCDone
+ *
+ * uint32_t GetSwitchLatency()
+ * time in ms the last switch took; 0 if it has been skipped
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::SwitchOpMode(int8_t OpMode)
+{
+	switch(AccessStep)
+	{
+		case 0:
+			OpModeRequested = OpMode;
+			if(OpModeReported == OpModeRequested)
+			{
+				SwitchLatency = 0;
+				MCDriveRxTxState = eMCDone;
+				break;
+			}
+			SetBatchEntry(0, eSdoWriteReq, 0x6060, 0x00, 1, (uint8_t)OpModeRequested);
+			SetBatchEntry(1, eSdoReadReq, 0x6061, 0x00, 1, 0);
+			SwitchStartedAt = actTime;
+			AccessStep = 1;
+			[[fallthrough]];
+		case 1:
+			if(RunBatch(2) == eMCDone)
+			{
+				OpModeReported = (int8_t)Batch[1].Value;
+				SwitchLatency = actTime - SwitchStartedAt;
+				AccessStep = 0;
+				//a speed has to be written again in the new mode
+				isSpeedSent = false;
+
+				if(OpModeReported != OpModeRequested)
+					MCDriveRxTxState = eMCError;
+
+				#if(DEBUG_DRIVE & DEBUG_RWPARAM)
+				std::printf("Drive: OpMode %d in %u ms\n", OpModeReported, SwitchLatency);
+				#endif
+			}
+			break;
+	}
+	//always check whether a SDO is stuck final 
+	return CheckComState();
+}
+
+uint32_t MCDrive::GetSwitchLatency()
+{
+	return SwitchLatency;
+}
+
 /*---------------------------------------------------------------------
  * DriveCommStates SetProfile(uint32_t ProfileACC, uint32_t ProfileDEC, uint32_t ProfileSpeed, int16_t ProfileType)
  * Set all the profile related parameters:
@@ -893,6 +1045,7 @@ DriveCommStates MCDrive::SetOpMode(int8_t OpMode)
  * --> needs to be reset to eMCIdle after having registered the eMCDone
  * 
  * 2020-11-22 AW Done
+ * 2026-10-18 AW all four objects written as a batch
  *--------------------------------------------------------------------*/
 
 DriveCommStates MCDrive::SetProfile(uint32_t ProfileACC, uint32_t ProfileDEC, uint32_t ProfileSpeed, int16_t ProfileType)
@@ -901,45 +1054,19 @@ DriveCommStates MCDrive::SetProfile(uint32_t ProfileACC, uint32_t ProfileDEC, ui
 	switch(AccessStep)
 	{
 		case 0:
-			if((MCDriveRxTxState = WriteObject(0x6083, 0x00,(uint32_t)ProfileACC)) == eMCDone)
-			{
-				AccessStep = 1;
-				MCDriveRxTxState = eMCIdle;
-
-				#if(DEBUG_DRIVE & DEBUG_RWPARAM)
-				std::printf("Drive: ACC set\n");
-				#endif
-			}
-			break;
+			SetBatchEntry(0, eSdoWriteReq, 0x6083, 0x00, 4, ProfileACC);
+			SetBatchEntry(1, eSdoWriteReq, 0x6084, 0x00, 4, ProfileDEC);
+			SetBatchEntry(2, eSdoWriteReq, 0x6081, 0x00, 4, ProfileSpeed);
+			SetBatchEntry(3, eSdoWriteReq, 0x6086, 0x00, 2, (uint16_t)ProfileType);
+			AccessStep = 1;
+			[[fallthrough]];
 		case 1:
-			if((MCDriveRxTxState = WriteObject(0x6084, 0x00,(uint32_t)ProfileDEC)) == eMCDone)
-			{
-				AccessStep = 2;
-				MCDriveRxTxState = eMCIdle;
-
-				#if(DEBUG_DRIVE & DEBUG_RWPARAM)
-				std::printf("Drive: DEC set\n");
-				#endif
-			}
-			break;
-		case 2:
-		  if((MCDriveRxTxState = WriteObject(0x6081, 0x00,(uint32_t)ProfileSpeed)) == eMCDone)
-			{
-				AccessStep = 3;
-				MCDriveRxTxState = eMCIdle;
-
-				#if(DEBUG_DRIVE & DEBUG_RWPARAM)
-				std::printf("Drive: Speed set\n");
-				#endif
-			}
-			break;
-		case 3:
-			if((MCDriveRxTxState = WriteObject(0x6086, 0x00,(uint16_t)ProfileType)) == eMCDone)
+			if(RunBatch(4) == eMCDone)
 			{
 				AccessStep = 0;
 
 				#if(DEBUG_DRIVE & DEBUG_RWPARAM)
-				std::printf("Drive: P-Type set\n");
+				std::printf("Drive: Profile set\n");
 				#endif
 			}
 			break;
@@ -965,11 +1092,13 @@ DriveCommStates MCDrive::SetProfile(uint32_t ProfileACC, uint32_t ProfileDEC, ui
  * --> must be reset to eMCIdle after registering eMCDone
  *
  * 2020-11-22 AW Done
+ * 2026-10-18 AW frames and time of the move are recorded
  *--------------------------------------------------------------------*/
 
 DriveCommStates MCDrive::StartAbsMove(int32_t TargetPos, bool immeditate)
 {
-	return MovePP(TargetPos, immeditate, false);
+	BeginMoveStats(false);
+	return EndMoveStats(MovePP(TargetPos, immeditate, false));
 }
 
 /*---------------------------------------------------------------------
@@ -988,117 +1117,669 @@ DriveCommStates MCDrive::StartAbsMove(int32_t TargetPos, bool immeditate)
  * --> must be reset to eMCIdle after registering eMCDone
  *
  * 2020-11-22 AW Done
+ * 2026-10-18 AW frames and time of the move are recorded
  *--------------------------------------------------------------------*/
 
 DriveCommStates MCDrive::StartRelMove(int32_t TargetPos, bool immeditate)
 {
-	return MovePP(TargetPos, immeditate, true);
+	BeginMoveStats(false);
+	return EndMoveStats(MovePP(TargetPos, immeditate, true));
 }
 
 /*---------------------------------------------------------------------
- * DriveCommStates MoveAtSpeed(int32_t RefSpeed)
- * Switch the drive to PV mode and move at the given speed.
- * Parameter:
- * RefSpeed: speed given in the units scaled by the FactorGroup (default: 1/min (rpm))
+ * DriveCommStates PreloadMovePP(int32_t TargetPos)
+ * First phase of a synchronised start of several drives:
+ * switch the drive to PP, clear the start bit and write the target,
+ * but don't start the move. Uses the internal MovePP up to the start.
+ * The move is started either by FinishMovePP() or by sending the CW of
+ * GetPPStartCW() in a burst and calling PPStartSent() then.
  *
  * --> will report eMCWaiting while busy
- * --> will report eMCDone when finished
+ * --> will report eMCDone when the target is set
  * --> must be reset to eMCIdle after registering eMCDone
  *
- * 2020-11-22 AW Done
- * 2024-07-06 AW successfully tested based on SetOpMode and WriteObject
+ * 2026-10-18 AW Done
  *--------------------------------------------------------------------*/
 
-DriveCommStates MCDrive::MoveAtSpeed(int32_t RefSpeed)
+DriveCommStates MCDrive::PreloadMovePP(int32_t TargetPos)
 {
-	
-	switch(AccessStep)
+	if(AccessStep < 3)
 	{
-		case 0:
-		  OpModeRequested = 3;
-		  
-		  if((MCDriveRxTxState = SetOpMode(OpModeRequested)) == eMCDone)
-			{
-				OpModeReported = 3;
-				AccessStep = 1;
-				MCDriveRxTxState = eMCIdle;
+		DriveCommStates State = MovePP(TargetPos, false, false);
 
-				#if(DEBUG_DRIVE & DEBUG_MoveSpeed)
-				std::printf("Drive: OpMode set\n");
-				#endif
-			}
-			break;
-		case 1:		  
-		  if((MCDriveRxTxState = WriteObject(0x60FF, 0x00,(uint32_t)RefSpeed)) == eMCDone)
-			{	
-				AccessStep = 0;
-				#if(DEBUG_DRIVE & DEBUG_MoveSpeed)
-				std::printf("Drive: TSpeed set\n");
-				#endif
-			}
-			break;
-	}					
-	//always check whether a SDO is stuck final 
-	return CheckComState();				
+		if((State == eMCError) || (State == eMCTimeout))
+			return State;
+		MCDriveRxTxState = eMCWaiting;
+	}
+
+	if(AccessStep == 3)
+	{
+		isPPPreloaded = true;
+		AccessStep = 0;
+		MCDriveRxTxState = eMCDone;
+	}
+	return CheckComState();
 }
 
 /*---------------------------------------------------------------------
- * DriveCommStates ConfigureHoming(int8_t method)
- * Set the requested homing method by writing via SDO to 0x6098.00.
+ * uint16_t GetPPStartCW(bool immeditate, bool relative)
+ * the CW starting a preloaded PP move
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint16_t MCDrive::GetPPStartCW(bool immeditate, bool relative)
+{
+	uint16_t newCW = (ThisNode.ControlWord | PP_StartBit) & ~PP_ChangeOnSetP;
+
+	if(immeditate)
+		newCW |= PP_ImmediateBit;
+	if(relative)
+		newCW |= PP_RelativeBit;
+
+	return newCW;
+}
+
+/*---------------------------------------------------------------------
+ * void PPStartSent(uint16_t StartCW, uint32_t TxDelay)
+ * The start CW of a preloaded move has been sent externally and will
+ * be on the wire completely after TxDelay ms.
+ * FinishMovePP() will wait for its response and the acknowledge.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDrive::PPStartSent(uint16_t StartCW, uint32_t TxDelay)
+{
+	ThisNode.CwSentExternally(StartCW, TxDelay);
+	CWAccessState = eCWWaiting;
+	AccessStep = 3;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates FinishMovePP(bool immeditate, bool relative)
+ * Second phase of a synchronised start: set the start bit if not already
+ * sent by PPStartSent(), wait for the acknowledge and clear the start bit.
+ *
  * --> will report eMCWaiting while busy
  * --> will report eMCDone when finished
+ * --> will report eMCError if no move has been preloaded
  * --> must be reset to eMCIdle after registering eMCDone
  *
- * Parameters are all supported homing modes of the drive.
- * 
- * 2020-11-22 AW Done
- * 2924-07-06 AW successfully tested based on WriteObject
+ * 2026-10-18 AW Done
  *--------------------------------------------------------------------*/
 
-DriveCommStates MCDrive::ConfigureHoming(int8_t method)
+DriveCommStates MCDrive::FinishMovePP(bool immeditate, bool relative)
 {
-	//set homing method
-	return WriteObject(0x6098, 0x00,(uint8_t)method);
+	if(AccessStep < 3)
+	{
+		if(!isPPPreloaded)
+		{
+			MCDriveRxTxState = eMCError;
+			return MCDriveRxTxState;
+		}
+		AccessStep = 3;
+	}
+	isPPPreloaded = false;
+	MCDriveRxTxState = eMCWaiting;
+
+	//the target isn't used anymore in step 3 and 4
+	return MovePP(0, immeditate, relative);
 }
 
 /*---------------------------------------------------------------------
- * DriveCommStates StartHoming()
- * Switch the drive to homing mode and start the pre-configured homing
- * method.
- * Uses an internal step sequence based on AccessStep.
- * No parameters required.
+ * uint32_t GetPPAckAt()
+ * time the acknowledge of the last PP start has been seen
  *
- * --> will report eMCWaiting while busy
- * --> will report eMCDone when finished
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint32_t MCDrive::GetPPAckAt()
+{
+	return PPAckAt;
+}
+
+/*---------------------------------------------------------------------
+ * bool PushPPTarget(int32_t TargetPos)
+ * Add a target to the queue of PP targets worked on by RunPPQueue().
+ * Can be called while the queue is running to refill it.
+ * --> false if the queue is full
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCDrive::PushPPTarget(int32_t TargetPos)
+{
+	if(PPQueueCount >= MCDrivePPQueueSize)
+		return false;
+
+	PPQueue[(PPQueueHead + PPQueueCount) % MCDrivePPQueueSize] = TargetPos;
+	PPQueueCount++;
+	return true;
+}
+
+uint8_t MCDrive::GetPPQueueFree()
+{
+	return MCDrivePPQueueSize - PPQueueCount;
+}
+
+void MCDrive::ClearPPQueue()
+{
+	PPQueueHead = 0;
+	PPQueueCount = 0;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates RunPPQueue(bool relative)
+ * Hand the queued targets to the drive using the set-of-setpoints
+ * handshake of PP: with PP_ChangeOnSetP set and without the immediate bit
+ * the drive buffers the next target and blends into it when reaching
+ * the actual one, without stopping in between.
+ * A target is handed over whenever StatusBit_PP_Ack is cleared, which
+ * indicates the drive's setpoint buffer is free again. So while one
+ * target is being moved to, the next one is waiting in the drive already.
+ *
+ * --> will report eMCWaiting while targets are queued
+ * --> will report eMCDone when all queued targets are handed over
  * --> must be reset to eMCIdle after registering eMCDone
  *
- * 2020-11-22 AW Done
- * 2024-07-06 AW tested as a whole
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW abort at an EMCY
  *--------------------------------------------------------------------*/
 
-DriveCommStates MCDrive::DoHoming(uint16_t timeout)
+DriveCommStates MCDrive::RunPPQueue(bool relative)
 {
+	uint16_t StatusWord = ThisNode.StatusWord;
 	uint16_t ControlWord = ThisNode.ControlWord;
 
-	//at the very beginning AccessStep has to be == 0
+	if(AbortOnFault())
+		return eMCError;
+
 	switch(AccessStep)
 	{
 		case 0:
-			//ensure StartBit == 0
-			//as soon as the CWAccessState == eCWDone we can proceed
-			if(CWAccessState == eCWDone)
+			//care for OpMode == 1
+			if(SDOAccessState == eSDODone)
 			{
 				ThisNode.ResetComState();
-				CWAccessState = eCWIdle;
+				SDOAccessState = eSDOIdle;
+				OpModeReported = 1;
 				AccessStep = 1;
-
-				#if(DEBUG_DRIVE & DEBUG_HOME)
-				std::printf("Drive: intial Force Bit4==0\n");
-				#endif
 			}
 			else
 			{
-				uint16_t newCW = ControlWord & ~PP_StartBit;
+				if(OpModeReported == 1)
+					AccessStep = 1;
+				else
+				{
+					OpModeRequested = 1;
+					SDOAccessState = ThisNode.WriteSDO(0x6060, 0x00,(uint32_t *)&OpModeRequested,1);
+				}
+			}
+			MCDriveRxTxState = eMCWaiting;
+			break;
+		case 1:
+			//wait for the setpoint buffer of the drive to be free
+			if(((StatusWord & StatusBit_PP_Ack) == 0) || (PPQueueCount == 0))
+			{
+				if( ((CWAccessState == eCWIdle) || (CWAccessState == eCWDone)) &&
+					(SDOAccessState == eSDOIdle))
+				{
+					ThisNode.ResetComState();
+					CWAccessState = eCWIdle;
+
+					if(PPQueueCount == 0)
+					{
+						MCDriveRxTxState = eMCDone;
+						AccessStep = 0;
+
+						#if(DEBUG_DRIVE & DEBUG_MOVEPP)
+						std::printf("Drive: PP queue empty\n");
+						#endif
+					}
+					else
+						AccessStep = 2;
+				}
+				else
+					CWAccessState = ThisNode.PullSW(PullSWCycleTime);
+			}
+			else
+				CWAccessState = ThisNode.PullSW(PullSWCycleTime);
+			break;
+		case 2:
+			//set the TPos
+			if(SDOAccessState == eSDODone)
+			{
+				ThisNode.ResetComState();
+				SDOAccessState = eSDOIdle;
+				AccessStep = 3;
+			}
+			else
+			{
+				#if(DEBUG_DRIVE & DEBUG_MOVEPP)
+				if(SDOAccessState == eSDOIdle)
+				{
+					std::printf("Drive: queued TPos %d\n", PPQueue[PPQueueHead]);
+				}
+				#endif
+
+				SDOAccessState = ThisNode.WriteSDO(0x607A, 0x00,(uint32_t *)&PPQueue[PPQueueHead],4);
+			}
+			break;
+		case 3:
+			//set StartBit with change on setpoint and wait for the acknowledge
+			if((StatusWord & StatusBit_PP_Ack) == StatusBit_PP_Ack)
+			{
+				if( ((CWAccessState == eCWIdle) || (CWAccessState == eCWDone)) &&
+					(SDOAccessState == eSDOIdle))
+				{
+					ThisNode.ResetComState();
+					CWAccessState = eCWIdle;
+					PPQueueHead = (PPQueueHead + 1) % MCDrivePPQueueSize;
+					PPQueueCount--;
+					AccessStep = 4;
+				}
+				else
+				{
+					CWAccessState = ThisNode.SendCw(ControlWord,MaxSWResponseDelay);
+				}
+			}
+			else
+			{
+				uint16_t newCW = (ControlWord | PP_StartBit | PP_ChangeOnSetP) & ~PP_ImmediateBit;
+
+				if(relative)
+					newCW |= PP_RelativeBit;
+				else
+					newCW &= ~PP_RelativeBit;
+
+				CWAccessState = ThisNode.SendCw(newCW,MaxSWResponseDelay);
+			}
+			break;
+		case 4:
+			//clear the StartBit again - the acknowledge is cleared by the
+			//drive as soon as it can take the next target
+			if(CWAccessState == eCWDone)
+			{
+				ThisNode.ResetComState();
+				CWAccessState = eCWIdle;
+				AccessStep = 1;
+			}
+			else
+			{
+				uint16_t newCW = ControlWord & ~PP_StartBit;
+
+				//no SW response required - 0 will avoid polling
+				CWAccessState = ThisNode.SendCw(newCW,0);
+			}
+			break;
+	}
+	//always check whether a SDO is stuck final 
+	return CheckComState();
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates FastMovePP(int32_t TargetPos, bool immeditate, bool relative)
+ * Start a PP move with the fewest frames possible if the drive is known
+ * to be ready for it: in PP already, start bit cleared and no pending
+ * acknowledge. Only the target is written and the start bit is set and
+ * cleared again. The acknowledge is taken from the SW which is pushed
+ * by the drive in SW push mode; otherwise it is pulled.
+ * Clearing the start bit is not waited on for the acknowledge to drop.
+ * If the drive isn't known to be ready, the full MovePP is used.
+ *
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when finished
+ * --> must be reset to eMCIdle after registering eMCDone
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW abort at an EMCY
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::FastMovePP(int32_t TargetPos, bool immeditate, bool relative)
+{
+	uint16_t StatusWord = ThisNode.StatusWord;
+	uint16_t ControlWord = ThisNode.ControlWord;
+
+	if((AccessStep == 0) && !isFastFallback && !isMoveStatsActive)
+	{
+		isFastFallback = (OpModeReported != 1) ||
+			((ControlWord & PP_StartBit) != 0) ||
+			((StatusWord & StatusBit_PP_Ack) != 0);
+
+		#if(DEBUG_DRIVE & DEBUG_MOVEPP)
+		if(isFastFallback)
+			std::printf("Drive: fast PP not possible\n");
+		#endif
+	}
+
+	BeginMoveStats(!isFastFallback);
+
+	if(AbortOnFault())
+		return EndMoveStats(eMCError);
+
+	if(isFastFallback)
+	{
+		DriveCommStates State = EndMoveStats(MovePP(TargetPos, immeditate, relative));
+
+		if(State != eMCWaiting)
+			isFastFallback = false;
+		return State;
+	}
+
+	switch(AccessStep)
+	{
+		case 0:
+			//set the TPos
+			if(SDOAccessState == eSDODone)
+			{
+				ThisNode.ResetComState();
+				SDOAccessState = eSDOIdle;
+				AccessStep = 1;
+			}
+			else
+				SDOAccessState = ThisNode.WriteSDO(0x607A, 0x00,(uint32_t *)&TargetPos,4);
+			MCDriveRxTxState = eMCWaiting;
+			break;
+		case 1:
+			//set StartBit and wait for the acknowledge
+			if((StatusWord & StatusBit_PP_Ack) == StatusBit_PP_Ack)
+			{
+				if( ((CWAccessState == eCWIdle) || (CWAccessState == eCWDone)) &&
+					(SDOAccessState == eSDOIdle))
+				{
+					ThisNode.ResetComState();
+					CWAccessState = eCWIdle;
+					AccessStep = 2;
+					PPAckAt = actTime;
+				}
+				else
+					CWAccessState = ThisNode.SendCw(ControlWord,MaxSWResponseDelay);
+			}
+			else
+				CWAccessState = ThisNode.SendCw(GetPPStartCW(immeditate, relative),MaxSWResponseDelay);
+			break;
+		case 2:
+			//clear the StartBit again without waiting for the SW
+			if(CWAccessState == eCWDone)
+			{
+				ThisNode.ResetComState();
+				CWAccessState = eCWIdle;
+				MCDriveRxTxState = eMCDone;
+				AccessStep = 0;
+
+				#if(DEBUG_DRIVE & DEBUG_MOVEPP)
+				std::printf("Drive: fast PP started\n");
+				#endif
+			}
+			else
+				CWAccessState = ThisNode.SendCw(ControlWord & ~(PP_StartBit | PP_ImmediateBit | PP_RelativeBit),0);
+			break;
+	}
+	//always check whether a SDO is stuck final 
+	return EndMoveStats(CheckComState());
+}
+
+/*---------------------------------------------------------------------
+ * void GetLastMoveStats(MCMoveStats *Stats)
+ * frames and time of the last finished PP move start.
+ * The frames are counted at the MsgHandler, so any other traffic on the
+ * bus in the meantime is included.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDrive::GetLastMoveStats(MCMoveStats *Stats)
+{
+	*Stats = LastMove;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates MoveAtSpeed(int32_t RefSpeed)
+ * Switch the drive to PV mode and move at the given speed.
+ * Parameter:
+ * RefSpeed: speed given in the units scaled by the FactorGroup (default: 1/min (rpm))
+ *
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when finished
+ * --> must be reset to eMCIdle after registering eMCDone
+ *
+ * 2020-11-22 AW Done
+ * 2024-07-06 AW successfully tested based on SetOpMode and WriteObject
+ * 2026-10-18 AW OpMode and speed written as a batch
+ * 2026-10-18 AW OpMode skipped if PV already
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::MoveAtSpeed(int32_t RefSpeed)
+{
+	
+	switch(AccessStep)
+	{
+		case 0:
+			OpModeRequested = 3;
+			isSpeedSent = false;
+			//the OpMode is written only if not known to be PV already
+			if(OpModeReported == 3)
+				SetBatchEntry(0, eSdoWriteReq, 0x60FF, 0x00, 4, (uint32_t)RefSpeed);
+			else
+			{
+				SetBatchEntry(0, eSdoWriteReq, 0x6060, 0x00, 1, (uint8_t)OpModeRequested);
+				SetBatchEntry(1, eSdoWriteReq, 0x60FF, 0x00, 4, (uint32_t)RefSpeed);
+			}
+			AccessStep = 1;
+			[[fallthrough]];
+		case 1:		  
+			if(RunBatch((Batch[0].Idx == 0x6060) ? 2 : 1) == eMCDone)
+			{	
+				OpModeReported = 3;
+				AccessStep = 0;
+				#if(DEBUG_DRIVE & DEBUG_MoveSpeed)
+				std::printf("Drive: OpMode + TSpeed set\n");
+				#endif
+			}
+			break;
+	}					
+	//always check whether a SDO is stuck final 
+	return CheckComState();				
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates StreamSpeed(int32_t RefSpeed, uint32_t MinInterval)
+ * Update the speed in PV mode at a high rate, e.g. from a joystick.
+ * The OpMode is written only once, as long as OpModeReported is 3.
+ * Then each call writes 0x60FF only - and only if RefSpeed differs from
+ * the value last written and at least MinInterval ms have passed since.
+ * So each speed update costs a single SDO write.
+ * Other than most calls this one doesn't need a reset after eMCDone, so
+ * it can simply be called each cycle. AccessStep is back at 0 whenever
+ * no write is on its way, so any other sequence can follow directly.
+ *
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when the speed is set or unchanged
+ * --> will report eMCBusy while a changed speed is held back by MinInterval
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW AccessStep reset with eMCDone and eMCBusy
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::StreamSpeed(int32_t RefSpeed, uint32_t MinInterval)
+{
+	if((MCDriveRxTxState == eMCDone) || (MCDriveRxTxState == eMCBusy))
+		MCDriveRxTxState = eMCIdle;
+
+	switch(AccessStep)
+	{
+		case 0:
+			if(OpModeReported != 3)
+			{
+				isSpeedSent = false;
+				if(SetOpMode(3) == eMCDone)
+				{
+					ThisNode.ResetComState();
+					SDOAccessState = eSDOIdle;
+					MCDriveRxTxState = eMCWaiting;
+					AccessStep = 1;
+
+					#if(DEBUG_DRIVE & DEBUG_MoveSpeed)
+					std::printf("Drive: OpMode 3 for streaming\n");
+					#endif
+				}
+				break;
+			}
+			AccessStep = 1;
+			[[fallthrough]];
+		case 1:
+			if(SDOAccessState == eSDOIdle)
+			{
+				if(isSpeedSent && (RefSpeed == SpeedSent))
+				{
+					MCDriveRxTxState = eMCDone;
+					AccessStep = 0;
+					break;
+				}
+				if(isSpeedSent && ((actTime - SpeedSentAt) < MinInterval))
+				{
+					MCDriveRxTxState = eMCBusy;
+					AccessStep = 0;
+					break;
+				}
+				SpeedRequested = RefSpeed;
+			}
+
+			if(SDOAccessState == eSDODone)
+			{
+				ThisNode.ResetComState();
+				SDOAccessState = eSDOIdle;
+				SpeedSent = SpeedRequested;
+				SpeedSentAt = actTime;
+				isSpeedSent = true;
+				MCDriveRxTxState = eMCDone;
+				AccessStep = 0;
+
+				#if(DEBUG_DRIVE & DEBUG_MoveSpeed)
+				std::printf("Drive: TSpeed %d\n", SpeedSent);
+				#endif
+			}
+			else
+			{
+				SDOAccessState = ThisNode.WriteSDO(0x60FF, 0x00,(uint32_t *)&SpeedRequested,4);
+				MCDriveRxTxState = eMCWaiting;
+			}
+			break;
+	}
+	//always check whether a SDO is stuck final 
+	return CheckComState();
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates SetCyclicMode(int8_t OpMode, uint8_t PeriodMs)
+ * Switch the drive to one of the cyclic synchronous modes
+ * CSP (8) or CSV (9) and set the interpolation period 0x60C2 to the
+ * period the setpoints will be sent with.
+ * The drive has to be enabled afterwards if not already.
+ *
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when finished
+ * --> will report eMCError for any other OpMode
+ * --> needs to be reset to eMCIdle after having registered the eMCDone
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::SetCyclicMode(int8_t OpMode, uint8_t PeriodMs)
+{
+	switch(AccessStep)
+	{
+		case 0:
+			if((OpMode != 8) && (OpMode != 9))
+			{
+				MCDriveRxTxState = eMCError;
+				return MCDriveRxTxState;
+			}
+			OpModeRequested = OpMode;
+			//period given as value * 10^exponent s
+			SetBatchEntry(0, eSdoWriteReq, 0x60C2, 0x01, 1, PeriodMs);
+			SetBatchEntry(1, eSdoWriteReq, 0x60C2, 0x02, 1, (uint8_t)(-3));
+			SetBatchEntry(2, eSdoWriteReq, 0x6060, 0x00, 1, (uint8_t)OpModeRequested);
+			AccessStep = 1;
+			[[fallthrough]];
+		case 1:
+			if(RunBatch(3) == eMCDone)
+			{
+				OpModeReported = OpModeRequested;
+				AccessStep = 0;
+
+				#if(DEBUG_DRIVE & DEBUG_RWPARAM)
+				std::printf("Drive: cyclic mode %d at %u ms\n", OpModeRequested, PeriodMs);
+				#endif
+			}
+			break;
+	}
+	//always check whether a SDO is stuck final 
+	return CheckComState();
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates ConfigureHoming(int8_t method)
+ * Set the requested homing method by writing via SDO to 0x6098.00.
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when finished
+ * --> must be reset to eMCIdle after registering eMCDone
+ *
+ * Parameters are all supported homing modes of the drive.
+ * 
+ * 2020-11-22 AW Done
+ * 2924-07-06 AW successfully tested based on WriteObject
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::ConfigureHoming(int8_t method)
+{
+	//set homing method
+	return WriteObject(0x6098, 0x00,(uint8_t)method);
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates StartHoming()
+ * Switch the drive to homing mode and start the pre-configured homing
+ * method.
+ * Uses an internal step sequence based on AccessStep.
+ * No parameters required.
+ *
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when finished
+ * --> must be reset to eMCIdle after registering eMCDone
+ *
+ * 2020-11-22 AW Done
+ * 2024-07-06 AW tested as a whole
+ * 2026-10-18 AW abort at an EMCY
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::DoHoming(uint16_t timeout)
+{
+	uint16_t ControlWord = ThisNode.ControlWord;
+
+	if(AbortOnFault())
+		return eMCError;
+
+	//at the very beginning AccessStep has to be == 0
+	switch(AccessStep)
+	{
+		case 0:
+			//ensure StartBit == 0
+			//as soon as the CWAccessState == eCWDone we can proceed
+			if(CWAccessState == eCWDone)
+			{
+				ThisNode.ResetComState();
+				CWAccessState = eCWIdle;
+				AccessStep = 1;
+
+				#if(DEBUG_DRIVE & DEBUG_HOME)
+				std::printf("Drive: intial Force Bit4==0\n");
+				#endif
+			}
+			else
+			{
+				uint16_t newCW = ControlWord & ~PP_StartBit;
 				
 				#if(DEBUG_DRIVE & DEBUG_HOME)
 				if((CWAccessState == eCWIdle) || (CWAccessState == eCWRetry))
@@ -1272,6 +1953,133 @@ uint16_t MCDrive::GetLastError()
 	return ThisNode.GetLastError();
 }
 
+/*---------------------------------------------------------------------
+ * void SetDesiredOpMode(int8_t OpMode)
+ * void SetDesiredProfile(uint32_t ACC, uint32_t DEC, uint32_t Speed, int16_t Type)
+ * void SetDesiredHoming(int8_t method)
+ * bool AddDesiredParam(uint16_t idx, uint8_t subIdx, uint8_t len, uint32_t value)
+ * void ClearDesiredConfig()
+ * The configuration the drive is expected to run with. It is written
+ * again whenever a boot Msg of the drive is received. Nothing is sent
+ * by these calls themselves.
+ * An OpMode of 0 is not restored. AddDesiredParam() fails if all
+ * MCDriveMaxDesiredParams are used already.
+ * 
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDrive::SetDesiredOpMode(int8_t OpMode)
+{
+	DesiredOpMode = OpMode;
+}
+
+void MCDrive::SetDesiredProfile(uint32_t ProfileACC, uint32_t ProfileDEC, uint32_t ProfileSpeed, int16_t ProfileType)
+{
+	DesiredProfile[0] = ProfileACC;
+	DesiredProfile[1] = ProfileDEC;
+	DesiredProfile[2] = ProfileSpeed;
+	DesiredProfileType = ProfileType;
+	hasDesiredProfile = true;
+}
+
+void MCDrive::SetDesiredHoming(int8_t method)
+{
+	DesiredHoming = method;
+	hasDesiredHoming = true;
+}
+
+bool MCDrive::AddDesiredParam(uint16_t idx, uint8_t subIdx, uint8_t len, uint32_t value)
+{
+	if(DesiredParamCount >= MCDriveMaxDesiredParams)
+		return false;
+
+	DesiredParams[DesiredParamCount].Cmd = eSdoWriteReq;
+	DesiredParams[DesiredParamCount].Idx = idx;
+	DesiredParams[DesiredParamCount].SubIdx = subIdx;
+	DesiredParams[DesiredParamCount].Len = len;
+	DesiredParams[DesiredParamCount].Value = value;
+	DesiredParamCount++;
+
+	return true;
+}
+
+void MCDrive::ClearDesiredConfig()
+{
+	DesiredOpMode = 0;
+	hasDesiredProfile = false;
+	hasDesiredHoming = false;
+	DesiredParamCount = 0;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates GetRestoreState()
+ * State of restoring the desired configuration after the last boot:
+ * --> eMCIdle if no boot has been seen or nothing is to be restored
+ * --> eMCWaiting while the configuration is written
+ * --> eMCDone when the drive is configured again
+ * --> eMCError/eMCTimeout if a write failed
+ * 
+ * uint32_t GetRestoreLatency()
+ * time in ms from the boot Msg or the start of ConfigureDrive() to the
+ * drive being configured
+ * 
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::GetRestoreState()
+{
+	return RestoreState;
+}
+
+uint32_t MCDrive::GetRestoreLatency()
+{
+	return RestoreLatency;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates ConfigureDrive()
+ * Write the desired configuration now, e.g. when bringing up the drive,
+ * as a single batch the same way it is restored after a boot. If the
+ * restore after a boot is running already, it is waited for instead.
+ *
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when finished or if nothing is to be written
+ * --> will report eMCError/eMCTimeout if a write failed
+ * --> needs to be reset to eMCIdle after having registered the eMCDone
+ * 
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::ConfigureDrive()
+{
+	switch(AccessStep)
+	{
+		case 0:
+			if(RestoreState != eMCWaiting)
+				BuildRestore(actTime);
+			if(RestoreState == eMCIdle)
+			{
+				MCDriveRxTxState = eMCDone;
+				break;
+			}
+			MCDriveRxTxState = eMCWaiting;
+			AccessStep = 1;
+			break;
+		case 1:
+			if(RestoreState != eMCWaiting)
+			{
+				MCDriveRxTxState = RestoreState;
+				AccessStep = 0;
+
+				#if(DEBUG_DRIVE & DEBUG_RESTORE)
+				std::printf("Drive: configured in %u ms\n", RestoreLatency);
+				#endif
+			}
+			break;
+	}
+	return MCDriveRxTxState;
+}
+
 //-------------------------------------------------------------------
 //---- private functions --------
 //-------------------------------------------------------------------
@@ -1295,6 +2103,8 @@ void MCDrive::OnTimeOut()
  * DriveCommStates Wait4Status(uint16_t mask, uint16_t CycleTime)
  * Check the StatusWord for the given pattern.
  * Returns eMCDone when the pattern is found; otherwise continues updating.
+ * In SW push mode the pushed SWs are waited for and CycleTime is replaced
+ * by the watchdog time of the node.
  * --> will report eMCWaiting while busy
  * --> will report eMCDone when finished
  * --> must be reset to eMCIdle after registering eMCDone
@@ -1338,6 +2148,101 @@ DriveCommStates MCDrive::Wait4Status(uint16_t mask, uint16_t CycleTime)
 	return CheckComState();					
 }
 
+/*---------------------------------------------------------------------
+ * void BeginMoveStats(bool isFast)
+ * DriveCommStates EndMoveStats(DriveCommStates State)
+ * Record the frame counters and the time with the first call of a move
+ * and the difference when the move is finished.
+ * 
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDrive::BeginMoveStats(bool isFast)
+{
+	if(isMoveStatsActive || (Handler == NULL))
+		return;
+
+	Handler->GetFrameCounts(&MoveStartCounts);
+	MoveStartedAt = actTime;
+	isMoveFast = isFast;
+	isMoveStatsActive = true;
+}
+
+DriveCommStates MCDrive::EndMoveStats(DriveCommStates State)
+{
+	if(isMoveStatsActive && (State != eMCWaiting) && (State != eMCIdle))
+	{
+		MCFrameCounts Now;
+		uint32_t BaudRate = Handler->GetBaudRate();
+
+		Handler->GetFrameCounts(&Now);
+		LastMove.TxFrames = Now.TxFrames - MoveStartCounts.TxFrames;
+		LastMove.RxFrames = Now.RxFrames - MoveStartCounts.RxFrames;
+		LastMove.WireUs = (uint32_t)(((uint64_t)(Now.TxBytes - MoveStartCounts.TxBytes +
+			Now.RxBytes - MoveStartCounts.RxBytes) * 10 * 1000000) / BaudRate);
+		LastMove.DurationMs = actTime - MoveStartedAt;
+		LastMove.isFastPath = isMoveFast;
+		isMoveStatsActive = false;
+
+		#if(DEBUG_DRIVE & DEBUG_MOVEPP)
+		std::printf("Drive: move %u/%u frames %u us on the wire\n", LastMove.TxFrames, LastMove.RxFrames, LastMove.WireUs);
+		#endif
+	}
+	return State;
+}
+
+/*---------------------------------------------------------------------
+ * void SetBatchEntry(uint8_t i, MCMsgCommands Cmd, uint16_t Idx, uint8_t SubIdx, uint8_t Len, uint32_t Value)
+ * Fill a single entry of the batch of this drive.
+ * 
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDrive::SetBatchEntry(uint8_t i, MCMsgCommands Cmd, uint16_t Idx, uint8_t SubIdx, uint8_t Len, uint32_t Value)
+{
+	Batch[i].Cmd = Cmd;
+	Batch[i].Idx = Idx;
+	Batch[i].SubIdx = SubIdx;
+	Batch[i].Len = Len;
+	Batch[i].Value = Value;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates RunBatch(uint8_t count)
+ * Work on the first count entries of the batch of this drive.
+ * The whole chain is handed over to the SDOHandler at once, which
+ * streams the requests as fast as the responses arrive and stops at
+ * the first failing one.
+ * The SDOHandler reports the end of the batch to this drive only and
+ * has released the channel already, so there is nothing to reset.
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when finished
+ * --> will report eMCError/eMCTimeout if a request failed
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW end of the batch taken from the SDOHandler directly
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDrive::RunBatch(uint8_t count)
+{
+	switch(ThisNode.RunBatch(Batch, count))
+	{
+		case eSDODone:
+			MCDriveRxTxState = eMCDone;
+			break;
+		case eSDOError:
+			MCDriveRxTxState = eMCError;
+			break;
+		case eSDOTimeout:
+			MCDriveRxTxState = eMCTimeout;
+			break;
+		default:
+			MCDriveRxTxState = eMCWaiting;
+			break;
+	}
+	return CheckComState();
+}
+
 /*---------------------------------------------------------------------
  * DriveCommStates MovePP(int32_t TargetPos, bool immeditate, bool relative)
  * Internal function to start either an absolute or relative move in PP mode.
@@ -1349,6 +2254,8 @@ DriveCommStates MCDrive::Wait4Status(uint16_t mask, uint16_t CycleTime)
  * --> must be reset to eMCIdle after registering eMCDone
  *
  * 2020-11-22 AW Done
+ * 2026-10-18 AW clear PP_ChangeOnSetP left by RunPPQueue()
+ * 2026-10-18 AW abort at an EMCY
  *--------------------------------------------------------------------*/
 
 DriveCommStates MCDrive::MovePP(int32_t TargetPos, bool immeditate, bool relative)
@@ -1356,6 +2263,9 @@ DriveCommStates MCDrive::MovePP(int32_t TargetPos, bool immeditate, bool relativ
 	uint16_t StatusWord = ThisNode.StatusWord;
 	uint16_t ControlWord = ThisNode.ControlWord;
 
+	if(AbortOnFault())
+		return eMCError;
+
 	switch(AccessStep)
 	{
 		case 0:
@@ -1467,6 +2377,7 @@ DriveCommStates MCDrive::MovePP(int32_t TargetPos, bool immeditate, bool relativ
 					ThisNode.ResetComState();
 					CWAccessState = eCWIdle;
 					AccessStep = 4;
+					PPAckAt = actTime;
 					
 					#if(DEBUG_DRIVE & DEBUG_MOVEPP)
 					std::printf("Drive: PP Started\n");
@@ -1479,7 +2390,8 @@ DriveCommStates MCDrive::MovePP(int32_t TargetPos, bool immeditate, bool relativ
 			}
 			else
 			{
-				uint16_t newCW = ControlWord | PP_StartBit;
+				//a single move is never blended into a queued one
+				uint16_t newCW = (ControlWord | PP_StartBit) & ~PP_ChangeOnSetP;
 				
 				if(immeditate)
 					newCW |= PP_ImmediateBit;
@@ -1537,3 +2449,160 @@ DriveCommStates MCDrive::MovePP(int32_t TargetPos, bool immeditate, bool relativ
 	//always check whether a SDO is stuck final 
 	return CheckComState();				
 }
+
+/*---------------------------------------------------------------------
+ * bool AbortOnFault()
+ * Stop a running sequence as soon as the node has received an EMCY
+ * instead of waiting for the next SW to report the fault.
+ * The sequence is left with AccessStep 0 and eMCError.
+ * --> true if the sequence has to be aborted
+ * 
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCDrive::AbortOnFault()
+{
+	if(!ThisNode.IsFaultPending())
+		return false;
+
+	#if(DEBUG_DRIVE & DEBUG_ERROR)
+	std::printf("Drive: abort at EMCY %X\n", ThisNode.GetLastError());
+	#endif
+
+	ThisNode.ResetComState();
+	CWAccessState = eCWIdle;
+	SDOAccessState = eSDOIdle;
+	AccessStep = 0;
+	MCDriveRxTxState = eMCError;
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void OnBoot()
+ * The drive has booted and lost everything not stored in its flash.
+ * A running sequence is stopped, as the node has been reset already.
+ * The desired configuration is collected into a single batch, which
+ * is sent back to back by RunRestore() without waiting for a cycle
+ * of the caller between the requests. Custom parameters go first and
+ * the OpMode last.
+ * A boot expected by SendReset() doesn't stop its sequence.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW boot expected by SendReset()
+ *--------------------------------------------------------------------*/
+
+void MCDrive::OnBoot()
+{
+	#if(DEBUG_DRIVE & DEBUG_RESTORE)
+	std::printf("Drive: boot detected\n");
+	#endif
+
+	if(isBootExpected)
+		isBootExpected = false;
+	else
+	{
+		if((AccessStep != 0) || (MCDriveRxTxState == eMCWaiting))
+			MCDriveRxTxState = eMCError;
+		AccessStep = 0;
+		SDOAccessState = eSDOIdle;
+		CWAccessState = eCWIdle;
+		isFastFallback = false;
+		isMoveStatsActive = false;
+	}
+
+	//what has been known about the drive is gone
+	OpModeReported = 0;
+	isSpeedSent = false;
+	isPPPreloaded = false;
+
+	BuildRestore(ThisNode.GetBootAt());
+}
+
+/*---------------------------------------------------------------------
+ * void BuildRestore(uint32_t StartedAt)
+ * Collect the desired configuration into the restore batch and let
+ * RunRestore() send it. StartedAt is the reference of the latency.
+ * A restore still running is stopped first, as its entries are
+ * overwritten.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW stops a running restore
+ *--------------------------------------------------------------------*/
+
+void MCDrive::BuildRestore(uint32_t StartedAt)
+{
+	ThisNode.CancelBatch(RestoreBatch);
+
+	RestoreCount = 0;
+	for(uint8_t i = 0; i < DesiredParamCount; i++)
+		RestoreBatch[RestoreCount++] = DesiredParams[i];
+
+	if(hasDesiredProfile)
+	{
+		SDOBatchEntry Profile[4] = {
+			{eSdoWriteReq, 0x6083, 0x00, 4, DesiredProfile[0]},
+			{eSdoWriteReq, 0x6084, 0x00, 4, DesiredProfile[1]},
+			{eSdoWriteReq, 0x6081, 0x00, 4, DesiredProfile[2]},
+			{eSdoWriteReq, 0x6086, 0x00, 2, (uint16_t)DesiredProfileType}};
+
+		for(uint8_t i = 0; i < 4; i++)
+			RestoreBatch[RestoreCount++] = Profile[i];
+	}
+	if(hasDesiredHoming)
+		RestoreBatch[RestoreCount++] = {eSdoWriteReq, 0x6098, 0x00, 1, (uint8_t)DesiredHoming};
+	if(DesiredOpMode != 0)
+		RestoreBatch[RestoreCount++] = {eSdoWriteReq, 0x6060, 0x00, 1, (uint8_t)DesiredOpMode};
+
+	RestoreLatency = 0;
+	RestoreStartedAt = StartedAt;
+	RestoreState = (RestoreCount > 0) ? eMCWaiting : eMCIdle;
+}
+
+/*---------------------------------------------------------------------
+ * void RunRestore()
+ * Work on the restore batch with each SetActTime(). The restore is a
+ * sequence of its own: its first call reserves the SDO channel, so a
+ * request of a sequence of the caller on its way is finished first,
+ * and no further one is started until the restore has ended. Meanwhile
+ * the sequences see the channel busy and report eMCWaiting. The end is
+ * reported to the restore only and the channel released by the
+ * SDOHandler, so nothing of the caller is reset here. A ResetComState()
+ * of the drive doesn't stop it.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW owns the channel, resets nothing of the caller
+ *--------------------------------------------------------------------*/
+
+void MCDrive::RunRestore()
+{
+	switch(ThisNode.RunBatch(RestoreBatch, RestoreCount))
+	{
+		case eSDODone:
+			if(DesiredOpMode != 0)
+				OpModeReported = DesiredOpMode;
+			RestoreLatency = actTime - RestoreStartedAt;
+			RestoreState = eMCDone;
+
+			#if(DEBUG_DRIVE & DEBUG_RESTORE)
+			std::printf("Drive: configuration restored after %u ms\n", RestoreLatency);
+			#endif
+			break;
+		case eSDOError:
+			RestoreState = eMCError;
+
+			#if(DEBUG_DRIVE & DEBUG_ERROR)
+			std::printf("Drive: restore failed\n");
+			#endif
+			break;
+		case eSDOTimeout:
+			RestoreState = eMCTimeout;
+
+			#if(DEBUG_DRIVE & DEBUG_ERROR)
+			std::printf("Drive: restore timed out\n");
+			#endif
+			break;
+		default:
+			break;
+	}
+}
@@ -0,0 +1,585 @@
+/*---------------------------------------------------
+ * MCDriveGroup.cpp
+ * implements the class to run the step sequences of
+ * several drives concurrently
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cstdio>
+#include "faulhaber/MCDriveGroup.h"
+
+//--- local defines ---
+
+#define DEBUG_START		0x0001
+#define DEBUG_DONE		0x0002
+#define DEBUG_ERROR		0x0004
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_GROUP 0
+#else
+#define DEBUG_GROUP (DEBUG_ERROR)
+#endif
+
+//--- public functions ---
+
+/*---------------------------------------------------------------------
+ * MCDriveGroup()
+ * an empty group
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+MCDriveGroup::MCDriveGroup()
+{
+	for(uint8_t i = 0; i < MCGroupMaxDrives; i++)
+	{
+		Drives[i] = NULL;
+		DriveState[i] = eMCIdle;
+		DriveDoneAt[i] = 0;
+		Targets[i] = 0;
+	}
+	for(uint8_t i = 0; i < 3; i++)
+		ProfileArg[i] = 0;
+}
+
+/*---------------------------------------------------------------------
+ * void Connect2MsgHandler(MsgHandler *ThisHandler)
+ * the MsgHandler all drives of the group are connected to.
+ * Needed for the synchronised start only.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveGroup::Connect2MsgHandler(MsgHandler *ThisHandler)
+{
+	Handler = ThisHandler;
+}
+
+/*---------------------------------------------------------------------
+ * bool AddDrive(MCDrive *Drive)
+ * Add an already connected drive to the group.
+ * The order of adding is the order of the targets in StartAbsMoves().
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCDriveGroup::AddDrive(MCDrive *Drive)
+{
+	if((Drive == NULL) || (Count >= MCGroupMaxDrives))
+		return false;
+
+	Drives[Count] = Drive;
+	Count++;
+	return true;
+}
+
+uint8_t MCDriveGroup::GetCount()
+{
+	return Count;
+}
+
+MCDrive *MCDriveGroup::GetDrive(uint8_t i)
+{
+	return (i < Count) ? Drives[i] : NULL;
+}
+
+/*---------------------------------------------------------------------
+ * void SetActTime(uint32_t time)
+ * forward the actual time to all drives of the group
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveGroup::SetActTime(uint32_t time)
+{
+	actTime = time;
+	for(uint8_t i = 0; i < Count; i++)
+		Drives[i]->SetActTime(time);
+}
+
+/*---------------------------------------------------------------------
+ * void ResetComState()
+ * abort any running group sequence and reset all drives
+ * The lock of a start burst is released.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW releases the lock of a burst
+ *--------------------------------------------------------------------*/
+
+void MCDriveGroup::ResetComState()
+{
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		Drives[i]->ResetComState();
+		DriveState[i] = eMCIdle;
+	}
+	ActOp = eGroupNone;
+	ReleaseBurst(true);
+}
+
+/*---------------------------------------------------------------------
+ * group versions of the MCDrive calls
+ * all of them have to be called cyclically until they report
+ * eMCDone, eMCError or eMCTimeout
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDriveGroup::ResetDrives()
+{
+	return Run(eGroupReset);
+}
+
+DriveCommStates MCDriveGroup::ConfigureDrives()
+{
+	return Run(eGroupConfigure);
+}
+
+DriveCommStates MCDriveGroup::EnableDrives()
+{
+	return Run(eGroupEnable);
+}
+
+DriveCommStates MCDriveGroup::DisableDrives()
+{
+	return Run(eGroupDisable);
+}
+
+DriveCommStates MCDriveGroup::StopDrives()
+{
+	return Run(eGroupStop);
+}
+
+DriveCommStates MCDriveGroup::SetProfiles(uint32_t ProfileACC, uint32_t ProfileDEC, uint32_t ProfileSpeed, int16_t Type)
+{
+	if(ActOp != eGroupSetProfile)
+	{
+		ProfileArg[0] = ProfileACC;
+		ProfileArg[1] = ProfileDEC;
+		ProfileArg[2] = ProfileSpeed;
+		ProfileType = Type;
+	}
+	return Run(eGroupSetProfile);
+}
+
+//one target per drive in the order the drives have been added
+DriveCommStates MCDriveGroup::StartAbsMoves(const int32_t *TargetPos, bool immediate)
+{
+	if(ActOp != eGroupAbsMove)
+	{
+		for(uint8_t i = 0; i < Count; i++)
+			Targets[i] = TargetPos[i];
+		isImmediate = immediate;
+	}
+	return Run(eGroupAbsMove);
+}
+
+DriveCommStates MCDriveGroup::StartRelMoves(const int32_t *Distance, bool immediate)
+{
+	if(ActOp != eGroupRelMove)
+	{
+		for(uint8_t i = 0; i < Count; i++)
+			Targets[i] = Distance[i];
+		isImmediate = immediate;
+	}
+	return Run(eGroupRelMove);
+}
+
+DriveCommStates MCDriveGroup::AreInPos()
+{
+	return Run(eGroupInPos);
+}
+
+DriveCommStates MCDriveGroup::ConfigureHoming(int8_t method)
+{
+	if(ActOp != eGroupConfigureHoming)
+		HomingMethod = method;
+	return Run(eGroupConfigureHoming);
+}
+
+DriveCommStates MCDriveGroup::DoHoming(uint16_t timeout)
+{
+	if(ActOp != eGroupHoming)
+		HomingTimeout = timeout;
+	return Run(eGroupHoming);
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates PreloadAbsMoves(const int32_t *TargetPos)
+ * first phase of a synchronised start: one target per drive is written
+ * but the moves are not started
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDriveGroup::PreloadAbsMoves(const int32_t *TargetPos)
+{
+	if(ActOp != eGroupPreload)
+	{
+		for(uint8_t i = 0; i < Count; i++)
+			Targets[i] = TargetPos[i];
+	}
+	return Run(eGroupPreload);
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates StartPreloaded(bool immediate, bool relative)
+ * second phase of a synchronised start: the start CWs of all drives
+ * are sent back-to-back in a single write as soon as the bus is free.
+ * The bus stays locked until the response of each of them is in or
+ * has timed out, so no other request is answered in between.
+ * Then the acknowledge of each drive is awaited and the start bits are
+ * cleared again.
+ * When done GetStartSkewUs() and GetAckSpread() report the skew.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW bus locked for all CW responses of the burst
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDriveGroup::StartPreloaded(bool immediate, bool relative)
+{
+	DriveCommStates State;
+
+	if(ActOp != eGroupFinishPP)
+	{
+		State = SendStartBurst(immediate, relative);
+		if(State == eMCBusy)
+			return eMCWaiting;
+		if(State != eMCDone)
+			return State;
+
+		isImmediate = immediate;
+		isRelative = relative;
+	}
+
+	State = Run(eGroupFinishPP);
+	ReleaseBurst(State != eMCWaiting);
+
+	if(State == eMCDone)
+	{
+		uint32_t First = Drives[0]->GetPPAckAt();
+		uint32_t Last = First;
+
+		for(uint8_t i = 1; i < Count; i++)
+		{
+			uint32_t AckAt = Drives[i]->GetPPAckAt();
+
+			if((int32_t)(AckAt - First) < 0)
+				First = AckAt;
+			if((int32_t)(AckAt - Last) > 0)
+				Last = AckAt;
+		}
+		AckSpread = Last - First;
+
+		#if(DEBUG_GROUP & DEBUG_DONE)
+		std::printf("Group: start skew %u us on the wire, acks within %u ms\n", StartSkewUs, AckSpread);
+		#endif
+	}
+	return State;
+}
+
+/*---------------------------------------------------------------------
+ * uint32_t GetStartSkewUs()
+ * time in us between the end of the first and the end of the last
+ * start CW of the last burst. That's the skew given by the wire.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint32_t MCDriveGroup::GetStartSkewUs()
+{
+	return StartSkewUs;
+}
+
+/*---------------------------------------------------------------------
+ * uint32_t GetAckSpread()
+ * time in ms between the first and the last acknowledge of the last
+ * synchronised start as seen by the host. Includes the delay of the
+ * SW reporting, so it's an upper bound of the skew.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint32_t MCDriveGroup::GetAckSpread()
+{
+	return AckSpread;
+}
+
+/*---------------------------------------------------------------------
+ * uint8_t GetFailedDrive()
+ * index of the drive which made the last group sequence fail
+ * or MCGroupNone
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint8_t MCDriveGroup::GetFailedDrive()
+{
+	return FailedDrive;
+}
+
+DriveCommStates MCDriveGroup::GetDriveState(uint8_t i)
+{
+	return (i < Count) ? DriveState[i] : eMCIdle;
+}
+
+/*---------------------------------------------------------------------
+ * uint32_t GetDuration()
+ * time in ms the last finished group sequence took
+ * GetDriveDuration() is the time the single drive took within that.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint32_t MCDriveGroup::GetDuration()
+{
+	return FinishedAt - StartedAt;
+}
+
+uint32_t MCDriveGroup::GetDriveDuration(uint8_t i)
+{
+	if((i < Count) && (DriveState[i] == eMCDone))
+		return DriveDoneAt[i] - StartedAt;
+	return 0;
+}
+
+//--- private functions ---
+
+/*---------------------------------------------------------------------
+ * DriveCommStates Run(MCGroupOps Op)
+ * Step all drives not yet finished with Op once.
+ * The drive which is stepped first rotates with each call, so no drive
+ * is preferred when trying to get the bus.
+ * A drive which is finished is reset right away to release the bus.
+ * The first drive failing ends the sequence for all of them.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDriveGroup::Run(MCGroupOps Op)
+{
+	uint8_t Pending = 0;
+
+	if(ActOp != Op)
+	{
+		//a different sequence was running - drop it
+		if(ActOp != eGroupNone)
+			ResetComState();
+
+		ActOp = Op;
+		FailedDrive = MCGroupNone;
+		StartedAt = actTime;
+		for(uint8_t i = 0; i < Count; i++)
+		{
+			DriveState[i] = eMCWaiting;
+			DriveDoneAt[i] = 0;
+		}
+
+		#if(DEBUG_GROUP & DEBUG_START)
+		std::printf("Group: start %d on %u drives\n", Op, Count);
+		#endif
+	}
+
+	for(uint8_t n = 0; n < Count; n++)
+	{
+		uint8_t i = (FirstDrive + n) % Count;
+
+		if(DriveState[i] != eMCWaiting)
+			continue;
+
+		DriveCommStates State = StepDrive(i);
+
+		if(State == eMCDone)
+		{
+			DriveState[i] = eMCDone;
+			DriveDoneAt[i] = actTime;
+			Drives[i]->ResetComState();
+		}
+		else if((State == eMCError) || (State == eMCTimeout))
+		{
+			DriveState[i] = State;
+			FailedDrive = i;
+			break;
+		}
+		else
+			Pending++;
+	}
+
+	if(Count > 0)
+		FirstDrive = (FirstDrive + 1) % Count;
+
+	if(FailedDrive != MCGroupNone)
+	{
+		//stop the others where they are
+		for(uint8_t i = 0; i < Count; i++)
+		{
+			if(DriveState[i] == eMCWaiting)
+				DriveState[i] = eMCIdle;
+			Drives[i]->ResetComState();
+		}
+		FinishedAt = actTime;
+		ActOp = eGroupNone;
+
+		#if(DEBUG_GROUP & DEBUG_ERROR)
+		std::printf("Group: %d failed at drive %u with %d\n", Op, FailedDrive, DriveState[FailedDrive]);
+		#endif
+
+		return DriveState[FailedDrive];
+	}
+
+	if(Pending == 0)
+	{
+		FinishedAt = actTime;
+		ActOp = eGroupNone;
+
+		#if(DEBUG_GROUP & DEBUG_DONE)
+		std::printf("Group: %d done in %u ms\n", Op, FinishedAt - StartedAt);
+		#endif
+
+		return eMCDone;
+	}
+	return eMCWaiting;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates StepDrive(uint8_t i)
+ * one step of the running sequence for a single drive
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDriveGroup::StepDrive(uint8_t i)
+{
+	MCDrive *Drive = Drives[i];
+
+	switch(ActOp)
+	{
+		case eGroupEnable:
+			return Drive->EnableDrive();
+		case eGroupDisable:
+			return Drive->DisableDrive();
+		case eGroupStop:
+			return Drive->StopDrive();
+		case eGroupSetProfile:
+			return Drive->SetProfile(ProfileArg[0], ProfileArg[1], ProfileArg[2], ProfileType);
+		case eGroupAbsMove:
+			return Drive->StartAbsMove(Targets[i], isImmediate);
+		case eGroupRelMove:
+			return Drive->StartRelMove(Targets[i], isImmediate);
+		case eGroupInPos:
+			return Drive->IsInPos();
+		case eGroupConfigureHoming:
+			return Drive->ConfigureHoming(HomingMethod);
+		case eGroupHoming:
+			return Drive->DoHoming(HomingTimeout);
+		case eGroupPreload:
+			return Drive->PreloadMovePP(Targets[i]);
+		case eGroupFinishPP:
+			return Drive->FinishMovePP(isImmediate, isRelative);
+		case eGroupReset:
+			return Drive->SendReset();
+		case eGroupConfigure:
+			return Drive->ConfigureDrive();
+		case eGroupNone:
+			break;
+	}
+	return eMCError;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates SendStartBurst(bool immediate, bool relative)
+ * Lock the bus and send the start CWs of all drives in a single write.
+ * The frames reach the nodes one after another, so the responses are
+ * staggered by about one frame time, too.
+ * Each node is told when its frame is out, so its response timeout
+ * starts from there. The lock is kept for the responses, see
+ * ReleaseBurst().
+ * --> eMCBusy: the bus is locked by someone else - retry
+ * --> eMCDone: all CWs are sent
+ * --> eMCError: group can't be started in a burst
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW lock kept for the responses
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCDriveGroup::SendStartBurst(bool immediate, bool relative)
+{
+	uint8_t Handles[MCGroupMaxDrives];
+	MCMsg *Msgs[MCGroupMaxDrives];
+	uint16_t StartCW[MCGroupMaxDrives];
+	uint32_t BaudRate;
+	uint32_t Bits = 0;
+
+	if((Handler == NULL) || (Count == 0) || (Count > UART_MAX_BURST))
+		return eMCError;
+
+	if(!Handler->LockHandler())
+		return eMCBusy;
+
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		StartCW[i] = Drives[i]->GetPPStartCW(immediate, relative);
+		Msgs[i] = Drives[i]->ThisNode.PrepareCw(StartCW[i]);
+		Handles[i] = Drives[i]->ThisNode.GetChannel();
+	}
+
+	if(!Handler->SendMsgBurst(Handles, Msgs, Count))
+	{
+		Handler->UnLockHandler();
+
+		#if(DEBUG_GROUP & DEBUG_ERROR)
+		std::printf("Group: start burst failed\n");
+		#endif
+
+		return eMCError;
+	}
+
+	isBurstLocked = true;
+
+	BaudRate = Handler->GetBaudRate();
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		//start bit, 8 data bits and stop bit per byte
+		Bits += ((uint32_t)Msgs[i]->Hdr.u8Len + 2) * 10;
+		Drives[i]->PPStartSent(StartCW[i], (Bits * 1000 + BaudRate - 1) / BaudRate);
+
+		if(i == 0)
+			StartSkewUs = 0;
+		else
+			StartSkewUs = (uint32_t)(((uint64_t)(Bits - (Msgs[0]->Hdr.u8Len + 2) * 10) * 1000000) / BaudRate);
+	}
+
+	#if(DEBUG_GROUP & DEBUG_START)
+	std::printf("Group: start burst of %u CWs\n", Count);
+	#endif
+
+	return eMCDone;
+}
+
+/*---------------------------------------------------------------------
+ * void ReleaseBurst(bool isForced)
+ * Release the lock of the last start burst once no drive waits for
+ * the response of its CW of the burst any longer. A drive whose
+ * response has timed out resends its CW on its own and needs the
+ * bus for that. Forced when the sequence has ended anyway.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveGroup::ReleaseBurst(bool isForced)
+{
+	if(!isBurstLocked)
+		return;
+
+	for(uint8_t i = 0; (i < Count) && !isForced; i++)
+	{
+		if(Drives[i]->ThisNode.IsBurstCwWaiting())
+			return;
+	}
+	Handler->UnLockHandler();
+	isBurstLocked = false;
+}
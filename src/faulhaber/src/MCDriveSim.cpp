@@ -0,0 +1,904 @@
+/*---------------------------------------------------
+ * MCDriveSim.cpp
+ * implements the simulation of the drives of a serial
+ * line behind a pseudo terminal
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "faulhaber/MCDriveSim.h"
+
+//--- local defines ---
+
+#define DEBUG_START		0x0001
+#define DEBUG_RXFRAME	0x0002
+#define DEBUG_BOOT		0x0004
+#define DEBUG_ERROR		0x0008
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_SIM 0
+#else
+#define DEBUG_SIM (DEBUG_START | DEBUG_ERROR)
+#endif
+
+const uint8_t SimPrefix = 0x53;    // == S
+const uint8_t SimSuffix = 0x45;    // == E
+
+//CiA 402 states as the bits of the SW
+const uint16_t SimStateMask = 0x6F;
+const uint16_t SimSwitchOnDisabled = 0x40;
+const uint16_t SimReady2SwitchOn = 0x21;
+const uint16_t SimSwitchedOn = 0x23;
+const uint16_t SimEnabled = 0x27;
+const uint16_t SimQuickStop = 0x07;
+const uint16_t SimFault = 0x08;
+
+const uint16_t SimTargetReached = 0x0400;
+const uint16_t SimAck = 0x1000;          //set-point ack in PP, n0 in PV, attained in homing
+
+const uint16_t SimStartBit = 0x0010;
+const uint16_t SimRelativeBit = 0x0040;
+const uint16_t SimFaultResetBit = 0x0080;
+const uint16_t SimHaltBit = 0x0100;
+
+//SDO abort codes
+const uint32_t SimNoObject = 0x06020000;
+const uint32_t SimReadOnly = 0x06010002;
+
+//time a homing takes
+const uint32_t SimHomingUs = 100000;
+
+//--- public functions ---
+
+MCDriveSim::MCDriveSim()
+{
+	for(uint8_t i = 0; i < MCSimMaxNodes; i++)
+		PendingFault[i].store(0);
+}
+
+MCDriveSim::~MCDriveSim()
+{
+	Stop();
+}
+
+/*---------------------------------------------------------------------
+ * bool AddNode(uint8_t NodeId)
+ * Add a node, booted and in SwitchOnDisabled. Has to be done before
+ * Start().
+ * --> false if all nodes are used
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCDriveSim::AddNode(uint8_t NodeId)
+{
+	if((NodeCount >= MCSimMaxNodes) || isRunning.load())
+		return false;
+
+	MCSimNode *Node = &Nodes[NodeCount];
+
+	*Node = {};
+	Node->NodeId = NodeId;
+	Boot(Node);
+	NodeCount++;
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void Configure(uint32_t Baud, uint16_t Latency, uint16_t Scale)
+ * void SetBootTime(uint16_t ms)
+ * void SetVelocityScale(double Scale)
+ * Baud: rate the wire time of the frames is taken from
+ * Latency: us from a request being received to the response
+ * Scale: simulated time per real time, at least 1
+ * ms from a reset request to the boot Msg, increments per s moved
+ * per velocity unit
+ * All of them have to be set before Start().
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::Configure(uint32_t Baud, uint16_t Latency, uint16_t Scale)
+{
+	BaudRate = (Baud > 0) ? Baud : 115200;
+	LatencyUs = Latency;
+	TimeScale = (Scale > 0) ? Scale : 1;
+}
+
+void MCDriveSim::SetBootTime(uint16_t ms)
+{
+	BootTime = ms;
+}
+
+void MCDriveSim::SetVelocityScale(double Scale)
+{
+	VelocityScale = Scale;
+}
+
+/*---------------------------------------------------------------------
+ * bool Start()
+ * void Stop()
+ * Open the PTY and run the nodes in a thread of their own, or stop
+ * them and close the PTY. The slave side is kept open by the
+ * simulation, too, so a client may close and reopen it.
+ * --> false if the PTY can't be opened
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCDriveSim::Start()
+{
+	struct termios Attr;
+
+	if(isRunning.load())
+		return true;
+
+	MasterFd = posix_openpt(O_RDWR | O_NOCTTY);
+	if((MasterFd < 0) || (grantpt(MasterFd) != 0) || (unlockpt(MasterFd) != 0) ||
+		(ptsname_r(MasterFd, PortName, sizeof(PortName)) != 0))
+	{
+		#if(DEBUG_SIM & DEBUG_ERROR)
+		std::printf("Sim: no PTY\n");
+		#endif
+		Stop();
+		return false;
+	}
+
+	SlaveFd = open(PortName, O_RDWR | O_NOCTTY);
+	if((SlaveFd < 0) || (tcgetattr(SlaveFd, &Attr) != 0))
+	{
+		Stop();
+		return false;
+	}
+	cfmakeraw(&Attr);
+	tcsetattr(SlaveFd, TCSANOW, &Attr);
+	fcntl(MasterFd, F_SETFL, fcntl(MasterFd, F_GETFL) | O_NONBLOCK);
+
+	RxIdx = 0;
+	TxHead = 0;
+	TxCount = 0;
+	TxFreeAt = 0;
+	LastTickUs = 0;
+	StartedAt = std::chrono::steady_clock::now();
+
+	isRunning.store(true);
+	Worker = std::thread(&MCDriveSim::Run, this);
+
+	#if(DEBUG_SIM & DEBUG_START)
+	std::printf("Sim: %u nodes at %s, %u Bd, x%u\n", NodeCount, PortName, BaudRate, TimeScale);
+	#endif
+
+	return true;
+}
+
+void MCDriveSim::Stop()
+{
+	isRunning.store(false);
+	if(Worker.joinable())
+		Worker.join();
+
+	if(SlaveFd >= 0)
+		close(SlaveFd);
+	if(MasterFd >= 0)
+		close(MasterFd);
+	SlaveFd = -1;
+	MasterFd = -1;
+	PortName[0] = 0;
+}
+
+/*---------------------------------------------------------------------
+ * const char *GetPortName()
+ * bool LinkPort(const char *Path)
+ * the slave side of the PTY to be opened by the MsgHandler, and a
+ * symlink to it under a fixed name. An existing symlink is replaced,
+ * any other file is not.
+ * --> false if the link can't be created
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+const char *MCDriveSim::GetPortName()
+{
+	return PortName;
+}
+
+bool MCDriveSim::LinkPort(const char *Path)
+{
+	struct stat Info;
+
+	if(PortName[0] == 0)
+		return false;
+
+	if(lstat(Path, &Info) == 0)
+	{
+		if(!S_ISLNK(Info.st_mode))
+			return false;
+		unlink(Path);
+	}
+	return symlink(PortName, Path) == 0;
+}
+
+/*---------------------------------------------------------------------
+ * void InjectFault(uint8_t NodeId, uint16_t ErrorCode)
+ * Let the node fall into Fault and send an EMCY with the ErrorCode,
+ * not 0. Can be called from any thread; is handled with the next
+ * cycle of the simulation.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::InjectFault(uint8_t NodeId, uint16_t ErrorCode)
+{
+	for(uint8_t i = 0; i < NodeCount; i++)
+	{
+		if(Nodes[i].NodeId == NodeId)
+			PendingFault[i].store(ErrorCode);
+	}
+}
+
+uint32_t MCDriveSim::GetRxFrames()
+{
+	return RxFrames.load();
+}
+
+uint32_t MCDriveSim::GetTxFrames()
+{
+	return TxFrames.load();
+}
+
+//--- private functions ---
+
+/*---------------------------------------------------------------------
+ * void Run()
+ * the thread of the simulation: moves the nodes, sends the responses
+ * which are due and waits for requests until the next one is due or
+ * for about 1 ms of simulated time.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::Run()
+{
+	uint8_t Buffer[UART_MAX_MSG_SIZE];
+
+	while(isRunning.load())
+	{
+		uint64_t Now = GetSimUs();
+		uint64_t WaitUs = 1000 / TimeScale;
+
+		Tick(Now);
+		Flush(Now);
+
+		if((TxCount > 0) && (TxQueue[TxHead].DueUs > Now) && ((TxQueue[TxHead].DueUs - Now) / TimeScale < WaitUs))
+			WaitUs = (TxQueue[TxHead].DueUs - Now) / TimeScale;
+		if(WaitUs < 50)
+			WaitUs = 50;
+
+		struct pollfd Fd = {MasterFd, POLLIN, 0};
+		struct timespec Wait = {0, (long)(WaitUs * 1000)};
+
+		if(ppoll(&Fd, 1, &Wait, NULL) <= 0)
+			continue;
+
+		ssize_t n = read(MasterFd, Buffer, sizeof(Buffer));
+		Now = GetSimUs();
+		for(ssize_t i = 0; i < n; i++)
+			OnRxByte(Buffer[i], Now);
+	}
+}
+
+uint64_t MCDriveSim::GetSimUs()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - StartedAt).count() * TimeScale;
+}
+
+/*---------------------------------------------------------------------
+ * void OnRxByte(uint8_t c, uint64_t Now)
+ * collect a frame the same way the MCUart does
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::OnRxByte(uint8_t c, uint64_t Now)
+{
+	if(RxIdx == 0)
+	{
+		if(c != SimPrefix)
+			return;
+		RxSize = UART_MIN_MSG_SIZE;
+	}
+	else if(RxIdx == 1)
+	{
+		RxSize = c + 2;
+		if((RxSize > UART_MAX_MSG_SIZE) || (RxSize < UART_MIN_MSG_SIZE))
+		{
+			RxIdx = 0;
+			return;
+		}
+	}
+
+	RxFrame[RxIdx++] = c;
+	if(RxIdx == RxSize)
+	{
+		RxIdx = 0;
+		if(c == SimSuffix)
+			OnRxFrame(Now);
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void OnRxFrame(uint64_t Now)
+ * A complete frame has been received. Frames with a wrong CRC, for
+ * other nodes or for a node still booting are dropped like a drive
+ * would do.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::OnRxFrame(uint64_t Now)
+{
+	uint8_t Len = RxFrame[1];
+	MCSimNode *Node = FindNode(RxFrame[2]);
+
+	if((Node == NULL) || (RxFrame[Len] != CalcCRC(&RxFrame[1], Len - 1)))
+		return;
+
+	RxFrames++;
+
+	#if(DEBUG_SIM & DEBUG_RXFRAME)
+	std::printf("Sim: node %u cmd %u\n", Node->NodeId, RxFrame[3]);
+	#endif
+
+	if(Node->BootDueUs != 0)
+		return;
+
+	//the request has been on the wire and is processed then
+	uint64_t ReadyUs = Now + ((uint64_t)RxSize * 10 * 1000000) / BaudRate + LatencyUs;
+
+	switch(RxFrame[3])
+	{
+		case eBootMsg:
+			//a reset request - the node is gone until its boot
+			Node->State = 0;
+			Node->BootDueUs = Now + (uint64_t)BootTime * 1000;
+
+			#if(DEBUG_SIM & DEBUG_BOOT)
+			std::printf("Sim: node %u reset\n", Node->NodeId);
+			#endif
+			break;
+		case eSdoReadReq:
+		case eSdoWriteReq:
+			if(Len >= 7)
+				OnSdo(Node, RxFrame[3], &RxFrame[4], Len - 4, ReadyUs);
+			break;
+		case eCtrlWord:
+			if(Len >= 6)
+				OnCw(Node, (uint16_t)(RxFrame[4] | (RxFrame[5] << 8)), ReadyUs);
+			break;
+		default:
+			break;
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void OnSdo(MCSimNode *Node, uint8_t Cmd, const uint8_t *Data, uint8_t Len, uint64_t ReadyUs)
+ * Answer a read or a write of an object. Unknown objects are answered
+ * by an SDO error, except for writes while there is room to keep them.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::OnSdo(MCSimNode *Node, uint8_t Cmd, const uint8_t *Data, uint8_t Len, uint64_t ReadyUs)
+{
+	uint16_t Idx = (uint16_t)(Data[0] | (Data[1] << 8));
+	uint8_t SubIdx = Data[2];
+	uint8_t Resp[7] = {Data[0], Data[1], SubIdx};
+	uint32_t Value = 0;
+	uint8_t ValueLen = 0;
+	uint32_t Abort = 0;
+
+	if(Cmd == eSdoReadReq)
+	{
+		if(ReadObject(Node, Idx, SubIdx, &Value, &ValueLen))
+		{
+			for(uint8_t i = 0; i < ValueLen; i++)
+				Resp[3 + i] = (uint8_t)(Value >> (8 * i));
+			Send(Node->NodeId, eSdoReadReq, Resp, 3 + ValueLen, ReadyUs);
+			return;
+		}
+		Abort = SimNoObject;
+	}
+	else
+	{
+		ValueLen = (Len > 7) ? 4 : Len - 3;
+		for(uint8_t i = 0; i < ValueLen; i++)
+			Value |= (uint32_t)Data[3 + i] << (8 * i);
+
+		if(WriteObject(Node, Idx, SubIdx, Value, ValueLen))
+		{
+			Send(Node->NodeId, eSdoWriteReq, Resp, 3, ReadyUs);
+			//a CW written by SDO may have changed the SW
+			PushSW(Node, ReadyUs);
+			return;
+		}
+		Abort = (FindObject(Node, Idx, SubIdx) != NULL) ? SimReadOnly : SimNoObject;
+	}
+
+	for(uint8_t i = 0; i < 4; i++)
+		Resp[3 + i] = (uint8_t)(Abort >> (8 * i));
+	Send(Node->NodeId, eSdoError, Resp, 7, ReadyUs);
+}
+
+/*---------------------------------------------------------------------
+ * void OnCw(MCSimNode *Node, uint16_t CW, uint64_t ReadyUs)
+ * Apply a CW, acknowledge it and push the SW if it has changed.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::OnCw(MCSimNode *Node, uint16_t CW, uint64_t ReadyUs)
+{
+	uint8_t Ack = 0;
+
+	ApplyCw(Node, CW, ReadyUs);
+	Send(Node->NodeId, eCtrlWord, &Ack, 1, ReadyUs);
+	PushSW(Node, ReadyUs);
+}
+
+/*---------------------------------------------------------------------
+ * void ApplyCw(MCSimNode *Node, uint16_t CW, uint64_t Now)
+ * the CiA 402 state machine and the start of a PP move or a homing
+ * by the rising edge of the start bit
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::ApplyCw(MCSimNode *Node, uint16_t CW, uint64_t Now)
+{
+	uint16_t Old = Node->ControlWord;
+	uint16_t State = Node->State & SimStateMask;
+	uint16_t NewState = State;
+
+	Node->ControlWord = CW;
+	SetObject(Node, 0x6040, 0x00, 2, CW);
+
+	if(State & SimFault)
+	{
+		if((CW & SimFaultResetBit) && !(Old & SimFaultResetBit))
+		{
+			uint8_t Emcy[8] = {};
+
+			Node->State = SimSwitchOnDisabled;
+			Node->ModeBits = 0;
+			//an EMCY with code 0 tells the error has been reset
+			Send(Node->NodeId, eEmergencyMsg, Emcy, sizeof(Emcy), Now);
+		}
+		return;
+	}
+
+	if((CW & 0x02) == 0)
+		NewState = SimSwitchOnDisabled;
+	else if((CW & 0x04) == 0)
+		NewState = (State == SimEnabled) ? SimQuickStop : SimSwitchOnDisabled;
+	else if((CW & 0x01) == 0)
+		NewState = SimReady2SwitchOn;
+	else if((CW & 0x08) == 0)
+	{
+		if((State == SimReady2SwitchOn) || (State == SimEnabled))
+			NewState = SimSwitchedOn;
+	}
+	else if(State != SimSwitchOnDisabled)
+		NewState = SimEnabled;
+
+	Node->State = NewState;
+
+	if(NewState != SimEnabled)
+	{
+		Node->isMoving = false;
+		Node->Velocity = 0.0;
+		Node->HomingDueUs = 0;
+		Node->ModeBits &= ~SimAck;
+		return;
+	}
+
+	bool isStart = (CW & SimStartBit) && !(Old & SimStartBit);
+
+	switch(GetOpMode(Node))
+	{
+		case 1:
+			if(isStart)
+			{
+				MCSimObject *Target = FindObject(Node, 0x607A, 0x00);
+				double Value = (Target != NULL) ? (double)(int32_t)Target->Value : 0.0;
+
+				if(CW & SimRelativeBit)
+					Value += Node->isMoving ? Node->Target : Node->Position;
+				Node->Target = Value;
+				Node->isMoving = true;
+				Node->ModeBits |= SimAck;
+				Node->ModeBits &= ~SimTargetReached;
+			}
+			else if(!(CW & SimStartBit))
+				Node->ModeBits &= ~SimAck;
+			break;
+		case 6:
+			if(isStart)
+			{
+				Node->HomingDueUs = Now + SimHomingUs;
+				Node->ModeBits &= ~(SimAck | SimTargetReached);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void Tick(uint64_t Now)
+ * Move the nodes enabled up to Now, send the boot Msgs and the
+ * EMCYs due and push the SWs changed.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::Tick(uint64_t Now)
+{
+	double dt = (double)(Now - LastTickUs) / 1000000.0;
+
+	LastTickUs = Now;
+
+	for(uint8_t i = 0; i < NodeCount; i++)
+	{
+		MCSimNode *Node = &Nodes[i];
+		uint16_t FaultCode = PendingFault[i].exchange(0);
+
+		if(Node->BootDueUs != 0)
+		{
+			if(Now >= Node->BootDueUs)
+			{
+				uint16_t SW;
+
+				Boot(Node);
+				SW = GetSW(Node);
+				uint8_t Payload[2] = {(uint8_t)SW, (uint8_t)(SW >> 8)};
+				Send(Node->NodeId, eBootMsg, Payload, 2, Now);
+
+				#if(DEBUG_SIM & DEBUG_BOOT)
+				std::printf("Sim: node %u booted\n", Node->NodeId);
+				#endif
+			}
+			continue;
+		}
+
+		if(FaultCode != 0)
+		{
+			uint8_t Emcy[8] = {(uint8_t)FaultCode, (uint8_t)(FaultCode >> 8), 0x01};
+
+			Node->State = SimFault;
+			Node->ModeBits = 0;
+			Node->isMoving = false;
+			Node->HomingDueUs = 0;
+			Send(Node->NodeId, eEmergencyMsg, Emcy, sizeof(Emcy), Now);
+		}
+
+		if(Node->State != SimEnabled)
+		{
+			Node->Velocity = 0.0;
+			PushSW(Node, Now);
+			continue;
+		}
+
+		bool isHalt = (Node->ControlWord & SimHaltBit) != 0;
+		MCSimObject *Obj;
+
+		switch(GetOpMode(Node))
+		{
+			case 1:
+				if(Node->isMoving && !isHalt)
+				{
+					Obj = FindObject(Node, 0x6081, 0x00);
+					double Speed = ((Obj != NULL) ? (double)Obj->Value : 0.0) * VelocityScale;
+					double Step = Speed * dt;
+					double Diff = Node->Target - Node->Position;
+
+					if(std::fabs(Diff) <= Step)
+					{
+						Node->Position = Node->Target;
+						Node->Velocity = 0.0;
+						Node->isMoving = false;
+					}
+					else
+					{
+						Node->Position += (Diff > 0) ? Step : -Step;
+						Node->Velocity = (Diff > 0) ? Speed : -Speed;
+					}
+				}
+				else
+					Node->Velocity = 0.0;
+
+				if(Node->isMoving)
+					Node->ModeBits &= ~SimTargetReached;
+				else
+					Node->ModeBits |= SimTargetReached;
+				break;
+			case 3:
+				Obj = FindObject(Node, 0x60FF, 0x00);
+				Node->Velocity = (isHalt || (Obj == NULL)) ? 0.0 : (double)(int32_t)Obj->Value * VelocityScale;
+				Node->Position += Node->Velocity * dt;
+				Node->ModeBits = SimTargetReached | ((Node->Velocity == 0.0) ? SimAck : 0);
+				break;
+			case 6:
+				Node->Velocity = 0.0;
+				if((Node->HomingDueUs != 0) && (Now >= Node->HomingDueUs))
+				{
+					Node->Position = 0.0;
+					Node->HomingDueUs = 0;
+					Node->ModeBits |= SimAck | SimTargetReached;
+				}
+				break;
+			default:
+				Node->Velocity = 0.0;
+				break;
+		}
+		PushSW(Node, Now);
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void Boot(MCSimNode *Node)
+ * the node as after power on, with the objects at their defaults.
+ * The position is kept like an absolute encoder would.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::Boot(MCSimNode *Node)
+{
+	Node->ObjectCount = 0;
+	SetObject(Node, 0x1000, 0x00, 4, 0x00420192);
+	SetObject(Node, 0x1001, 0x00, 1, 0);
+	SetObject(Node, 0x6040, 0x00, 2, 0);
+	SetObject(Node, 0x6060, 0x00, 1, 0);
+	SetObject(Node, 0x607A, 0x00, 4, 0);
+	SetObject(Node, 0x6081, 0x00, 4, 1000);
+	SetObject(Node, 0x6083, 0x00, 4, 5000);
+	SetObject(Node, 0x6084, 0x00, 4, 5000);
+	SetObject(Node, 0x6086, 0x00, 2, 0);
+	SetObject(Node, 0x6098, 0x00, 1, 0);
+	SetObject(Node, 0x60FF, 0x00, 4, 0);
+
+	Node->State = SimSwitchOnDisabled;
+	Node->ModeBits = 0;
+	Node->ControlWord = 0;
+	Node->Velocity = 0.0;
+	Node->isMoving = false;
+	Node->BootDueUs = 0;
+	Node->HomingDueUs = 0;
+	Node->ReportedSW = GetSW(Node);
+}
+
+MCSimNode *MCDriveSim::FindNode(uint8_t NodeId)
+{
+	for(uint8_t i = 0; i < NodeCount; i++)
+	{
+		if(Nodes[i].NodeId == NodeId)
+			return &Nodes[i];
+	}
+	return NULL;
+}
+
+MCSimObject *MCDriveSim::FindObject(MCSimNode *Node, uint16_t Idx, uint8_t SubIdx)
+{
+	for(uint8_t i = 0; i < Node->ObjectCount; i++)
+	{
+		if((Node->Objects[i].Idx == Idx) && (Node->Objects[i].SubIdx == SubIdx))
+			return &Node->Objects[i];
+	}
+	return NULL;
+}
+
+/*---------------------------------------------------------------------
+ * bool ReadObject(MCSimNode *Node, uint16_t Idx, uint8_t SubIdx, uint32_t *Value, uint8_t *Len)
+ * bool WriteObject(MCSimNode *Node, uint16_t Idx, uint8_t SubIdx, uint32_t Value, uint8_t Len)
+ * SW, OpMode display and the actual values are taken from the state
+ * of the node and can't be written. A CW written is applied, an OpMode
+ * written stops what the node did in the old one.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCDriveSim::ReadObject(MCSimNode *Node, uint16_t Idx, uint8_t SubIdx, uint32_t *Value, uint8_t *Len)
+{
+	if(SubIdx == 0)
+	{
+		switch(Idx)
+		{
+			case 0x6041:
+				*Value = GetSW(Node);
+				*Len = 2;
+				return true;
+			case 0x6061:
+				*Value = (uint8_t)GetOpMode(Node);
+				*Len = 1;
+				return true;
+			case 0x6064:
+				*Value = (uint32_t)(int32_t)std::lround(Node->Position);
+				*Len = 4;
+				return true;
+			case 0x606C:
+				*Value = (uint32_t)(int32_t)std::lround((VelocityScale != 0.0) ? Node->Velocity / VelocityScale : 0.0);
+				*Len = 4;
+				return true;
+			default:
+				break;
+		}
+	}
+
+	MCSimObject *Obj = FindObject(Node, Idx, SubIdx);
+
+	if(Obj == NULL)
+		return false;
+	*Value = Obj->Value;
+	*Len = Obj->Len;
+	return true;
+}
+
+bool MCDriveSim::WriteObject(MCSimNode *Node, uint16_t Idx, uint8_t SubIdx, uint32_t Value, uint8_t Len)
+{
+	if(SubIdx == 0)
+	{
+		switch(Idx)
+		{
+			case 0x6041:
+			case 0x6061:
+			case 0x6064:
+			case 0x606C:
+				return false;
+			case 0x6040:
+				ApplyCw(Node, (uint16_t)Value, LastTickUs);
+				return true;
+			case 0x6060:
+				Node->isMoving = false;
+				Node->HomingDueUs = 0;
+				Node->ModeBits = 0;
+				break;
+			default:
+				break;
+		}
+	}
+
+	if((FindObject(Node, Idx, SubIdx) == NULL) && (Node->ObjectCount >= MCSimMaxObjects))
+		return false;
+	SetObject(Node, Idx, SubIdx, Len, Value);
+	return true;
+}
+
+void MCDriveSim::SetObject(MCSimNode *Node, uint16_t Idx, uint8_t SubIdx, uint8_t Len, uint32_t Value)
+{
+	MCSimObject *Obj = FindObject(Node, Idx, SubIdx);
+
+	if(Obj == NULL)
+	{
+		if(Node->ObjectCount >= MCSimMaxObjects)
+			return;
+		Obj = &Node->Objects[Node->ObjectCount++];
+		Obj->Idx = Idx;
+		Obj->SubIdx = SubIdx;
+	}
+	Obj->Len = Len;
+	Obj->Value = Value;
+}
+
+uint16_t MCDriveSim::GetSW(MCSimNode *Node)
+{
+	return Node->State | Node->ModeBits;
+}
+
+int8_t MCDriveSim::GetOpMode(MCSimNode *Node)
+{
+	MCSimObject *Obj = FindObject(Node, 0x6060, 0x00);
+
+	return (Obj != NULL) ? (int8_t)Obj->Value : 0;
+}
+
+void MCDriveSim::PushSW(MCSimNode *Node, uint64_t ReadyUs)
+{
+	uint16_t SW = GetSW(Node);
+
+	if(SW == Node->ReportedSW)
+		return;
+
+	uint8_t Payload[2] = {(uint8_t)SW, (uint8_t)(SW >> 8)};
+
+	Node->ReportedSW = SW;
+	Send(Node->NodeId, eStatusWord, Payload, 2, ReadyUs);
+}
+
+/*---------------------------------------------------------------------
+ * void Send(uint8_t NodeId, uint8_t Cmd, const uint8_t *Data, uint8_t Len, uint64_t ReadyUs)
+ * Queue a frame to be sent once it has been on the wire. It starts
+ * at ReadyUs or when the frame before has been sent. A frame not
+ * fitting into the queue is lost like on an overrun.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCDriveSim::Send(uint8_t NodeId, uint8_t Cmd, const uint8_t *Data, uint8_t Len, uint64_t ReadyUs)
+{
+	if((TxCount >= MCSimTxQueueSize) || (Len + 6 > (int)UART_MAX_MSG_SIZE))
+	{
+		#if(DEBUG_SIM & DEBUG_ERROR)
+		std::printf("Sim: Tx overrun\n");
+		#endif
+		return;
+	}
+
+	MCSimFrame *Frame = &TxQueue[(TxHead + TxCount) % MCSimTxQueueSize];
+	uint8_t FrameLen = Len + 4;
+
+	Frame->Data[0] = SimPrefix;
+	Frame->Data[1] = FrameLen;
+	Frame->Data[2] = NodeId;
+	Frame->Data[3] = Cmd;
+	std::memcpy(&Frame->Data[4], Data, Len);
+	Frame->Data[FrameLen] = CalcCRC(&Frame->Data[1], FrameLen - 1);
+	Frame->Data[FrameLen + 1] = SimSuffix;
+	Frame->Len = FrameLen + 2;
+
+	uint64_t StartUs = (ReadyUs > TxFreeAt) ? ReadyUs : TxFreeAt;
+
+	Frame->DueUs = StartUs + ((uint64_t)Frame->Len * 10 * 1000000) / BaudRate;
+	TxFreeAt = Frame->DueUs;
+	TxCount++;
+}
+
+void MCDriveSim::Flush(uint64_t Now)
+{
+	while((TxCount > 0) && (TxQueue[TxHead].DueUs <= Now))
+	{
+		MCSimFrame *Frame = &TxQueue[TxHead];
+
+		if(write(MasterFd, Frame->Data, Frame->Len) != (ssize_t)Frame->Len)
+		{
+			#if(DEBUG_SIM & DEBUG_ERROR)
+			std::printf("Sim: Tx failed\n");
+			#endif
+		}
+		TxHead = (TxHead + 1) % MCSimTxQueueSize;
+		TxCount--;
+		TxFrames++;
+	}
+}
+
+//the same CRC as used by the MsgHandler
+uint8_t MCDriveSim::CalcCRC(const uint8_t *buffer, int len)
+{
+	uint8_t calcCRC = 0xFF;
+	for(int i = 0; i < len; i++)
+	{
+		calcCRC = calcCRC ^ buffer[i];
+		for(uint8_t j = 0; j < 8; j++)
+		{
+			if(calcCRC & 0x01)
+				calcCRC = (calcCRC >> 1) ^ 0xd5;
+			else
+				calcCRC = (calcCRC >> 1);
+		}
+	}
+	return calcCRC;
+}
@@ -0,0 +1,403 @@
+/*---------------------------------------------------
+ * MCDriveTask.cpp
+ * implements the executor and the awaitable operations
+ * of the coroutine interface of MCDrive
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cstdio>
+#include "faulhaber/MCDriveTask.h"
+
+#if defined(__cpp_impl_coroutine)
+
+//--- local defines ---
+
+#define DEBUG_QUEUE		0x0001
+#define DEBUG_DONE		0x0002
+#define DEBUG_ERROR		0x0004
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_TASK 0
+#else
+#define DEBUG_TASK (DEBUG_ERROR)
+#endif
+
+//--- MCDriveAwaiter ---
+
+MCDriveAwaiter::MCDriveAwaiter(MCExecutor *ThisExecutor, MCDrive *ThisDrive, MCDriveOps ThisOp)
+{
+	Executor = ThisExecutor;
+	Drive = ThisDrive;
+	Op = ThisOp;
+}
+
+/*---------------------------------------------------------------------
+ * bool await_suspend(std::coroutine_handle<> h)
+ * The awaiting coroutine is suspended and the operation is queued at
+ * the executor which resumes the coroutine when the operation is finished.
+ * If the operation can't be queued the coroutine continues right away.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCDriveAwaiter::await_suspend(std::coroutine_handle<> h)
+{
+	Waiter = h;
+	return Executor->Enqueue(this);
+}
+
+//--- MCExecutor ---
+
+/*---------------------------------------------------------------------
+ * MCExecutor(MsgHandler *ThisHandler)
+ * The executor updates the MsgHandler each cycle, so it must be
+ * the only one calling the MsgHandler's Update().
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+MCExecutor::MCExecutor(MsgHandler *ThisHandler)
+{
+	Handler = ThisHandler;
+	for(uint8_t i = 0; i < MsgHandler_MaxNodes; i++)
+	{
+		Drives[i] = NULL;
+		Head[i] = NULL;
+		Tail[i] = NULL;
+	}
+}
+
+/*---------------------------------------------------------------------
+ * bool AddDrive(MCDrive *Drive)
+ * Register a drive whose time has to be updated by the executor.
+ * Drives are registered implicitly when an operation of them is
+ * awaited for the first time.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCExecutor::AddDrive(MCDrive *Drive)
+{
+	if(FindDrive(Drive) != InvalidSlot)
+		return true;
+
+	for(uint8_t i = 0; i < MsgHandler_MaxNodes; i++)
+	{
+		if(Drives[i] == NULL)
+		{
+			Drives[i] = Drive;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*---------------------------------------------------------------------
+ * void Spawn(MCTask &&Task)
+ * Start a task which is not awaited by anyone. Its frame is released
+ * by itself when finished.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCExecutor::Spawn(MCTask &&Task)
+{
+	std::coroutine_handle<MCTask::promise_type> h = Task.Handle;
+
+	Task.Handle = nullptr;
+	if(h)
+	{
+		h.promise().isDetached = true;
+		h.resume();
+	}
+}
+
+/*---------------------------------------------------------------------
+ * void Start(MCTask &Task)
+ * Start a task which is owned by the caller. The caller can poll
+ * IsDone() and GetResult() of the task.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCExecutor::Start(MCTask &Task)
+{
+	if(Task.Handle && !Task.Handle.done())
+		Task.Handle.resume();
+}
+
+/*---------------------------------------------------------------------
+ * void Update(uint32_t time)
+ * To be called cyclically with the actual time in ms.
+ * Updates the bus and all drives and steps the first queued operation
+ * of each drive. Finished operations are removed from their queue,
+ * the drive is reset for the next operation and the awaiting
+ * coroutine is resumed - which might queue the next operation right away.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCExecutor::Update(uint32_t time)
+{
+	Handler->Update(time);
+
+	for(uint8_t i = 0; i < MsgHandler_MaxNodes; i++)
+	{
+		if(Drives[i] != NULL)
+			Drives[i]->SetActTime(time);
+	}
+
+	for(uint8_t i = 0; i < MsgHandler_MaxNodes; i++)
+	{
+		MCDriveAwaiter *Op = Head[i];
+
+		if(Op == NULL)
+			continue;
+
+		Op->State = Step(Op);
+
+		if((Op->State == eMCDone) || (Op->State == eMCError) || (Op->State == eMCTimeout))
+		{
+			#if(DEBUG_TASK & DEBUG_DONE)
+			std::printf("Task: op %d done with %d\n", Op->Op, Op->State);
+			#endif
+			#if(DEBUG_TASK & DEBUG_ERROR)
+			if(Op->State != eMCDone)
+				std::printf("Task: op %d failed with %d\n", Op->Op, Op->State);
+			#endif
+
+			Head[i] = Op->Next;
+			if(Head[i] == NULL)
+				Tail[i] = NULL;
+
+			Op->Drive->ResetComState();
+			//Op is part of the frame of the coroutine and must not be used after this
+			Op->Waiter.resume();
+		}
+	}
+}
+
+/*---------------------------------------------------------------------
+ * bool IsIdle()
+ * true if no operation is queued for any drive
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCExecutor::IsIdle()
+{
+	for(uint8_t i = 0; i < MsgHandler_MaxNodes; i++)
+	{
+		if(Head[i] != NULL)
+			return false;
+	}
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * bool Enqueue(MCDriveAwaiter *Op)
+ * Queue an operation at the end of the queue of its drive.
+ * If the drive can't be registered the operation fails with eMCError
+ * and false is returned.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCExecutor::Enqueue(MCDriveAwaiter *Op)
+{
+	uint8_t slot;
+
+	if(!AddDrive(Op->Drive) || ((slot = FindDrive(Op->Drive)) == InvalidSlot))
+	{
+		Op->State = eMCError;
+		return false;
+	}
+
+	Op->Next = NULL;
+	Op->State = eMCWaiting;
+	if(Tail[slot] != NULL)
+		Tail[slot]->Next = Op;
+	else
+		Head[slot] = Op;
+	Tail[slot] = Op;
+
+	#if(DEBUG_TASK & DEBUG_QUEUE)
+	std::printf("Task: op %d queued at %u\n", Op->Op, slot);
+	#endif
+	return true;
+}
+
+uint8_t MCExecutor::FindDrive(MCDrive *Drive)
+{
+	for(uint8_t i = 0; i < MsgHandler_MaxNodes; i++)
+	{
+		if(Drives[i] == Drive)
+			return i;
+	}
+	return InvalidSlot;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates Step(MCDriveAwaiter *Op)
+ * one step of the step sequence of the drive behind an operation
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCExecutor::Step(MCDriveAwaiter *Op)
+{
+	MCDrive *Drive = Op->Drive;
+
+	switch(Op->Op)
+	{
+		case eOpEnable:
+			return Drive->EnableDrive();
+		case eOpDisable:
+			return Drive->DisableDrive();
+		case eOpStop:
+			return Drive->StopDrive();
+		case eOpUpdateStatus:
+			return Drive->UpdateDriveStatus();
+		case eOpSetOpMode:
+			return Drive->SetOpMode((int8_t)Op->Arg[0]);
+		case eOpSetProfile:
+			return Drive->SetProfile((uint32_t)Op->Arg[0], (uint32_t)Op->Arg[1], (uint32_t)Op->Arg[2], (int16_t)Op->Arg[3]);
+		case eOpMoveAbs:
+			return Drive->StartAbsMove(Op->Arg[0], Op->Arg[1] != 0);
+		case eOpMoveRel:
+			return Drive->StartRelMove(Op->Arg[0], Op->Arg[1] != 0);
+		case eOpMoveAtSpeed:
+			return Drive->MoveAtSpeed(Op->Arg[0]);
+		case eOpConfigureHoming:
+			return Drive->ConfigureHoming((int8_t)Op->Arg[0]);
+		case eOpHoming:
+			return Drive->DoHoming((uint16_t)Op->Arg[0]);
+		case eOpWaitInPos:
+			return Drive->IsInPos();
+		case eOpReadObject:
+			return Drive->ReadObject((uint16_t)Op->Arg[0], (uint8_t)Op->Arg[1], Op->Result);
+		case eOpWriteObject:
+			switch(Op->Arg[3])
+			{
+				case 1:
+					return Drive->WriteObject((uint16_t)Op->Arg[0], (uint8_t)Op->Arg[1], (uint8_t)Op->Arg[2]);
+				case 2:
+					return Drive->WriteObject((uint16_t)Op->Arg[0], (uint8_t)Op->Arg[1], (uint16_t)Op->Arg[2]);
+				default:
+					return Drive->WriteObject((uint16_t)Op->Arg[0], (uint8_t)Op->Arg[1], (uint32_t)Op->Arg[2]);
+			}
+	}
+	return eMCError;
+}
+
+//--- MCAsyncDrive ---
+
+MCAsyncDrive::MCAsyncDrive(MCDrive *ThisDrive, MCExecutor *ThisExecutor)
+{
+	Drive = ThisDrive;
+	Executor = ThisExecutor;
+}
+
+MCDriveAwaiter MCAsyncDrive::Enable()
+{
+	return MCDriveAwaiter(Executor, Drive, eOpEnable);
+}
+
+MCDriveAwaiter MCAsyncDrive::Disable()
+{
+	return MCDriveAwaiter(Executor, Drive, eOpDisable);
+}
+
+MCDriveAwaiter MCAsyncDrive::Stop()
+{
+	return MCDriveAwaiter(Executor, Drive, eOpStop);
+}
+
+MCDriveAwaiter MCAsyncDrive::UpdateStatus()
+{
+	return MCDriveAwaiter(Executor, Drive, eOpUpdateStatus);
+}
+
+MCDriveAwaiter MCAsyncDrive::SetOpMode(int8_t OpMode)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpSetOpMode);
+	Op.Arg[0] = OpMode;
+	return Op;
+}
+
+MCDriveAwaiter MCAsyncDrive::SetProfile(uint32_t ProfileACC, uint32_t ProfileDEC, uint32_t ProfileSpeed, int16_t ProfileType)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpSetProfile);
+	Op.Arg[0] = (int32_t)ProfileACC;
+	Op.Arg[1] = (int32_t)ProfileDEC;
+	Op.Arg[2] = (int32_t)ProfileSpeed;
+	Op.Arg[3] = ProfileType;
+	return Op;
+}
+
+MCDriveAwaiter MCAsyncDrive::MoveAbs(int32_t TargetPos, bool immediate)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpMoveAbs);
+	Op.Arg[0] = TargetPos;
+	Op.Arg[1] = immediate;
+	return Op;
+}
+
+MCDriveAwaiter MCAsyncDrive::MoveRel(int32_t Distance, bool immediate)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpMoveRel);
+	Op.Arg[0] = Distance;
+	Op.Arg[1] = immediate;
+	return Op;
+}
+
+MCDriveAwaiter MCAsyncDrive::MoveAtSpeed(int32_t RefSpeed)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpMoveAtSpeed);
+	Op.Arg[0] = RefSpeed;
+	return Op;
+}
+
+MCDriveAwaiter MCAsyncDrive::ConfigureHoming(int8_t method)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpConfigureHoming);
+	Op.Arg[0] = method;
+	return Op;
+}
+
+MCDriveAwaiter MCAsyncDrive::DoHoming(uint16_t timeout)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpHoming);
+	Op.Arg[0] = timeout;
+	return Op;
+}
+
+MCDriveAwaiter MCAsyncDrive::WaitInPos()
+{
+	return MCDriveAwaiter(Executor, Drive, eOpWaitInPos);
+}
+
+MCDriveAwaiter MCAsyncDrive::Read(uint16_t Idx, uint8_t SubIdx, uint32_t *Value)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpReadObject);
+	Op.Arg[0] = Idx;
+	Op.Arg[1] = SubIdx;
+	Op.Result = Value;
+	return Op;
+}
+
+MCDriveAwaiter MCAsyncDrive::Write(uint16_t Idx, uint8_t SubIdx, uint32_t Value, uint8_t Len)
+{
+	MCDriveAwaiter Op(Executor, Drive, eOpWriteObject);
+	Op.Arg[0] = Idx;
+	Op.Arg[1] = SubIdx;
+	Op.Arg[2] = (int32_t)Value;
+	Op.Arg[3] = Len;
+	return Op;
+}
+
+#endif //__cpp_impl_coroutine
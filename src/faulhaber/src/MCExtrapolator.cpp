@@ -0,0 +1,117 @@
+/*---------------------------------------------------
+ * MCExtrapolator.cpp
+ * implements the estimate of the position of an axis
+ * between the samples of the bus
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include "faulhaber/MCExtrapolator.h"
+
+//--- public functions ---
+
+/*---------------------------------------------------------------------
+ * void Configure(uint16_t MaxHorizon, uint16_t Stale)
+ * MaxHorizon: ms the position is carried forward at most
+ * Stale: ms without a new position before it is reported stale
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCExtrapolator::Configure(uint16_t MaxHorizon, uint16_t Stale)
+{
+	Horizon = MaxHorizon;
+	StaleTime = Stale;
+}
+
+/*---------------------------------------------------------------------
+ * void Reset()
+ * forget the last sample, e.g. after the bus has been reopened
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCExtrapolator::Reset()
+{
+	hasSample = false;
+	Age = 0;
+}
+
+/*---------------------------------------------------------------------
+ * void AddSample(double Pos, uint32_t PosAt, double Vel)
+ * Take over a position with the time it has been received and the
+ * latest velocity. A position not newer than the last one is ignored,
+ * so the same sample can be handed over each cycle.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCExtrapolator::AddSample(double Pos, uint32_t PosAt, double Vel)
+{
+	if(hasSample && ((int32_t)(PosAt - PositionAt) <= 0))
+		return;
+
+	Position = Pos;
+	PositionAt = PosAt;
+	Velocity = Vel;
+	hasSample = true;
+}
+
+/*---------------------------------------------------------------------
+ * void Update(uint32_t Now)
+ * Estimate the position at Now. Before the first sample the estimate
+ * is 0 and stale.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCExtrapolator::Update(uint32_t Now)
+{
+	if(!hasSample)
+		return;
+
+	int32_t Delta = (int32_t)(Now - PositionAt);
+
+	//a sample taken after Now isn't moved backwards
+	if(Delta < 0)
+		Delta = 0;
+	Age = (uint32_t)Delta;
+
+	if(Delta > Horizon)
+		Delta = Horizon;
+	EstPosition = Position + Velocity * (double)Delta / 1000.0;
+}
+
+/*---------------------------------------------------------------------
+ * double GetPosition()
+ * double GetVelocity()
+ * uint32_t GetAge()
+ * bool IsStale()
+ * estimate of the last Update(), the velocity of the last sample and
+ * the age of the last position in ms
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+double MCExtrapolator::GetPosition()
+{
+	return EstPosition;
+}
+
+double MCExtrapolator::GetVelocity()
+{
+	return Velocity;
+}
+
+uint32_t MCExtrapolator::GetAge()
+{
+	return Age;
+}
+
+bool MCExtrapolator::IsStale()
+{
+	return !hasSample || (Age > StaleTime);
+}
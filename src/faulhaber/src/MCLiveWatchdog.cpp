@@ -0,0 +1,277 @@
+/*---------------------------------------------------
+ * MCLiveWatchdog.cpp
+ * implements the monitoring of the liveness of the
+ * nodes by the age of their last frame
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cstdio>
+#include "faulhaber/MCLiveWatchdog.h"
+
+//--- local defines ---
+
+#define DEBUG_PROBE		0x0001
+#define DEBUG_CHANGE	0x0002
+#define DEBUG_ERROR		0x0004
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_LIVE 0
+#else
+#define DEBUG_LIVE (DEBUG_CHANGE)
+#endif
+
+//--- public functions ---
+
+/*---------------------------------------------------------------------
+ * MCLiveWatchdog()
+ * no nodes registered
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+MCLiveWatchdog::MCLiveWatchdog()
+{
+	for(uint8_t i = 0; i < MCLiveMaxNodes; i++)
+	{
+		Nodes[i] = NULL;
+		State[i] = eLiveUnknown;
+		RxSeen[i] = 0;
+		LastRxAt[i] = 0;
+		ProbeAt[i] = 0;
+		Ticket[i] = 0;
+		Probes[i] = 0;
+		Missed[i] = 0;
+	}
+	OnChangeCb.callback = NULL;
+	OnChangeCb.op = NULL;
+}
+
+/*---------------------------------------------------------------------
+ * bool AddDrive(MCDrive *Drive)
+ * Add a drive to be monitored. The drive has to be connected to its
+ * MsgHandler already.
+ * --> false if all slots are used
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCLiveWatchdog::AddDrive(MCDrive *Drive)
+{
+	if((Drive == NULL) || (Count >= MCLiveMaxNodes))
+		return false;
+
+	Nodes[Count] = Drive;
+	State[Count] = eLiveUnknown;
+	RxSeen[Count] = Drive->ThisNode.GetRxCount();
+	LastRxAt[Count] = actTime;
+	Count++;
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void Configure(uint16_t Quiet, uint16_t Window)
+ * Quiet: ms without any frame before a node is probed
+ * Window: ms the probe gets to be answered. Has to cover a request
+ * waiting for the bus being leased by another node and the retry of
+ * the SDOHandler; 50 ms do so at 115200 Bd.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCLiveWatchdog::Configure(uint16_t Quiet, uint16_t Window)
+{
+	QuietTime = Quiet;
+	ProbeWindow = Window;
+}
+
+/*---------------------------------------------------------------------
+ * uint32_t GetDetectionTime()
+ * upper bound in ms from the last frame of a node to it being reported
+ * lost, not counting the cycle time of Update()
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint32_t MCLiveWatchdog::GetDetectionTime()
+{
+	return (uint32_t)QuietTime + ProbeWindow;
+}
+
+/*---------------------------------------------------------------------
+ * void Update(uint32_t time)
+ * To be called cyclically with the actual time in ms after the Update()
+ * of the MsgHandler.
+ * A node with a new frame since the last call is alive. A quiet one is
+ * probed once per QuietTime by a shared read of its SW, which joins a
+ * read of the SW already on the wire. A node quiet for longer than the
+ * detection time is lost and is probed further on to notice its return.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCLiveWatchdog::Update(uint32_t time)
+{
+	actTime = time;
+
+	//the time before the first update doesn't count as silence
+	if(!isRunning)
+	{
+		for(uint8_t i = 0; i < Count; i++)
+			LastRxAt[i] = actTime;
+		isRunning = true;
+	}
+
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		uint32_t RxCount = Nodes[i]->ThisNode.GetRxCount();
+
+		if(RxCount != RxSeen[i])
+		{
+			RxSeen[i] = RxCount;
+			LastRxAt[i] = Nodes[i]->ThisNode.GetLastRxAt();
+			SetState(i, eLiveAlive);
+		}
+
+		uint32_t Silence = actTime - LastRxAt[i];
+
+		if((Silence > GetDetectionTime()) && (State[i] != eLiveLost))
+			SetState(i, eLiveLost);
+
+		if((Ticket[i] != 0) || ((Silence > QuietTime) && (actTime - ProbeAt[i] > QuietTime)))
+			Probe(i);
+	}
+}
+
+/*---------------------------------------------------------------------
+ * MCLiveStates GetState(MCDrive *Drive)
+ * uint32_t GetSilence(MCDrive *Drive)
+ * uint32_t GetProbeCount(MCDrive *Drive)
+ * uint32_t GetMissedCount(MCDrive *Drive)
+ * actual state of a drive, ms since its last frame, the number
+ * of probes sent to it and of those which have failed
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW missed probes
+ *--------------------------------------------------------------------*/
+
+MCLiveStates MCLiveWatchdog::GetState(MCDrive *Drive)
+{
+	uint8_t i = FindNode(Drive);
+
+	return (i == MCLiveNone) ? eLiveUnknown : State[i];
+}
+
+uint32_t MCLiveWatchdog::GetSilence(MCDrive *Drive)
+{
+	uint8_t i = FindNode(Drive);
+
+	return (i == MCLiveNone) ? 0 : actTime - LastRxAt[i];
+}
+
+uint32_t MCLiveWatchdog::GetProbeCount(MCDrive *Drive)
+{
+	uint8_t i = FindNode(Drive);
+
+	return (i == MCLiveNone) ? 0 : Probes[i];
+}
+
+uint32_t MCLiveWatchdog::GetMissedCount(MCDrive *Drive)
+{
+	uint8_t i = FindNode(Drive);
+
+	return (i == MCLiveNone) ? 0 : Missed[i];
+}
+
+/*---------------------------------------------------------------------
+ * void Register_OnChangeCb(pfunction_holder *Cb)
+ * Callback to be called with a pointer to a MCLiveEvent whenever a
+ * node changes its state.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCLiveWatchdog::Register_OnChangeCb(pfunction_holder *Cb)
+{
+	OnChangeCb.callback = Cb->callback;
+	OnChangeCb.op = Cb->op;
+}
+
+//--- private functions ---
+
+uint8_t MCLiveWatchdog::FindNode(MCDrive *Drive)
+{
+	for(uint8_t i = 0; i < Count; i++)
+	{
+		if(Nodes[i] == Drive)
+			return i;
+	}
+	return MCLiveNone;
+}
+
+/*---------------------------------------------------------------------
+ * void Probe(uint8_t i)
+ * Start or follow the read of the SW of the node. The response is
+ * registered by the RxCount of the node, so the value is not used.
+ * If the channel is busy with another request, that one will tell
+ * about the node just as well.
+ * A failed probe is counted as missed. It has given up its ticket
+ * already; the channel is left to the owner of the request, which
+ * might not be the watchdog.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW a failure gives up the ticket only
+ *--------------------------------------------------------------------*/
+
+void MCLiveWatchdog::Probe(uint8_t i)
+{
+	uint32_t Value;
+	bool isNew = (Ticket[i] == 0);
+	SDOCommStates state = Nodes[i]->ThisNode.ReadSDOShared(0x6041, 0x00, &Ticket[i], &Value);
+
+	switch(state)
+	{
+		case eSDOWaiting:
+			if(isNew)
+			{
+				ProbeAt[i] = actTime;
+				Probes[i]++;
+
+				#if(DEBUG_LIVE & DEBUG_PROBE)
+				std::printf("Live: probe node %d\n", i);
+				#endif
+			}
+			break;
+		case eSDOError:
+		case eSDOTimeout:
+			#if(DEBUG_LIVE & DEBUG_ERROR)
+			std::printf("Live: probe of node %d failed\n", i);
+			#endif
+			Missed[i]++;
+			break;
+		default:
+			break;
+	}
+}
+
+void MCLiveWatchdog::SetState(uint8_t i, MCLiveStates NewState)
+{
+	if(State[i] == NewState)
+		return;
+
+	State[i] = NewState;
+
+	#if(DEBUG_LIVE & DEBUG_CHANGE)
+	std::printf("Live: node %d %s\n", i, (NewState == eLiveAlive) ? "alive" : "lost");
+	#endif
+
+	if(OnChangeCb.callback != NULL)
+	{
+		MCLiveEvent Event = {Nodes[i], NewState, actTime, actTime - LastRxAt[i]};
+		OnChangeCb.callback(OnChangeCb.op, (void *)&Event);
+	}
+}
@@ -26,9 +26,13 @@
 #define DEBUG_RESET		0x0040
 
 //#define DEBUG_NODE (DEBUG_TO | DEBUG_ERROR | DEBUG_RXSW | DEBUG_TXCW) 
-#define DEBUG_NODE (DEBUG_TO | DEBUG_ERROR) 
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_NODE 0
+#else
+#define DEBUG_NODE (DEBUG_TO | DEBUG_ERROR)
+#endif
 
-typedef struct EMCYMsg {
+typedef struct __attribute__((packed)) EMCYMsg {
    uint8_t u8Prefix  : 8;
    uint8_t u8Len     : 8;
    uint8_t u8NodeNr  : 8;
@@ -65,7 +69,9 @@ const uint16_t MaxSWResponseDelay = 20; //50;
 
 MCNode::MCNode()
 {
-	;
+	OnEmcyCb.callback = NULL;
+	OnEmcyCb.op = NULL;
+	CwTimeOut = CwRespTimeOut;
 }
 
 /*-------------------------------------------------------------------
@@ -186,6 +192,9 @@ void MCNode::ResetComState()
 	TORetryCounter = 0;
 	BusyRetryCounter = 0;
 	AccessStep = 0;
+	CWSWTicket = 0;
+	PullSWTicket = 0;
+	isBurstCw = false;
 	ResetSDOState();
 	
 	if(hasMsgHandlerLocked)
@@ -204,11 +213,13 @@ void MCNode::ResetComState()
  * Default is within the class definition.
  * 
  * 2020-11-21 AW Done
+ * 2026-10-18 AW for the embedded SDOHandler too
  * ----------------------------------------------------------------*/
 
 void MCNode::SetTORetryMax(uint8_t value)
 {
 	TORetryMax = value;
+	RWSDO.SetTORetryMax(value);
 }
 
 /*------------------------------------------------------------------
@@ -219,11 +230,28 @@ void MCNode::SetTORetryMax(uint8_t value)
  * Default is within the class definition.
  * 
  * 2020-11-21 AW Done
+ * 2026-10-18 AW for the embedded SDOHandler too
  * ----------------------------------------------------------------*/
 
 void MCNode::SetBusyRetryMax(uint8_t value)
 {
 	BusyRetryMax = value;
+	RWSDO.SetBusyRetryMax(value);
+}
+
+/*------------------------------------------------------------------
+ * void SetRespTimeOuts(uint16_t SdoTimeOut, uint16_t CwTimeOutMs)
+ * Time in ms the response to a SDO or to a CW may take before the
+ * request is retried. 0 keeps the default of SDORespTimeOut or
+ * CwRespTimeOut.
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+void MCNode::SetRespTimeOuts(uint16_t SdoTimeOut, uint16_t CwTimeOutMs)
+{
+	RWSDO.SetRespTimeOut(SdoTimeOut);
+	CwTimeOut = (CwTimeOutMs > 0) ? CwTimeOutMs : CwRespTimeOut;
 }
 
 /*------------------------------------------------------------------
@@ -235,7 +263,7 @@ void MCNode::SetBusyRetryMax(uint8_t value)
  * Any CW send service has to answered by the drive, which would be
  * received by the OnRxHandler.
  * After a request was accepted by the Msghandler the drive ends up in eCWWaiting.
- * If no response is received after CwRespTimeOut/2 the request will be re-sent.
+ * If no response is received after CwTimeOut/2 the request will be re-sent.
  * When the response was received and an STatusWord response is expected
  * the Node will end up in eCWDone and will pull a StatusWord via SDO serive
  * periodically with the period time <> 0 give as maxSWDelay.
@@ -248,14 +276,24 @@ void MCNode::SetBusyRetryMax(uint8_t value)
  * will only unlock it the actual service failed.
  * Successful servie will unlock in OnRxHandler().
  * 
+ * In SW push mode the drive sends any change of the SW by itself and
+ * the pull is done only if no SW has been received for SWWatchdogTime.
+ * 
  * 2020-11-21 AW Done
+ * 2026-10-18 AW SW is pulled by a shared read
+ * 2026-10-18 AW configurable timeout
+ * 2026-10-18 AW SW push mode
+ * 2026-10-18 AW debug states kept as members
+ * 2026-10-18 AW time of the last SW
+ * 2026-10-18 AW failure of the shared read reported by the node
+ * 2026-10-18 AW the lock of a burst CW is left to its sender
  * ----------------------------------------------------------------*/
 
 CWCommStates MCNode::SendCw(uint16_t Data, uint32_t maxSWDelay = MaxSWResponseDelay)
 {
 	bool doSend = (Data != ControlWord) || firstCWAccess;
 			
-	if((CWAccessState == eCWRetry) && ((CWSentAt + CwRespTimeOut) < actTime) )
+	if((CWAccessState == eCWRetry) && ((CWSentAt + CwTimeOut) < actTime) )
 		doSend = true;
 	
 	//necessary to retrigger the access to the CW in a chain
@@ -272,9 +310,6 @@ CWCommStates MCNode::SendCw(uint16_t Data, uint32_t maxSWDelay = MaxSWResponseDe
 	}
 		
 	#if(DEBUG_NODE & DEBUG_TXCW)
-	static CWCommStates LastCWState;
-	static SDOCommStates LastSDOState;
-
 	if(CWAccessState != LastCWState)
 	{
 		LastCWState = CWAccessState;
@@ -293,10 +328,12 @@ CWCommStates MCNode::SendCw(uint16_t Data, uint32_t maxSWDelay = MaxSWResponseDe
 	switch(CWAccessState)
 	{
 		case eCWWaiting:
-			if((CWSentAt + CwRespTimeOut/2) < actTime)
+			if((CWSentAt + CwTimeOut/2) < actTime)
 			{
 				CWAccessState = eCWRetry;
 				doSend = true;
+				//the resend is a CW of its own
+				isBurstCw = false;
 			}
 			#if(DEBUG_NODE & DEBUG_TXCW)
 			std::printf("W");
@@ -366,8 +403,14 @@ CWCommStates MCNode::SendCw(uint16_t Data, uint32_t maxSWDelay = MaxSWResponseDe
 		case eCWRxResponse:
 			//waiting is handled in eCWDone
 			CWAccessState = eCWDone;
-			Handler->UnLockHandler();
-			hasMsgHandlerLocked = false;
+			//the lock of a burst is released by its sender
+			if(isBurstCw)
+				isBurstCw = false;
+			else
+			{
+				Handler->UnLockHandler();
+				hasMsgHandlerLocked = false;
+			}
 
 			//define time now as the start of the waiting time for SW
 			SWRxAt = actTime;
@@ -375,9 +418,13 @@ CWCommStates MCNode::SendCw(uint16_t Data, uint32_t maxSWDelay = MaxSWResponseDe
 		case eCWDone:
 			//if we stay in this state pull the SW from time to time
 			//only if a non zero waiting time is set
+			//with SW push the pull is a slow watchdog only
 			if(maxSWDelay > 0)
 			{
-				if(SWRxAt < (actTime - maxSWDelay))
+				if(isSWPushMode)
+					maxSWDelay = SWWatchdogTime;
+
+				if((actTime - SWRxAt) > maxSWDelay)
 				{
 					//we might be waiting for a response but the original access
 					//to the SW is finished
@@ -387,27 +434,36 @@ CWCommStates MCNode::SendCw(uint16_t Data, uint32_t maxSWDelay = MaxSWResponseDe
 			}
 			break;
 		case eCWWait4SW:
-			if(SDOAccessState == eSDODone)
-			{
-				StatusWord = (uint16_t)RWSDO.GetObjValue();
-				SWRxAt = actTime;
-				//this access should not be necessary
-				SDOAccessState = RWSDO.GetComState();
-				CWAccessState = eCWDone;
-								
-				#if(DEBUG_NODE & DEBUG_TXCW)
-				std::printf("Node: Send CW: SW pulled ");
-				std::printf("%X\n", StatusWord);
-				#endif
-			}
-			else			
 			{
+				uint32_t Value;
+
 				#if(DEBUG_NODE & DEBUG_TXCW)
-				if(SDOAccessState == eSDOIdle)
+				if(CWSWTicket == 0)
 					std::printf("Node: Send CW: SW Request \n");
 				#endif
 
-				SDOAccessState = RWSDO.ReadSDO(0x6041, 0x00);
+				//shared with any other pending read of the SW
+				SDOAccessState = RWSDO.ReadSDOShared(0x6041, 0x00, &CWSWTicket, &Value);
+
+				if(SDOAccessState == eSDODone)
+				{
+					StatusWord = (uint16_t)Value;
+					SWRxAt = actTime;
+					SWUpdatedAt = actTime;
+					SDOAccessState = eSDOIdle;
+					CWAccessState = eCWDone;
+									
+					#if(DEBUG_NODE & DEBUG_TXCW)
+					std::printf("Node: Send CW: SW pulled ");
+					std::printf("%X\n", StatusWord);
+					#endif
+				}
+				else if((SDOAccessState == eSDOError) || (SDOAccessState == eSDOTimeout))
+				{
+					//the shared read has given up its ticket, the channel is left as it is
+					CWAccessState = (SDOAccessState == eSDOTimeout) ? eCWTimeout : eCWError;
+					SDOAccessState = eSDOIdle;
+				}
 			}
 			break;	
 	}  // end of switch
@@ -421,6 +477,81 @@ CWCommStates MCNode::SendCw(uint16_t Data, uint32_t maxSWDelay = MaxSWResponseDe
 	return RxTxState;
 }
 
+/* --------------------------------------------------------------
+ * MCMsg *PrepareCw(uint16_t Data)
+ * Fill the CW request into the Tx buffer of the node without sending it.
+ * Used to send the CWs of several nodes in a single burst via the
+ * MsgHandler. CwSentExternally() has to be called once it's sent.
+ * 
+ * 2026-10-18 AW Done
+ * ------------------------------------------------------------*/
+
+MCMsg *MCNode::PrepareCw(uint16_t Data)
+{
+	CwMsgBuffer.u8Len = 6;
+	CwMsgBuffer.u8NodeNr = (uint8_t)NodeId;
+	CwMsgBuffer.u8Cmd = eCtrlWord;
+	CwMsgBuffer.Payload = Data;
+
+	return (MCMsg *)&CwMsgBuffer;
+}
+
+/* --------------------------------------------------------------
+ * void CwSentExternally(uint16_t Data, uint32_t TxDelay)
+ * The CW prepared by PrepareCw() has been sent by someone else.
+ * The node waits for the response as if SendCw() had sent it, so
+ * the next SendCw() with the same Data continues from there.
+ * TxDelay is the time in ms until the frame is on the wire completely,
+ * which is later for the frames at the end of a burst.
+ * The lock taken for the burst stays with its sender, which releases
+ * it once no CW of the burst is waiting any longer, see
+ * IsBurstCwWaiting(). A CW resent after a timeout is a CW of its own.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW the lock is left to the sender of the burst
+ * ------------------------------------------------------------*/
+
+void MCNode::CwSentExternally(uint16_t Data, uint32_t TxDelay)
+{
+	isBurstCw = true;
+	CWAccessState = eCWWaiting;
+	ControlWord = Data;
+	firstCWAccess = false;
+	BusyRetryCounter = 0;
+	CWSentAt = actTime + TxDelay;
+	hasMsgHandlerLocked = false;
+}
+
+/* --------------------------------------------------------------
+ * bool IsCwPending()
+ * true while the response to a CW is still expected
+ * 
+ * 2026-10-18 AW Done
+ * ------------------------------------------------------------*/
+
+bool MCNode::IsCwPending()
+{
+	return (CWAccessState == eCWWaiting) || (CWAccessState == eCWRetry);
+}
+
+/* --------------------------------------------------------------
+ * bool IsBurstCwWaiting()
+ * true while the response to a CW sent by CwSentExternally() is
+ * still expected and hasn't timed out yet
+ * 
+ * 2026-10-18 AW Done
+ * ------------------------------------------------------------*/
+
+bool MCNode::IsBurstCwWaiting()
+{
+	return isBurstCw && (CWAccessState == eCWWaiting);
+}
+
+uint8_t MCNode::GetChannel()
+{
+	return Channel;
+}
+
 /* --------------------------------------------------------------
  * PullSW()
  * Is intended to force a cyclic update of the StatusWord in methods
@@ -431,8 +562,14 @@ CWCommStates MCNode::SendCw(uint16_t Data, uint32_t maxSWDelay = MaxSWResponseDe
  * StatusWord and if as expected stop calling this method as soon
  * as it ended up in eCWDone.
  * Needs a call to ResetComState to switch back to eCWIdle.
+ * In SW push mode the pushed SW is used and a pull is done only if
+ * no SW has been received for SWWatchdogTime.
  * 
  * 2020-07-17 AW
+ * 2026-10-18 AW SW is pulled by a shared read
+ * 2026-10-18 AW SW push mode
+ * 2026-10-18 AW time of the last SW
+ * 2026-10-18 AW failure of the shared read reported by the node
  * ------------------------------------------------------------*/
  
 CWCommStates MCNode::PullSW(uint32_t maxSWDelay)
@@ -440,6 +577,12 @@ CWCommStates MCNode::PullSW(uint32_t maxSWDelay)
 	switch(SWAccessState)
 	{
 		case eCWIdle:
+			//with SW push a recent SW is as good as a pulled one
+			if(isSWPushMode && ((actTime - SWRxAt) <= SWWatchdogTime))
+			{
+				SWAccessState = eCWDone;
+				break;
+			}
 			//define time now as the start of the waiting time for SW
 			SWRxAt = actTime;
 			SWAccessState = eCWWait4SW;
@@ -447,7 +590,11 @@ CWCommStates MCNode::PullSW(uint32_t maxSWDelay)
 		case eCWDone:
 			//if we stay in this state pull the SW from time to time
 			//only if a non zero waiting time is set
-			if((SWRxAt < (actTime - maxSWDelay)) && (maxSWDelay > 0))
+			//with SW push the pull is a slow watchdog only
+			if(isSWPushMode)
+				maxSWDelay = SWWatchdogTime;
+
+			if(((actTime - SWRxAt) > maxSWDelay) && (maxSWDelay > 0))
 			{
 				//we might be waiting for a response but the original access
 				//to the SW is finished
@@ -459,28 +606,37 @@ CWCommStates MCNode::PullSW(uint32_t maxSWDelay)
 			}
 			break;
 		case eCWWait4SW:
-			if(SDOAccessState == eSDODone)
-			{
-				//could have a debug option to only print changed responses
-				StatusWord = (uint16_t)RWSDO.GetObjValue();
-				SWRxAt = actTime;
-				//this access should not be necessary
-				SDOAccessState = RWSDO.GetComState();
-				SWAccessState = eCWDone;
-								
-				#if(DEBUG_NODE & DEBUG_RXSW)
-				std::printf("Node: Pull SW: SW pulled ");
-				std::printf("%X\n", StatusWord);
-				#endif
-			}
-			else			
 			{
+				uint32_t Value;
+
 				#if(DEBUG_NODE & DEBUG_RXSW)
-				if(SDOAccessState == eSDOIdle)
+				if(PullSWTicket == 0)
 					std::printf("Node: Pull SW: Send SW Request \n");
 				#endif
 
-				SDOAccessState = RWSDO.ReadSDO(0x6041, 0x00);
+				//shared with any other pending read of the SW
+				SDOAccessState = RWSDO.ReadSDOShared(0x6041, 0x00, &PullSWTicket, &Value);
+
+				if(SDOAccessState == eSDODone)
+				{
+					//could have a debug option to only print changed responses
+					StatusWord = (uint16_t)Value;
+					SWRxAt = actTime;
+					SWUpdatedAt = actTime;
+					SDOAccessState = eSDOIdle;
+					SWAccessState = eCWDone;
+									
+					#if(DEBUG_NODE & DEBUG_RXSW)
+					std::printf("Node: Pull SW: SW pulled ");
+					std::printf("%X\n", StatusWord);
+					#endif
+				}
+				else if((SDOAccessState == eSDOError) || (SDOAccessState == eSDOTimeout))
+				{
+					//the shared read has given up its ticket, the channel is left as it is
+					SWAccessState = (SDOAccessState == eSDOTimeout) ? eCWTimeout : eCWError;
+					SDOAccessState = eSDOIdle;
+				}
 			}
 			break;	
 	}
@@ -494,6 +650,29 @@ CWCommStates MCNode::PullSW(uint32_t maxSWDelay)
 	return RxTxState;
 }
 
+/*------------------------------------------------------------------
+ * void SetSWPushMode(bool enable, uint32_t watchdogTime)
+ * Tell the node whether the drive sends its StatusWord asynchronously
+ * on any change. If so, PullSW() and SendCw() rely on these and pull
+ * the SW via SDO only if there hasn't been any SW for watchdogTime.
+ * The node doesn't configure the drive: enable this only for drives
+ * whose configuration has the asynchronous SW of the UART enabled.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW drive configured by the caller
+ * ----------------------------------------------------------------*/
+
+void MCNode::SetSWPushMode(bool enable, uint32_t watchdogTime)
+{
+	isSWPushMode = enable;
+	SWWatchdogTime = watchdogTime;
+}
+
+bool MCNode::IsSWPushMode()
+{
+	return isSWPushMode;
+}
+
 /*------------------------------------------------------------------
  * CWCommStates SendReset()
  * Send a ResetNode message to the drive.
@@ -584,6 +763,135 @@ uint16_t MCNode::GetLastError()
 	return EMCYCode;
 }
 
+/*------------------------------------------------------------------
+ * uint32_t GetBootCount()
+ * uint32_t GetBootAt()
+ * Number of boot Msgs received so far and the time of the last one.
+ * A changed count tells the drive has lost its configuration.
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+uint32_t MCNode::GetBootCount()
+{
+	return BootCount;
+}
+
+uint32_t MCNode::GetBootAt()
+{
+	return BootAt;
+}
+
+/*------------------------------------------------------------------
+ * uint32_t GetLastRxAt()
+ * uint32_t GetRxCount()
+ * time of the last valid frame of this node of any kind and the
+ * number of them so far, as seen by the MsgHandler
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+uint32_t MCNode::GetLastRxAt()
+{
+	return Handler->GetLastRxAt(Channel);
+}
+
+uint32_t MCNode::GetRxCount()
+{
+	return Handler->GetRxCount(Channel);
+}
+
+/*------------------------------------------------------------------
+ * uint32_t GetSWAge()
+ * ms since the StatusWord has last been received, be it pushed,
+ * pulled or as the response to a CW
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+uint32_t MCNode::GetSWAge()
+{
+	return actTime - SWUpdatedAt;
+}
+
+/*------------------------------------------------------------------
+ * void Register_OnEmcyCb(pfunction_holder *Cb)
+ * Callback to be called from the Rx path with a pointer to the
+ * MCEmcyRecord of each EMCY received. Keep it short.
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+void MCNode::Register_OnEmcyCb(pfunction_holder *Cb)
+{
+	OnEmcyCb.callback = Cb->callback;
+	OnEmcyCb.op = Cb->op;
+}
+
+/*------------------------------------------------------------------
+ * uint8_t ReadEmcy(uint32_t *Next, MCEmcyRecord *Records, uint8_t Max)
+ * Copy up to Max EMCY records starting with the record number *Next
+ * from the ring. *Next is advanced to the next one to be read; start with 0.
+ * Can be called from any thread. Records overwritten by the Rx path
+ * before they could be read are skipped. The oldest record of a full
+ * ring is skipped too, as its slot is the one the next EMCY is written
+ * into before the count is advanced.
+ * Returns the number of records copied.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW the slot being written is never read
+ * ----------------------------------------------------------------*/
+
+uint8_t MCNode::ReadEmcy(uint32_t *Next, MCEmcyRecord *Records, uint8_t Max)
+{
+	uint8_t n = 0;
+	uint32_t Count = EmcyCount.load(std::memory_order_acquire);
+
+	//older ones are gone already
+	if((Count - *Next) >= MCEmcyRingSize)
+		*Next = Count - MCEmcyRingSize + 1;
+
+	while((n < Max) && (*Next != Count))
+	{
+		Records[n] = EmcyRing[*Next % MCEmcyRingSize];
+
+		//the slot might have been overwritten while copying
+		std::atomic_thread_fence(std::memory_order_acquire);
+		Count = EmcyCount.load(std::memory_order_relaxed);
+		if((Count - *Next) >= MCEmcyRingSize)
+		{
+			*Next = Count - MCEmcyRingSize + 1;
+			continue;
+		}
+		(*Next)++;
+		n++;
+	}
+	return n;
+}
+
+uint32_t MCNode::GetEmcyCount()
+{
+	return EmcyCount.load(std::memory_order_acquire);
+}
+
+/*------------------------------------------------------------------
+ * bool IsFaultPending()
+ * true after an EMCY with an error code != 0 has been received and
+ * neither an EMCY with code 0 nor ClearFault() has followed
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+bool MCNode::IsFaultPending()
+{
+	return isFaultPending;
+}
+
+void MCNode::ClearFault()
+{
+	isFaultPending = false;
+}
+
 /*------------------------------------------------------------------
  * SDOCommStates ReadSDO(unsigned int Idx, unsigned char SubIdx)
  * Provide access to the SDO serive of the built-in SDOHandler.
@@ -596,6 +904,19 @@ SDOCommStates MCNode::ReadSDO(unsigned int Idx, unsigned char SubIdx)
 	return RWSDO.ReadSDO(Idx,SubIdx);
 }
 
+/*------------------------------------------------------------------
+ * SDOCommStates ReadSDOShared(unsigned int Idx, unsigned char SubIdx, uint32_t *Ticket, uint32_t *Value)
+ * Provide access to the shared read of the built-in SDOHandler.
+ * Identical reads of different waiters are merged into a single request.
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+SDOCommStates MCNode::ReadSDOShared(unsigned int Idx, unsigned char SubIdx, uint32_t *Ticket, uint32_t *Value)
+{
+	return RWSDO.ReadSDOShared(Idx,SubIdx,Ticket,Value);
+}
+
 /*------------------------------------------------------------------
  * DOCommStates WriteSDO(unsigned int Idx, unsigned char SubIdx, uint32_t * pData,unsigned char len)
  * Provide access to the SDO serive of the built-in SDOHandler.
@@ -608,6 +929,67 @@ SDOCommStates MCNode::WriteSDO(unsigned int Idx, unsigned char SubIdx, uint32_t
 	return RWSDO.WriteSDO(Idx,SubIdx,pData,len);
 }
 
+/*------------------------------------------------------------------
+ * SDOCommStates RunBatch(SDOBatchEntry *Entries, uint8_t count)
+ * Provide access to the batch service of the built-in SDOHandler.
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+SDOCommStates MCNode::RunBatch(SDOBatchEntry *Entries, uint8_t count)
+{
+	return RWSDO.RunBatch(Entries,count);
+}
+
+/*------------------------------------------------------------------
+ * void CancelBatch(SDOBatchEntry *Entries)
+ * Stop a batch of the built-in SDOHandler, see there.
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+void MCNode::CancelBatch(SDOBatchEntry *Entries)
+{
+	RWSDO.CancelBatch(Entries);
+}
+
+/*------------------------------------------------------------------
+ * stream of unhandshaked writes of a single object
+ * Provide access to the stream service of the built-in SDOHandler.
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+void MCNode::StartStream(uint16_t Idx, uint8_t SubIdx, uint8_t len)
+{
+	RWSDO.StartStream(Idx,SubIdx,len);
+}
+
+bool MCNode::StreamValue(uint32_t Value)
+{
+	return RWSDO.StreamValue(Value);
+}
+
+void MCNode::StopStream()
+{
+	RWSDO.StopStream();
+}
+
+uint32_t MCNode::GetStreamSent()
+{
+	return RWSDO.GetStreamSent();
+}
+
+uint32_t MCNode::GetStreamAcks()
+{
+	return RWSDO.GetStreamAcks();
+}
+
+uint32_t MCNode::GetStreamErrors()
+{
+	return RWSDO.GetStreamErrors();
+}
+
 /*------------------------------------------------------------------
  * unsigned long GetObjValue()
  * Provide access to the SDO serive of the built-in SDOHandler.
@@ -632,6 +1014,8 @@ unsigned long MCNode::GetObjValue()
  * non net systems.
  * 
  * 2020-11-21 AW Done
+ * 2026-10-18 AW time of the last SW
+ * 2026-10-18 AW a boot drops a running batch
  * ----------------------------------------------------------------*/
 
 void MCNode::OnRxHandler(MCMsg *Msg)
@@ -646,7 +1030,11 @@ void MCNode::OnRxHandler(MCMsg *Msg)
 			#endif
 			
 			isLive = true;
+			BootAt = actTime;
+			BootCount++;
 			
+			//nothing is on the wire any longer
+			RWSDO.CancelBatch(NULL);
 			RWSDO.ResetComState();
 			ResetComState();
 				
@@ -689,6 +1077,7 @@ void MCNode::OnRxHandler(MCMsg *Msg)
 			//can be received at anytime
 			StatusWord = ((CwSwMsg *)Msg)->Payload;
 			SWRxAt = actTime;
+			SWUpdatedAt = actTime;
 			
 			#if(DEBUG_NODE & DEBUG_RXSW)
 			std::printf("Node: Rx SW ");
@@ -699,6 +1088,7 @@ void MCNode::OnRxHandler(MCMsg *Msg)
 			//does contain valuable data
 			//can be received at anytime
 			EMCYCode = ((EMCYMsg *)Msg)->ErrorCode;
+			StoreEmcy((EMCYMsg *)Msg);
 			
 			#if(DEBUG_NODE & DEBUG_RXEMCY)
 			std::printf("Node: Rx EMCY ");
@@ -728,4 +1118,42 @@ SDOCommStates MCNode::GetSDOState()
 {
 	//check the SDOState
 	return RWSDO.GetComState();
-}
\ No newline at end of file
+}
+
+/*------------------------------------------------------------------
+ * void GetSDOStats(SDOStats *Stats)
+ * counters of the built-in SDOHandler
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+void MCNode::GetSDOStats(SDOStats *Stats)
+{
+	RWSDO.GetStats(Stats);
+}
+
+/*------------------------------------------------------------------
+ * void StoreEmcy(EMCYMsg *Msg)
+ * Keep the full EMCY with its time stamp in the ring, flag the fault
+ * and notify the subscriber. The only writer of the ring.
+ * 
+ * 2026-10-18 AW Done
+ * ----------------------------------------------------------------*/
+
+void MCNode::StoreEmcy(EMCYMsg *Msg)
+{
+	uint32_t Count = EmcyCount.load(std::memory_order_relaxed);
+	MCEmcyRecord *Record = &EmcyRing[Count % MCEmcyRingSize];
+
+	Record->RxAt = actTime;
+	Record->ErrorCode = Msg->ErrorCode;
+	Record->ErrorRegister = Msg->ErrorRegister;
+	Record->FaulhaberErrorReg = Msg->FaulhaberErrorReg;
+	EmcyCount.store(Count + 1, std::memory_order_release);
+
+	//an EMCY with code 0 tells the error has been reset
+	isFaultPending = (Msg->ErrorCode != 0);
+
+	if(OnEmcyCb.callback != NULL)
+		OnEmcyCb.callback(OnEmcyCb.op, (void *)Record);
+}
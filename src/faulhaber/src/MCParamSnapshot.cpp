@@ -0,0 +1,384 @@
+/*---------------------------------------------------
+ * MCParamSnapshot.cpp
+ * implements saving a parameter list of a drive into a
+ * binary snapshot file and the diff-based restore of it
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "faulhaber/MCParamSnapshot.h"
+
+//--- local defines ---
+
+#define DEBUG_SAVE		0x0001
+#define DEBUG_LOAD		0x0002
+#define DEBUG_RESTORE	0x0004
+#define DEBUG_ERROR		0x0008
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_SNAPSHOT 0
+#else
+#define DEBUG_SNAPSHOT (DEBUG_ERROR)
+#endif
+
+const uint8_t MaxPathLen = 255;
+
+//--- public functions ---
+
+/*---------------------------------------------------------------------
+ * MCParamSnapshot()
+ * nothing is mapped initially
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+MCParamSnapshot::MCParamSnapshot()
+{
+	;
+}
+
+MCParamSnapshot::~MCParamSnapshot()
+{
+	Unload();
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates Save(MCDrive *Drive, MCDriveParameter *Parameters, uint8_t count, const char *path)
+ * Upload the given list of objects from the drive and store them
+ * as a snapshot file once all of them have been read.
+ * Is to be called cyclically like any other step sequence of the drive.
+ *
+ * --> will report eMCWaiting/eMCIdle while busy
+ * --> will report eMCDone when the file has been written
+ * --> will report eMCError if the file could not be written
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCParamSnapshot::Save(MCDrive *Drive, MCDriveParameter *Parameters, uint8_t count, const char *path)
+{
+	DriveCommStates state = Drive->UploadParamterList(Parameters, count);
+
+	if(state == eMCDone)
+	{
+		if(!WriteFile(Parameters, count, path))
+			state = eMCError;
+	}
+	return state;
+}
+
+/*---------------------------------------------------------------------
+ * bool Load(const char *path)
+ * Map a snapshot file read-only into memory and validate header
+ * and checksum. The entries are used in place - nothing is copied.
+ * A previously loaded snapshot is unmapped first.
+ * Only files of exactly MCSnapshotVersion are accepted, so a zeroed
+ * header is refused as well.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW match the version exactly
+ *--------------------------------------------------------------------*/
+
+bool MCParamSnapshot::Load(const char *path)
+{
+	struct stat FileStat;
+	void *Map;
+	int fd;
+
+	Unload();
+
+	if((fd = open(path, O_RDONLY)) < 0)
+	{
+		#if(DEBUG_SNAPSHOT & DEBUG_ERROR)
+		std::printf("Snapshot: can't open %s\n", path);
+		#endif
+		return false;
+	}
+
+	if((fstat(fd, &FileStat) != 0) || (FileStat.st_size < (off_t)sizeof(MCSnapshotHdr)))
+	{
+		close(fd);
+		return false;
+	}
+
+	Map = mmap(NULL, FileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	//the mapping stays valid after the descriptor is closed
+	close(fd);
+
+	if(Map == MAP_FAILED)
+		return false;
+
+	MapBase = (const uint8_t *)Map;
+	MapSize = (uint32_t)FileStat.st_size;
+
+	const MCSnapshotHdr *Hdr = (const MCSnapshotHdr *)MapBase;
+	const MCSnapshotEntry *FileEntries = (const MCSnapshotEntry *)(MapBase + sizeof(MCSnapshotHdr));
+
+	if( (Hdr->Magic != MCSnapshotMagic) || (Hdr->Version != MCSnapshotVersion) ||
+		(MapSize != sizeof(MCSnapshotHdr) + Hdr->Count * sizeof(MCSnapshotEntry)) ||
+		(Hdr->Checksum != CalcChecksum(FileEntries, Hdr->Count)) )
+	{
+		#if(DEBUG_SNAPSHOT & DEBUG_ERROR)
+		std::printf("Snapshot: %s is not a valid snapshot\n", path);
+		#endif
+		Unload();
+		return false;
+	}
+
+	Entries = FileEntries;
+	Count = Hdr->Count;
+
+	#if(DEBUG_SNAPSHOT & DEBUG_LOAD)
+	std::printf("Snapshot: %s mapped with %u entries\n", path, Count);
+	#endif
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void Unload()
+ * Release the mapping of the snapshot file.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCParamSnapshot::Unload()
+{
+	if(MapBase != NULL)
+		munmap((void *)MapBase, MapSize);
+
+	MapBase = NULL;
+	MapSize = 0;
+	Entries = NULL;
+	Count = 0;
+	ResetRestore();
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates Restore(MCDrive *Drive)
+ * Write the loaded snapshot onto the drive. Each object is read first
+ * and only written if the value on the drive differs from the snapshot.
+ * Values are compared with the length stored for the object; a length
+ * of 0 is taken as 4 bytes, as it is written as a 32 bit value too.
+ * Uses its own step sequence on top of ReadObject()/WriteObject() of
+ * the drive so it is to be called cyclically.
+ *
+ * --> will report eMCWaiting while busy
+ * --> will report eMCDone when all objects are in line with the snapshot
+ * --> any error or timeout of the drive is reported and restarts the
+ *     restore with the next call after the drive has been reset
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW length 0 compared as 4 bytes
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCParamSnapshot::Restore(MCDrive *Drive)
+{
+	DriveCommStates state = eMCWaiting;
+
+	if((Entries == NULL) || (Drive == NULL))
+		return eMCError;
+
+	if((RestoreStep == 0) && !RestoreWritePending)
+		WriteCount = 0;
+
+	if(RestoreStep < Count)
+	{
+		const MCSnapshotEntry *Entry = &Entries[RestoreStep];
+		uint16_t Idx = Entry->Idx;
+		uint8_t SubIdx = Entry->SubIdx;
+		uint32_t Value = Entry->Value;
+
+		if(!RestoreWritePending)
+		{
+			if((state = Drive->ReadObject(Idx, SubIdx, &ActValue)) == eMCDone)
+			{
+				uint32_t Mask = ((Entry->Len == 0) || (Entry->Len >= 4)) ? 0xFFFFFFFF : ((1UL << (8 * Entry->Len)) - 1);
+
+				if((ActValue & Mask) == (Value & Mask))
+					RestoreStep++;
+				else
+					RestoreWritePending = true;
+
+				state = eMCWaiting;
+
+				#if(DEBUG_SNAPSHOT & DEBUG_RESTORE)
+				std::printf("Snapshot: %X.%X is %X, snapshot %X\n", Idx, SubIdx, ActValue, Value);
+				#endif
+			}
+		}
+		else
+		{
+			switch(Entry->Len)
+			{
+				case 1:
+					state = Drive->WriteObject(Idx, SubIdx, (uint8_t)Value);
+					break;
+				case 2:
+					state = Drive->WriteObject(Idx, SubIdx, (uint16_t)Value);
+					break;
+				default:
+					state = Drive->WriteObject(Idx, SubIdx, (uint32_t)Value);
+					break;
+			}
+
+			if(state == eMCDone)
+			{
+				WriteCount++;
+				RestoreWritePending = false;
+				RestoreStep++;
+				state = eMCWaiting;
+
+				#if(DEBUG_SNAPSHOT & DEBUG_RESTORE)
+				std::printf("Snapshot: %X.%X restored\n", Idx, SubIdx);
+				#endif
+			}
+		}
+
+		if((state == eMCError) || (state == eMCTimeout))
+		{
+			ResetRestore();
+			return state;
+		}
+	}
+
+	if(RestoreStep >= Count)
+	{
+		RestoreStep = 0;
+		state = eMCDone;
+	}
+
+	return state;
+}
+
+/*---------------------------------------------------------------------
+ * void ResetRestore()
+ * Restart a restore from the first entry with the next call.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCParamSnapshot::ResetRestore()
+{
+	RestoreStep = 0;
+	RestoreWritePending = false;
+}
+
+bool MCParamSnapshot::IsLoaded()
+{
+	return (Entries != NULL);
+}
+
+uint8_t MCParamSnapshot::GetCount()
+{
+	return Count;
+}
+
+const MCSnapshotEntry *MCParamSnapshot::GetEntries()
+{
+	return Entries;
+}
+
+/*---------------------------------------------------------------------
+ * uint8_t GetWriteCount()
+ * Number of objects which had to be written during the last restore.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint8_t MCParamSnapshot::GetWriteCount()
+{
+	return WriteCount;
+}
+
+//-------------------------------------------------------------------
+//---- private functions --------
+//-------------------------------------------------------------------
+
+/*---------------------------------------------------------------------
+ * bool WriteFile(MCDriveParameter *Parameters, uint8_t count, const char *path)
+ * Write header and entries into a temporary file and move it over
+ * the target so a mapped older version is never seen half written.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCParamSnapshot::WriteFile(MCDriveParameter *Parameters, uint8_t count, const char *path)
+{
+	MCSnapshotEntry FileEntries[255];
+	MCSnapshotHdr Hdr;
+	char TmpPath[MaxPathLen + 5];
+	ssize_t len;
+	int fd;
+
+	if(std::snprintf(TmpPath, sizeof(TmpPath), "%s.tmp", path) >= (int)sizeof(TmpPath))
+		return false;
+
+	for(uint8_t i = 0; i < count; i++)
+	{
+		FileEntries[i].Idx = Parameters[i].index;
+		FileEntries[i].SubIdx = Parameters[i].subIndex;
+		FileEntries[i].Len = Parameters[i].length;
+		FileEntries[i].Value = Parameters[i].value;
+	}
+
+	Hdr.Magic = MCSnapshotMagic;
+	Hdr.Version = MCSnapshotVersion;
+	Hdr.Count = count;
+	Hdr.Reserved = 0;
+	Hdr.Checksum = CalcChecksum(FileEntries, count);
+
+	if((fd = open(TmpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+	{
+		#if(DEBUG_SNAPSHOT & DEBUG_ERROR)
+		std::printf("Snapshot: can't create %s\n", TmpPath);
+		#endif
+		return false;
+	}
+
+	len = write(fd, &Hdr, sizeof(Hdr));
+	len += write(fd, FileEntries, count * sizeof(MCSnapshotEntry));
+	close(fd);
+
+	if((len != (ssize_t)(sizeof(Hdr) + count * sizeof(MCSnapshotEntry))) || (rename(TmpPath, path) != 0))
+	{
+		unlink(TmpPath);
+		return false;
+	}
+
+	#if(DEBUG_SNAPSHOT & DEBUG_SAVE)
+	std::printf("Snapshot: %u entries saved to %s\n", count, path);
+	#endif
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * uint32_t CalcChecksum(const MCSnapshotEntry *Entries, uint8_t count)
+ * Adler-32 over the entries of a snapshot.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint32_t MCParamSnapshot::CalcChecksum(const MCSnapshotEntry *FileEntries, uint8_t count)
+{
+	const uint8_t *buffer = (const uint8_t *)FileEntries;
+	uint32_t len = count * sizeof(MCSnapshotEntry);
+	uint32_t a = 1;
+	uint32_t b = 0;
+
+	for(uint32_t i = 0; i < len; i++)
+	{
+		a = (a + buffer[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	return (b << 16) | a;
+}
@@ -0,0 +1,423 @@
+/*---------------------------------------------------
+ * MCPollScheduler.cpp
+ * implements the cyclic reading of registered objects
+ * by priority and earliest deadline first per node
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cstdio>
+#include "faulhaber/MCPollScheduler.h"
+
+//--- local defines ---
+
+#define DEBUG_REG		0x0001
+#define DEBUG_POLL		0x0002
+#define DEBUG_MISS		0x0004
+#define DEBUG_ERROR		0x0008
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_POLLSCHED 0
+#else
+#define DEBUG_POLLSCHED (DEBUG_ERROR)
+#endif
+
+//bytes on the wire for a read request and its response of 4 bytes
+const uint8_t PollRqBytes = 9;
+const uint8_t PollRespBytes = 13;
+
+//--- public functions ---
+
+/*---------------------------------------------------------------------
+ * MCPollScheduler()
+ * no nodes and no entries registered
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+MCPollScheduler::MCPollScheduler()
+{
+	for(uint8_t i = 0; i < MCPollMaxNodes; i++)
+	{
+		Nodes[i] = NULL;
+		NodeEnabled[i] = false;
+		InFlight[i] = MCPollNone;
+		Ticket[i] = 0;
+		Snapshot[i].Count = 0;
+		SnapshotSeq[i].store(0);
+	}
+	OnMissCb.callback = NULL;
+	OnMissCb.op = NULL;
+}
+
+/*---------------------------------------------------------------------
+ * uint8_t RegisterObject(MCDrive *Drive, uint16_t Idx, uint8_t SubIdx, uint16_t RateHz)
+ * Register an object of a drive to be read with the given rate.
+ * The first object of a drive registers the drive as a node too.
+ * Returns the handle of the entry or MCPollNone if no slot is left.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint8_t MCPollScheduler::RegisterObject(MCDrive *Drive, uint16_t Idx, uint8_t SubIdx, uint16_t RateHz)
+{
+	uint8_t NodeSlot = FindNode(Drive);
+
+	if((EntryCount >= MCPollMaxEntries) || (RateHz == 0) || (RateHz > 1000))
+		return MCPollNone;
+
+	if(NodeSlot == MCPollNone)
+	{
+		for(uint8_t i = 0; i < MCPollMaxNodes; i++)
+		{
+			if(Nodes[i] == NULL)
+			{
+				Nodes[i] = Drive;
+				NodeEnabled[i] = true;
+				NodeSlot = i;
+				break;
+			}
+		}
+		if(NodeSlot == MCPollNone)
+			return MCPollNone;
+	}
+
+	MCPollEntry *Entry = &Entries[EntryCount];
+	MCPollNodeSnapshot *Node = &Snapshot[NodeSlot];
+
+	Entry->Idx = Idx;
+	Entry->SubIdx = SubIdx;
+	Entry->NodeSlot = NodeSlot;
+	Entry->SampleSlot = Node->Count;
+	Entry->Period = 1000 / RateHz;
+	Entry->Priority = 0;
+	Entry->Deadline = actTime;
+	Entry->Missed = 0;
+
+	Node->Samples[Node->Count].Idx = Idx;
+	Node->Samples[Node->Count].SubIdx = SubIdx;
+	Node->Samples[Node->Count].isValid = false;
+	Node->Count++;
+
+	#if(DEBUG_POLLSCHED & DEBUG_REG)
+	std::printf("Poll: %X.%X every %u ms as %u\n", Idx, SubIdx, Entry->Period, EntryCount);
+	#endif
+
+	return EntryCount++;
+}
+
+/*---------------------------------------------------------------------
+ * bool SetPriority(uint8_t Handle, uint8_t Priority)
+ * Of the entries of a node which are due, those with a higher priority
+ * are read first, e.g. the position before a temperature. Entries of
+ * the same priority are read earliest deadline first.
+ * --> false for an invalid handle
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCPollScheduler::SetPriority(uint8_t Handle, uint8_t Priority)
+{
+	if(Handle >= EntryCount)
+		return false;
+
+	Entries[Handle].Priority = Priority;
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void SetNodeEnabled(MCDrive *Drive, bool enable)
+ * Pause or resume the polling of a node. A read already on the wire
+ * is still collected.
+ * As the reads are shared reads of the SDO channel they do not
+ * interfere with any step sequence of the drive itself.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCPollScheduler::SetNodeEnabled(MCDrive *Drive, bool enable)
+{
+	uint8_t NodeSlot = FindNode(Drive);
+
+	if(NodeSlot != MCPollNone)
+		NodeEnabled[NodeSlot] = enable;
+}
+
+/*---------------------------------------------------------------------
+ * bool IsNodeIdle(MCDrive *Drive)
+ * true if no read of the scheduler is pending for this drive
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCPollScheduler::IsNodeIdle(MCDrive *Drive)
+{
+	uint8_t NodeSlot = FindNode(Drive);
+
+	return (NodeSlot == MCPollNone) || (Ticket[NodeSlot] == 0);
+}
+
+/*---------------------------------------------------------------------
+ * void Update(uint32_t time)
+ * To be called cyclically after the MsgHandler has been updated.
+ * Collects finished reads and immediately issues the next due read
+ * of the same node, so the bus time of a cycle is used for as many
+ * reads as possible. Reads are shared reads so a read of the same
+ * object by any other part of the node is merged with it.
+ * The node to start with rotates so that no node is starved by the
+ * lock of the MsgHandler.
+ * A failed read gives up its ticket only; the channel is left to the
+ * owner of the request, which might not be the scheduler.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW don't reset the channel at a failure
+ *--------------------------------------------------------------------*/
+
+void MCPollScheduler::Update(uint32_t time)
+{
+	actTime = time;
+
+	//entries registered before the first update are released now
+	if(!isRunning)
+	{
+		for(uint8_t i = 0; i < EntryCount; i++)
+			Entries[i].Deadline = actTime;
+		isRunning = true;
+	}
+
+	for(uint8_t n = 0; n < MCPollMaxNodes; n++)
+	{
+		uint8_t NodeSlot = (FirstNode + n) % MCPollMaxNodes;
+		MCDrive *Drive = Nodes[NodeSlot];
+
+		if(Drive == NULL)
+			continue;
+
+		//collect a finished read and directly start the next due one
+		for(uint8_t pass = 0; pass < 2; pass++)
+		{
+			uint32_t Value;
+
+			//as long as nothing is on the wire the most urgent entry is picked
+			if(Ticket[NodeSlot] == 0)
+				InFlight[NodeSlot] = NodeEnabled[NodeSlot] ? FindDueEntry(NodeSlot) : MCPollNone;
+
+			uint8_t Handle = InFlight[NodeSlot];
+
+			if(Handle == MCPollNone)
+				break;
+
+			SDOCommStates state = Drive->ThisNode.ReadSDOShared(Entries[Handle].Idx, Entries[Handle].SubIdx, &Ticket[NodeSlot], &Value);
+
+			if(state == eSDODone)
+			{
+				Publish(Handle, Value);
+				CheckDeadline(Handle);
+				InFlight[NodeSlot] = MCPollNone;
+				continue;
+			}
+			else if((state == eSDOError) || (state == eSDOTimeout))
+			{
+				#if(DEBUG_POLLSCHED & DEBUG_ERROR)
+				std::printf("Poll: read of %X failed\n", Entries[Handle].Idx);
+				#endif
+				CheckDeadline(Handle);
+				InFlight[NodeSlot] = MCPollNone;
+				Ticket[NodeSlot] = 0;
+			}
+			#if(DEBUG_POLLSCHED & DEBUG_POLL)
+			else if(state == eSDOWaiting)
+				std::printf("Poll: %X.%X requested\n", Entries[Handle].Idx, Entries[Handle].SubIdx);
+			#endif
+			break;
+		}
+	}
+	FirstNode = (FirstNode + 1) % MCPollMaxNodes;
+}
+
+/*---------------------------------------------------------------------
+ * bool ReadSnapshot(MCDrive *Drive, MCPollNodeSnapshot *Copy)
+ * Copy the latest samples of a node. Can be called from any thread;
+ * the copy is repeated if it overlapped with an update.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCPollScheduler::ReadSnapshot(MCDrive *Drive, MCPollNodeSnapshot *Copy)
+{
+	uint8_t NodeSlot = FindNode(Drive);
+	uint32_t seq;
+
+	if(NodeSlot == MCPollNone)
+		return false;
+
+	do
+	{
+		seq = SnapshotSeq[NodeSlot].load(std::memory_order_acquire);
+		*Copy = Snapshot[NodeSlot];
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while((seq & 1) || (seq != SnapshotSeq[NodeSlot].load(std::memory_order_relaxed)));
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * bool GetSample(uint8_t Handle, MCPollSample *Sample)
+ * Read the latest sample of a single entry.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCPollScheduler::GetSample(uint8_t Handle, MCPollSample *Sample)
+{
+	MCPollNodeSnapshot Copy;
+
+	if((Handle >= EntryCount) || !ReadSnapshot(Nodes[Entries[Handle].NodeSlot], &Copy))
+		return false;
+
+	*Sample = Copy.Samples[Entries[Handle].SampleSlot];
+	return Sample->isValid;
+}
+
+uint32_t MCPollScheduler::GetMissedCount(uint8_t Handle)
+{
+	return (Handle < EntryCount) ? Entries[Handle].Missed : 0;
+}
+
+/*---------------------------------------------------------------------
+ * uint16_t GetLoadPermille(uint32_t baud)
+ * Estimate of the share of the bus time the registered reads need
+ * at the given baud rate. Anything close to 1000 will miss deadlines.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+uint16_t MCPollScheduler::GetLoadPermille(uint32_t baud)
+{
+	//10 bits per byte on the wire, time in us
+	uint32_t ReadTime = (uint32_t)(PollRqBytes + PollRespBytes) * 10 * 1000000UL / baud;
+	uint32_t Load = 0;
+
+	for(uint8_t i = 0; i < EntryCount; i++)
+		Load += ReadTime / Entries[i].Period;
+
+	return (uint16_t)Load;
+}
+
+/*---------------------------------------------------------------------
+ * void Register_OnMissCb(ifunction_holder *Cb)
+ * callback to be called with the entry handle whenever a deadline
+ * has been missed
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCPollScheduler::Register_OnMissCb(ifunction_holder *Cb)
+{
+	OnMissCb.callback = Cb->callback;
+	OnMissCb.op = Cb->op;
+}
+
+//-------------------------------------------------------------------
+//---- private functions --------
+//-------------------------------------------------------------------
+
+uint8_t MCPollScheduler::FindNode(MCDrive *Drive)
+{
+	for(uint8_t i = 0; i < MCPollMaxNodes; i++)
+	{
+		if((Drive != NULL) && (Nodes[i] == Drive))
+			return i;
+	}
+	return MCPollNone;
+}
+
+/*---------------------------------------------------------------------
+ * uint8_t FindDueEntry(uint8_t NodeSlot)
+ * Among the entries of a node which are released (their deadline
+ * minus one period has passed) pick the one with the highest priority
+ * and of those the one with the earliest deadline.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW priority
+ *--------------------------------------------------------------------*/
+
+uint8_t MCPollScheduler::FindDueEntry(uint8_t NodeSlot)
+{
+	uint8_t Handle = MCPollNone;
+
+	for(uint8_t i = 0; i < EntryCount; i++)
+	{
+		MCPollEntry *Entry = &Entries[i];
+
+		if((Entry->NodeSlot == NodeSlot) && ((int32_t)(actTime - (Entry->Deadline - Entry->Period)) >= 0))
+		{
+			if((Handle == MCPollNone) || (Entry->Priority > Entries[Handle].Priority) ||
+				((Entry->Priority == Entries[Handle].Priority) && ((int32_t)(Entry->Deadline - Entries[Handle].Deadline) < 0)))
+				Handle = i;
+		}
+	}
+	return Handle;
+}
+
+/*---------------------------------------------------------------------
+ * void Publish(uint8_t Handle, uint32_t Value)
+ * Store a received value in the snapshot of its node.
+ * The sequence counter is odd while the snapshot is written.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCPollScheduler::Publish(uint8_t Handle, uint32_t Value)
+{
+	MCPollEntry *Entry = &Entries[Handle];
+	MCPollSample *Sample = &Snapshot[Entry->NodeSlot].Samples[Entry->SampleSlot];
+	uint32_t seq = SnapshotSeq[Entry->NodeSlot].load(std::memory_order_relaxed);
+
+	SnapshotSeq[Entry->NodeSlot].store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Sample->Value = Value;
+	Sample->RxAt = actTime;
+	Sample->isValid = true;
+
+	SnapshotSeq[Entry->NodeSlot].store(seq + 2, std::memory_order_release);
+
+	#if(DEBUG_POLLSCHED & DEBUG_POLL)
+	std::printf("Poll: %X.%X = %X\n", Entry->Idx, Entry->SubIdx, Value);
+	#endif
+}
+
+/*---------------------------------------------------------------------
+ * void CheckDeadline(uint8_t Handle)
+ * A read is on time if it finished before its deadline. Move the
+ * deadline on by one period and count every period which has
+ * been skipped entirely as missed too. The callback is called once
+ * per late read.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCPollScheduler::CheckDeadline(uint8_t Handle)
+{
+	MCPollEntry *Entry = &Entries[Handle];
+
+	if((int32_t)(actTime - Entry->Deadline) > 0)
+	{
+		uint32_t late = (actTime - Entry->Deadline - 1) / Entry->Period + 1;
+
+		Entry->Missed += late;
+		Entry->Deadline += late * Entry->Period;
+
+		#if(DEBUG_POLLSCHED & DEBUG_MISS)
+		std::printf("Poll: %X.%X missed %u\n", Entry->Idx, Entry->SubIdx, late);
+		#endif
+
+		if(OnMissCb.callback != NULL)
+			OnMissCb.callback(OnMissCb.op, Handle);
+	}
+	Entry->Deadline += Entry->Period;
+}
@@ -0,0 +1,242 @@
+/*---------------------------------------------------
+ * MCSetpointStream.cpp
+ * implements the streaming of setpoints in the
+ * cyclic synchronous modes
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cstdio>
+#include "faulhaber/MCSetpointStream.h"
+
+//--- local defines ---
+
+#define DEBUG_START		0x0001
+#define DEBUG_LATE		0x0002
+#define DEBUG_ERROR		0x0004
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_STREAM 0
+#else
+#define DEBUG_STREAM (DEBUG_ERROR)
+#endif
+
+//a 4 byte SDO write request is 13 bytes on the wire, its response 9 bytes
+//each byte is a start bit, 8 data bits and a stop bit
+const uint32_t StreamBitsPerSetpoint = (13 + 9) * 10;
+//the bus is held until the response: time in us the drive takes to
+//answer and the response takes until it is handled by the next cycle
+const uint32_t StreamTurnAroundUs = 1000;
+//share of the bus the stream may use; the rest is left for SW and others
+const uint32_t StreamMaxLoadPercent = 80;
+
+//--- public functions ---
+
+MCSetpointStream::MCSetpointStream()
+{
+	OnLateCb.callback = NULL;
+	OnLateCb.op = NULL;
+}
+
+/*---------------------------------------------------------------------
+ * void Connect2Drive(MCDrive *ThisDrive)
+ * the drive to stream to - has to be connected to its MsgHandler already
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCSetpointStream::Connect2Drive(MCDrive *ThisDrive)
+{
+	Drive = ThisDrive;
+}
+
+/*---------------------------------------------------------------------
+ * DriveCommStates Configure(int8_t OpMode, uint8_t PeriodMs)
+ * Switch the drive to CSP or CSV with the interpolation period of the
+ * stream. Has to be called cyclically until eMCDone.
+ * The drive is reset when done.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+DriveCommStates MCSetpointStream::Configure(int8_t OpMode, uint8_t PeriodMs)
+{
+	DriveCommStates State;
+
+	if((Drive == NULL) || (PeriodMs == 0))
+		return eMCError;
+
+	State = Drive->SetCyclicMode(OpMode, PeriodMs);
+
+	if(State == eMCDone)
+	{
+		Drive->ResetComState();
+		Mode = OpMode;
+		Period = PeriodMs;
+		isConfigured = true;
+
+		#if(DEBUG_STREAM & DEBUG_START)
+		std::printf("Stream: mode %d at %u ms\n", Mode, Period);
+		#endif
+	}
+	return State;
+}
+
+/*---------------------------------------------------------------------
+ * bool Start()
+ * Prepare the stream frames. The first setpoint is sent with the next
+ * Update(), the following ones each Period ms.
+ * The drive has to be configured and enabled.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCSetpointStream::Start()
+{
+	if(!isConfigured)
+		return false;
+
+	if(Mode == MCStreamCSP)
+		Drive->ThisNode.StartStream(0x607A, 0x00, 4);
+	else
+		Drive->ThisNode.StartStream(0x60FF, 0x00, 4);
+
+	Late = 0;
+	Dropped = 0;
+	MaxLateness = 0;
+	isFirst = true;
+	isRunning = true;
+
+	return true;
+}
+
+void MCSetpointStream::Stop()
+{
+	if(isRunning)
+		Drive->ThisNode.StopStream();
+	isRunning = false;
+}
+
+/*---------------------------------------------------------------------
+ * bool Update(uint32_t time, int32_t Setpoint)
+ * To be called cyclically with the actual time in ms and the setpoint
+ * for that time. The setpoint is sent when due, so the caller can run
+ * at any rate faster than the stream period.
+ * Periods passed without a call are counted as dropped; a setpoint
+ * sent more than half a period after its deadline as late. Either is
+ * reported to the OnLateCb with the lateness in ms.
+ * If the bus is in use by a request, the setpoint is retried with the
+ * next call.
+ * --> true if the setpoint has been sent
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCSetpointStream::Update(uint32_t time, int32_t Setpoint)
+{
+	uint32_t Lateness;
+	uint32_t Missed;
+
+	if(!isRunning)
+		return false;
+
+	if(isFirst)
+	{
+		NextDue = time;
+		isFirst = false;
+	}
+
+	if((int32_t)(time - NextDue) < 0)
+		return false;
+
+	if(!Drive->ThisNode.StreamValue((uint32_t)Setpoint))
+		return false;
+
+	Lateness = time - NextDue;
+	Missed = Lateness / Period;
+	Lateness -= Missed * Period;
+	NextDue += (Missed + 1) * Period;
+
+	if(Lateness > MaxLateness)
+		MaxLateness = Lateness;
+
+	Dropped += Missed;
+	if(Lateness > (uint32_t)(Period / 2))
+		Late++;
+
+	if((Missed > 0) || (Lateness > (uint32_t)(Period / 2)))
+	{
+		#if(DEBUG_STREAM & DEBUG_LATE)
+		std::printf("Stream: %u dropped, %u ms late\n", Missed, Lateness);
+		#endif
+
+		if(OnLateCb.callback != NULL)
+			OnLateCb.callback(OnLateCb.op, (int)(Missed * Period + Lateness));
+	}
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void GetStats(MCStreamStats *Stats)
+ * counters of the stream since Start().
+ * The last setpoint sent may still be waiting for its response and is
+ * not counted as unacknowledged.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCSetpointStream::GetStats(MCStreamStats *Stats)
+{
+	Stats->Sent = Drive->ThisNode.GetStreamSent();
+	Stats->Acked = Drive->ThisNode.GetStreamAcks();
+	Stats->Errors = Drive->ThisNode.GetStreamErrors();
+	Stats->Late = Late;
+	Stats->Dropped = Dropped;
+	Stats->MaxLateness = MaxLateness;
+
+	uint32_t Answered = Stats->Acked + Stats->Errors + 1;
+	Stats->Unacked = (Stats->Sent > Answered) ? Stats->Sent - Answered : 0;
+}
+
+void MCSetpointStream::Register_OnLateCb(ifunction_holder *Cb)
+{
+	OnLateCb.callback = Cb->callback;
+	OnLateCb.op = Cb->op;
+}
+
+/*---------------------------------------------------------------------
+ * uint16_t GetMaxRateHz(uint32_t BaudRate)
+ * The rate at which setpoints with their responses fill the bus
+ * completely. Each setpoint holds the bus for the request, the
+ * turnaround of the drive and the response, so this is 343 Hz at
+ * 115200 Bd and 80 Hz at 19200 Bd.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW including the turnaround
+ *--------------------------------------------------------------------*/
+
+uint16_t MCSetpointStream::GetMaxRateHz(uint32_t BaudRate)
+{
+	uint64_t SetpointUs = (uint64_t)StreamBitsPerSetpoint * 1000000UL / BaudRate + StreamTurnAroundUs;
+
+	return (uint16_t)(1000000UL / SetpointUs);
+}
+
+/*---------------------------------------------------------------------
+ * bool IsRateAchievable(uint32_t BaudRate)
+ * true if the configured period leaves a sufficient part of the bus
+ * for the StatusWord and other requests
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCSetpointStream::IsRateAchievable(uint32_t BaudRate)
+{
+	if(Period == 0)
+		return false;
+
+	return (1000 / Period) * 100 <= GetMaxRateHz(BaudRate) * StreamMaxLoadPercent;
+}
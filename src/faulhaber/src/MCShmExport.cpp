@@ -0,0 +1,247 @@
+/*---------------------------------------------------
+ * MCShmExport.cpp
+ * implements the export of the node states into a
+ * POSIX shared memory region
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "faulhaber/MCShmExport.h"
+
+//--- local defines ---
+
+#define DEBUG_OPEN		0x0001
+#define DEBUG_ERROR		0x0002
+
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_SHM 0
+#else
+#define DEBUG_SHM (DEBUG_ERROR)
+#endif
+
+//tries to lock a region which its owner removes meanwhile
+const uint8_t MCShmClaimTries = 3;
+
+//--- public functions ---
+
+MCShmExport::~MCShmExport()
+{
+	Close();
+}
+
+/*---------------------------------------------------------------------
+ * bool Open(const char *ShmName, uint8_t NodeCount)
+ * Create the region, e.g. "/faulhaber_arm", readable by everyone and
+ * writable by this process only. The writer owns it by an exclusive
+ * lock held until Close(), which the system drops when the writer
+ * dies. So a region left by a writer no longer running is taken over
+ * and cleared; one locked by another writer is left alone. A region
+ * removed by its owner between the open and the lock is opened anew.
+ * The region is published to the readers by SetClockBase(), the nodes
+ * are valid once they have been written.
+ * --> false if the region can't be created or is in use
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW region of a running writer not taken over
+ * 2026-10-18 AW published by SetClockBase()
+ * 2026-10-18 AW owned by a lock
+ *--------------------------------------------------------------------*/
+
+bool MCShmExport::Open(const char *ShmName, uint8_t NodeCount)
+{
+	if(Region != NULL)
+		Close();
+	if((NodeCount > MCShmMaxNodes) || (std::strlen(ShmName) >= sizeof(Name)))
+		return false;
+
+	int fd = -1;
+	for(uint8_t i = 0; i < MCShmClaimTries; i++)
+	{
+		fd = shm_open(ShmName, O_CREAT | O_RDWR, 0644);
+		if(fd < 0)
+			break;
+
+		if(flock(fd, LOCK_EX | LOCK_NB) != 0)
+		{
+			#if(DEBUG_SHM & DEBUG_ERROR)
+			std::printf("Shm: %s in use by a running writer\n", ShmName);
+			#endif
+			close(fd);
+			return false;
+		}
+		if(IsNamed(fd, ShmName))
+			break;
+
+		close(fd);
+		fd = -1;
+	}
+	if(fd < 0)
+	{
+		#if(DEBUG_SHM & DEBUG_ERROR)
+		std::printf("Shm: can't create %s\n", ShmName);
+		#endif
+		return false;
+	}
+
+	void *Map = MAP_FAILED;
+	if(ftruncate(fd, sizeof(MCShmRegion)) == 0)
+		Map = mmap(NULL, sizeof(MCShmRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if(Map == MAP_FAILED)
+	{
+		#if(DEBUG_SHM & DEBUG_ERROR)
+		std::printf("Shm: can't map %s\n", ShmName);
+		#endif
+		shm_unlink(ShmName);
+		close(fd);
+		return false;
+	}
+
+	//without the magic until SetClockBase(), so no reader takes it meanwhile
+	std::memset(Map, 0, sizeof(MCShmRegion));
+	Region = new(Map) MCShmRegion;
+	Region->Version = MCShmVersion;
+	Region->NodeCount = NodeCount;
+	Region->TimeScale = 1;
+	Region->WriterPid = (uint32_t)getpid();
+	for(uint8_t i = 0; i < MCShmMaxNodes; i++)
+		Region->Node[i].Seq.store(0, std::memory_order_relaxed);
+	Region->Heartbeat.store(0, std::memory_order_relaxed);
+
+	std::strcpy(Name, ShmName);
+	Fd = fd;
+
+	#if(DEBUG_SHM & DEBUG_OPEN)
+	std::printf("Shm: %s with %u nodes\n", Name, NodeCount);
+	#endif
+
+	return true;
+}
+
+/*---------------------------------------------------------------------
+ * void Close()
+ * Unmap and remove the region. Readers still mapping it keep the last
+ * state, with the heartbeat no longer advancing.
+ * The lock is given up only after the region has been removed, so no
+ * other writer takes over the region on its way out.
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW lock given up last
+ *--------------------------------------------------------------------*/
+
+void MCShmExport::Close()
+{
+	if(Region == NULL)
+		return;
+
+	munmap(Region, sizeof(MCShmRegion));
+	shm_unlink(Name);
+	close(Fd);
+	Region = NULL;
+	Fd = -1;
+	Name[0] = 0;
+}
+
+bool MCShmExport::IsOpen()
+{
+	return Region != NULL;
+}
+
+/*---------------------------------------------------------------------
+ * bool SetClockBase(uint64_t BaseNs, uint16_t TimeScale)
+ * the CLOCK_MONOTONIC time the bus time starts at and how much faster
+ * than real time it runs. Set by the MCBus when it is opened.
+ * Both are written before the magic, which publishes the region, so a
+ * reader never sees them half written. They can't change later on,
+ * so the region has to be opened anew for the next clock base.
+ * --> false if the region isn't open or has been published already
+ *
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW publishes the region
+ *--------------------------------------------------------------------*/
+
+bool MCShmExport::SetClockBase(uint64_t BaseNs, uint16_t TimeScale)
+{
+	if((Region == NULL) || (Region->Magic == MCShmMagic))
+		return false;
+
+	Region->ClockBaseNs = BaseNs;
+	Region->TimeScale = TimeScale;
+	std::atomic_thread_fence(std::memory_order_release);
+	Region->Magic = MCShmMagic;
+
+	#if(DEBUG_SHM & DEBUG_OPEN)
+	std::printf("Shm: %s published\n", Name);
+	#endif
+
+	return true;
+}
+
+void MCShmExport::SetHeartbeat(uint32_t time)
+{
+	if(Region != NULL)
+		Region->Heartbeat.store(time, std::memory_order_release);
+}
+
+/*---------------------------------------------------------------------
+ * void Write(uint8_t Slot, const MCShmNodeState *State)
+ * Publish the state of a node. Takes constant time and never waits;
+ * the counter is odd while the block is written.
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+void MCShmExport::Write(uint8_t Slot, const MCShmNodeState *State)
+{
+	if((Region == NULL) || (Slot >= Region->NodeCount))
+		return;
+
+	MCShmNodeBlock *Block = &Region->Node[Slot];
+	uint32_t seq = Block->Seq.load(std::memory_order_relaxed);
+
+	Block->Seq.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Block->State = *State;
+
+	Block->Seq.store(seq + 2, std::memory_order_release);
+}
+
+//--- private functions ---
+
+/*---------------------------------------------------------------------
+ * bool IsNamed(int fd, const char *ShmName)
+ * whether fd is still the region named ShmName, and not one which has
+ * been removed by its owner since fd has been opened
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCShmExport::IsNamed(int fd, const char *ShmName)
+{
+	struct stat Locked;
+	struct stat Named;
+	bool isSame = false;
+
+	int NameFd = shm_open(ShmName, O_RDONLY, 0);
+	if(NameFd < 0)
+		return false;
+
+	if((fstat(fd, &Locked) == 0) && (fstat(NameFd, &Named) == 0))
+		isSame = (Locked.st_dev == Named.st_dev) && (Locked.st_ino == Named.st_ino);
+	close(NameFd);
+
+	return isSame;
+}
@@ -0,0 +1,137 @@
+/*---------------------------------------------------
+ * MCShmReader.cpp
+ * implements the reading of the node states from the
+ * region of a MCShmExport
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "faulhaber/MCShmReader.h"
+
+//--- public functions ---
+
+MCShmReader::~MCShmReader()
+{
+	Close();
+}
+
+/*---------------------------------------------------------------------
+ * bool Open(const char *ShmName)
+ * Map the region of the writer.
+ * --> false if there is none yet, not published yet or of another version
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCShmReader::Open(const char *ShmName)
+{
+	struct stat Stat;
+
+	Close();
+
+	int fd = shm_open(ShmName, O_RDONLY, 0);
+	if(fd < 0)
+		return false;
+
+	void *Map = MAP_FAILED;
+	if((fstat(fd, &Stat) == 0) && ((size_t)Stat.st_size >= sizeof(MCShmRegion)))
+		Map = mmap(NULL, sizeof(MCShmRegion), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if(Map == MAP_FAILED)
+		return false;
+
+	Region = (const MCShmRegion *)Map;
+
+	//the writer sets the magic last
+	uint32_t Magic = Region->Magic;
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	if((Magic != MCShmMagic) || (Region->Version != MCShmVersion))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MCShmReader::Close()
+{
+	if(Region == NULL)
+		return;
+
+	munmap((void *)Region, sizeof(MCShmRegion));
+	Region = NULL;
+}
+
+bool MCShmReader::IsOpen()
+{
+	return Region != NULL;
+}
+
+uint8_t MCShmReader::GetNodeCount()
+{
+	return (Region != NULL) ? Region->NodeCount : 0;
+}
+
+uint32_t MCShmReader::GetHeartbeat()
+{
+	return (Region != NULL) ? Region->Heartbeat.load(std::memory_order_acquire) : 0;
+}
+
+uint32_t MCShmReader::GetWriterPid()
+{
+	return (Region != NULL) ? Region->WriterPid : 0;
+}
+
+uint64_t MCShmReader::GetClockBaseNs()
+{
+	return (Region != NULL) ? Region->ClockBaseNs : 0;
+}
+
+uint16_t MCShmReader::GetTimeScale()
+{
+	return (Region != NULL) ? Region->TimeScale : 1;
+}
+
+/*---------------------------------------------------------------------
+ * bool Read(uint8_t Slot, MCShmNodeState *State)
+ * a consistent copy of the state of a node
+ * --> false if the node has never been written or no consistent copy
+ *     could be taken
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+bool MCShmReader::Read(uint8_t Slot, MCShmNodeState *State)
+{
+	if((Region == NULL) || (Slot >= Region->NodeCount))
+		return false;
+
+	const MCShmNodeBlock *Block = &Region->Node[Slot];
+
+	for(uint16_t i = 0; i < MCShmReadRetries; i++)
+	{
+		uint32_t seq = Block->Seq.load(std::memory_order_acquire);
+
+		if(seq == 0)
+			return false;
+		if(seq & 1)
+			continue;
+
+		*State = Block->State;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if(Block->Seq.load(std::memory_order_relaxed) == seq)
+			return true;
+	}
+	return false;
+}
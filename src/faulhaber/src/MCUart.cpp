@@ -2,8 +2,10 @@
 //  includes
 
 #include <cstdio>
+#include <stdexcept>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
 #include "faulhaber/MCUart.h"
-#include "vector"
 
 //---------------------------------------------------------------------
 //  local definitions
@@ -25,7 +27,11 @@ const uint8_t MsgPrefix = 0x53;    // == S
 const uint16_t MsgTimeout = MaxMsgTime; // timeout in ms
 
 //#define DEBUG_UART (DEBUG_TO | DEBUG_ERROR | DEBUG_OPEN | DEBUG_RXERROR | DEBUG_TXFRAME | DEBUG_RXFRAME)
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_UART 0
+#else
 #define DEBUG_UART (DEBUG_TO | DEBUG_ERROR | DEBUG_OPEN | DEBUG_RXERROR)
+#endif
 
 
 //--- implementations ---
@@ -54,16 +60,54 @@ MCUart::~MCUart() {
     Stop();
 }
 
+/*----------------------------------------------------------
+ * GetSerialBaud(uint32_t)
+ * the LibSerial rate of a rate in Bd. Throws for a rate
+ * the drives and LibSerial don't have in common.
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ---------------------------------------------------------*/
+static LibSerial::BaudRate GetSerialBaud(uint32_t baud)
+{
+    switch(baud)
+    {
+        case 9600:
+            return LibSerial::BaudRate::BAUD_9600;
+        case 19200:
+            return LibSerial::BaudRate::BAUD_19200;
+        case 38400:
+            return LibSerial::BaudRate::BAUD_38400;
+        case 57600:
+            return LibSerial::BaudRate::BAUD_57600;
+        case 115200:
+            return LibSerial::BaudRate::BAUD_115200;
+        case 230400:
+            return LibSerial::BaudRate::BAUD_230400;
+        case 460800:
+            return LibSerial::BaudRate::BAUD_460800;
+        case 921600:
+            return LibSerial::BaudRate::BAUD_921600;
+        default:
+            throw std::invalid_argument("unsupported baud rate");
+    }
+}
+
 /*----------------------------------------------------------
  * Open(unsigned long)
  * explicitely open the interface
+ * The rate is checked before the port is opened.
  * 
  * 2020-05-15 AW Frame
  * 2020-11-18    Done
+ * 2026-10-18 AW the baud rate requested instead of 115200
+ * 2026-10-18 AW low latency mode
  * 
  * ---------------------------------------------------------*/
 void MCUart::Open(const char *serial_port, uint32_t baud = 115200)
 {
+    LibSerial::BaudRate SerialBaud = GetSerialBaud(baud);
+
     BaudRate = baud;
     rxIdx = 0;
     rxSize = 0;
@@ -73,13 +117,31 @@ void MCUart::Open(const char *serial_port, uint32_t baud = 115200)
     #endif
 
     serial_stream_->Open(serial_port);
-    serial_stream_->SetBaudRate(LibSerial::BaudRate::BAUD_115200);
+    serial_stream_->SetBaudRate(SerialBaud);
     serial_stream_->SetCharacterSize(LibSerial::CharacterSize::CHAR_SIZE_8);
     serial_stream_->SetParity(LibSerial::Parity::PARITY_NONE);
     serial_stream_->SetStopBits(LibSerial::StopBits::STOP_BITS_1);
     serial_stream_->SetFlowControl(LibSerial::FlowControl::FLOW_CONTROL_NONE);
     serial_stream_->flush();
 
+    //lets e.g. an FTDI deliver each byte at once instead of after its
+    //latency timer; not every driver has it, a PTY hasn't
+    if(isLowLatency)
+    {
+        struct serial_struct Serial;
+        int fd = serial_stream_->GetFileDescriptor();
+
+        if(ioctl(fd, TIOCGSERIAL, &Serial) == 0)
+        {
+            Serial.flags |= ASYNC_LOW_LATENCY;
+            ioctl(fd, TIOCSSERIAL, &Serial);
+        }
+        #if(DEBUG_UART & DEBUG_OPEN)
+        else
+            std::printf("UART: no low latency mode\n");
+        #endif
+    }
+
     state = eUartOperating;
 }
 
@@ -106,6 +168,7 @@ void MCUart::ResetUart()
  * 2020-05-13 AW Frame
  * 2020-11-18    Done
  * 2024-05-04    remove reference to timer
+ * 2026-10-18 AW read into the fixed RxChunk instead of a vector
  * 
  * ---------------------------------------------------------*/
  
@@ -116,18 +179,19 @@ void MCUart::Update(uint32_t actTime)
     if(state == eUartOperating)
     {
         int available_bytes = serial_stream_->GetNumberOfBytesAvailable();
-        if (available_bytes > 0)
+        while (available_bytes > 0)
         {   
-            std::vector<char> read_array(available_bytes);
-            serial_stream_->read(read_array.data(), available_bytes);
+            int chunk_size = (available_bytes < (int)UART_RX_CHUNK_SIZE) ? available_bytes : (int)UART_RX_CHUNK_SIZE;
+            serial_stream_->read(RxChunk, chunk_size);
+            available_bytes -= chunk_size;
 
             #if(DEBUG_UART & DEBUG_RXCHAR)
             std::printf("UART chunk: >");
             #endif
             
-            for (auto read_byte : read_array)
+            for (int n = 0; n < chunk_size; n++)
             {
-                auto inChar = static_cast<uint8_t>(read_byte);
+                auto inChar = static_cast<uint8_t>(RxChunk[n]);
                 //now add it to the buffer if applicable
                 if(rxIdx < UART_MAX_MSG_SIZE)
                 {
@@ -311,6 +375,74 @@ short MCUart::WriteMsg(UART_Msg *Msg)
     return status;
 }
 
+/*----------------------------------------------------------
+ * WriteMsgBurst(UART_Msg **Msgs, uint8_t count)
+ * frame several messages and write them back-to-back with a single
+ * write and drain, so there are no gaps between the frames other than
+ * those of the UART itself.
+ * Either all frames are written or none.
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ---------------------------------------------------------*/
+short MCUart::WriteMsgBurst(UART_Msg **Msgs, uint8_t count)
+{
+    uint16_t pos = 0;
+
+    if((state != eUartOperating) || (count == 0) || (count > UART_MAX_BURST))
+        return false;
+
+    for(uint8_t m = 0; m < count; m++)
+    {
+        uint16_t len = (uint16_t)Msgs[m]->Hdr.u8Len + 2;
+
+        if(len > UART_MAX_MSG_SIZE)
+            return false;
+
+        for(uint8_t i = 0; i < len; i++)
+            TxBurst[pos + i] = Msgs[m]->u8Data[i];
+
+        //add prefix and postfix to the frame
+        TxBurst[pos] = MsgPrefix;
+        TxBurst[pos + len - 1] = MsgSuffix;
+        pos += len;
+    }
+
+    #if(DEBUG_UART & DEBUG_TXFRAME)
+    std::printf("UART Tx burst: %u frames %u bytes\n", count, pos);
+    #endif
+
+    serial_stream_->write((char *)TxBurst, pos);
+    serial_stream_->DrainWriteBuffer();
+
+    return true;
+}
+
+/*----------------------------------------------------------
+ * uint32_t GetBaudRate()
+ * the rate the interface has been opened with
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ---------------------------------------------------------*/
+uint32_t MCUart::GetBaudRate()
+{
+    return BaudRate;
+}
+
+/*----------------------------------------------------------
+ * void SetLowLatency(bool)
+ * request the low latency mode of the serial driver with the
+ * next Open()
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ---------------------------------------------------------*/
+void MCUart::SetLowLatency(bool isLow)
+{
+    isLowLatency = isLow;
+}
+
 /*----------------------------------------------------------
  * OnTimeOut()
  * handler to be registered at the timer and to be started
@@ -22,7 +22,11 @@
 
 //--- definitions ---
 
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_MSGHandler 0
+#else
 #define DEBUG_MSGHandler (DEBUG_ULCK)
+#endif
 
 const uint16_t MsgHandlerMaxLeaseTime = (2 * MaxMsgTime + 2);
 
@@ -68,6 +72,25 @@ void MsgHandler::Open(const char *serial_port, uint32_t baudrate)
 	Uart.Open(serial_port, baudrate);	
 }
 
+/*------------------------------------------------------
+ * Close()
+ * Stop the Uart and close the serial interface. A lock and
+ * messages still waiting to be sent are dropped, so the
+ * next Open() starts clean.
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ----------------------------------------------------*/
+ 
+void MsgHandler::Close()
+{
+	Uart.Stop();
+
+	isLocked = false;
+	for(uint8_t i = 0; i < MsgHandler_MaxNodes; i++)
+		TxMsgPending[i] = false;
+}
+
 /*------------------------------------------------------
  * Update()
  * needed to call the Update of the underlying Uart as there
@@ -76,6 +99,7 @@ void MsgHandler::Open(const char *serial_port, uint32_t baudrate)
  * it will be unlocked here to give the system a chance to recover
  * 
  * 2020-05-15 AW Rev A
+ * 2026-10-18 AW count the expired leases
  * 
  * ----------------------------------------------------*/
  
@@ -87,6 +111,7 @@ void MsgHandler::Update(uint32_t timeNow)
 	if(isLocked && (actTime - lockTime > MsgHandlerMaxLeaseTime))
 	{
 		UnLockHandler();
+		Counts.LeaseExpiries++;
 		#if(DEBUG_MSGHandler & DEBUG_ULCK)
 		std::printf("Msg: unlocked\n");
 		#endif
@@ -151,16 +176,28 @@ void MsgHandler::UnLockHandler()
  * to call the registered handler.
  * 
  * 2020-05-15 AW Rev A
+ * 2026-10-18 AW time of the last frame per node
+ * 2026-10-18 AW count the CRC errors
  * 
  * ------------------------------------------------------*/
  
 void MsgHandler::OnRxHandler(MCMsg *RxMsg)
 {
 	uint8_t NodeHandle = FindNode(RxMsg->Hdr.u8NodeNr);
+	bool isCrcOk = IsCrcOk((UART_Msg *)RxMsg);
+
+	Counts.RxFrames++;
+	Counts.RxBytes += (uint32_t)RxMsg->Hdr.u8Len + 2;
+	if(!isCrcOk)
+		Counts.CrcErrors++;
 
-	if((NodeHandle != InvalidSlot) && IsCrcOk((UART_Msg *)RxMsg))
+	if((NodeHandle != InvalidSlot) && isCrcOk)
 	{
 		MCMsgCommands cmd = RxMsg->Hdr.u8Cmd;
+
+		//any valid frame proves the node to be alive
+		LastRxAt[NodeHandle] = actTime;
+		RxCount[NodeHandle]++;
 		
 		switch(cmd)
 		{
@@ -346,6 +383,9 @@ bool MsgHandler::SendMsg(uint8_t NodeHandle, MCMsg *NewTxMsg)
 		else
 		{
 			// return of the Uart was true - so successful TX
+			Counts.TxFrames++;
+			Counts.TxBytes += (uint32_t)ThisMsg->Hdr.u8Len + 2;
+
 			#if(DEBUG_MSGHandler & DEBUG_TXMSG)
 			std::printf("Msg: sent\n");
 			#else
@@ -356,6 +396,116 @@ bool MsgHandler::SendMsg(uint8_t NodeHandle, MCMsg *NewTxMsg)
 	return returnValue;
 }
 
+/*----------------------------------------------------------
+ * bool SendMsgBurst(const uint8_t *NodeHandles, MCMsg **Msgs, uint8_t count)
+ * send several Msgs, one per NodeHandle, in a single write.
+ * Other than SendMsg() nothing is stored if the Uart can't take them;
+ * the caller has to hold the lock of the MsgHandler.
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ----------------------------------------------------------*/
+
+bool MsgHandler::SendMsgBurst(const uint8_t *NodeHandles, MCMsg **Msgs, uint8_t count)
+{
+	UART_Msg *Frames[UART_MAX_BURST];
+
+	if(count > UART_MAX_BURST)
+		return false;
+
+	for(uint8_t m = 0; m < count; m++)
+	{
+		UART_Msg *ThisMsg = (UART_Msg *)Msgs[m];
+
+		if(NodeHandles[m] >= MsgHandler_MaxNodes)
+			return false;
+
+		// add Node-Id and CRC
+		ThisMsg->Hdr.u8NodeNr = (uint8_t) nodeId[NodeHandles[m]];
+		ThisMsg->u8Data[ThisMsg->Hdr.u8Len] = CalcCRC((const uint8_t *)&(ThisMsg->u8Data[1]), ThisMsg->Hdr.u8Len - 1);
+		Frames[m] = ThisMsg;
+	}
+
+	#if(DEBUG_MSGHandler & DEBUG_TXMSG)
+	std::printf("Msg: burst of %u\n", count);
+	#endif
+
+	if(!Uart.WriteMsgBurst(Frames, count))
+		return false;
+
+	for(uint8_t m = 0; m < count; m++)
+	{
+		Counts.TxFrames++;
+		Counts.TxBytes += (uint32_t)Frames[m]->Hdr.u8Len + 2;
+	}
+	return true;
+}
+
+/*----------------------------------------------------------
+ * uint32_t GetBaudRate()
+ * the rate of the underlying Uart
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ----------------------------------------------------------*/
+
+uint32_t MsgHandler::GetBaudRate()
+{
+	return Uart.GetBaudRate();
+}
+
+/*----------------------------------------------------------
+ * void SetLowLatency(bool isLow)
+ * ask the underlying Uart for the low latency mode of the
+ * serial driver. To be called before Open().
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ----------------------------------------------------------*/
+
+void MsgHandler::SetLowLatency(bool isLow)
+{
+	Uart.SetLowLatency(isLow);
+}
+
+/*----------------------------------------------------------
+ * void GetFrameCounts(MCFrameCounts *ThisCounts)
+ * copy of the frame and byte counters of both directions.
+ * Differences of two copies give the traffic in between.
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ----------------------------------------------------------*/
+
+void MsgHandler::GetFrameCounts(MCFrameCounts *ThisCounts)
+{
+	*ThisCounts = Counts;
+}
+
+/*----------------------------------------------------------
+ * uint32_t GetLastRxAt(uint8_t NodeHandle)
+ * uint32_t GetRxCount(uint8_t NodeHandle)
+ * time of the last valid frame of the node and the number of
+ * valid frames received from it so far
+ * 
+ * 2026-10-18 AW Done
+ * 
+ * ----------------------------------------------------------*/
+
+uint32_t MsgHandler::GetLastRxAt(uint8_t NodeHandle)
+{
+	if(NodeHandle >= MsgHandler_MaxNodes)
+		return 0;
+	return LastRxAt[NodeHandle];
+}
+
+uint32_t MsgHandler::GetRxCount(uint8_t NodeHandle)
+{
+	if(NodeHandle >= MsgHandler_MaxNodes)
+		return 0;
+	return RxCount[NodeHandle];
+}
+
 /*----------------------------------------------------------
  * Register_OnRxSDOCb(uint8_t, pfunction_holder *Cb)
  * store the function and object pointer for the callback
@@ -19,10 +19,16 @@
 #define DEBUG_ERROR     0x0008
 #define DEBUG_TO        0x0010
 #define DEBUG_UPDATETime 0x0020
+#define DEBUG_BATCH     0x0040
+#define DEBUG_STREAM    0x0080
 #define DEBUG_BUSY      0x8000
 
 //#define DEBUG_SDO (DEBUG_TO | DEBUG_ERROR | DEBUG_RXMSG | DEBUG_WREQ | DEBUG_RREQ | DEBUG_BUSY)
+#if defined(FAULHABER_RT_SAFE)
+#define DEBUG_SDO 0
+#else
 #define DEBUG_SDO (DEBUG_TO | DEBUG_ERROR)
+#endif
 
 //--- implementation ---
 
@@ -40,6 +46,7 @@ const unsigned int SDORespTimeOut = (4 * MaxMsgTime);
 SDOHandler::SDOHandler()
 {
     RxLen = 0;
+    RespTimeOut = SDORespTimeOut;
 }
 
 /*-------------------------------------------------------
@@ -70,12 +77,19 @@ void SDOHandler::init(MsgHandler *ThisHandler, uint8_t Handle)
 /*---------------------------------------------------------------
  * SDOCommStates GetComState()
  * return the state of either the Rx or Tx of an SDO
+ * While a batch is running or waiting for the channel, the channel is
+ * eSDOBusy for everyone; the state of the batch is reported to its
+ * owner by RunBatch() only.
  * 
  * 2020-11-18 AW Done
+ * 2026-10-18 AW eSDOBusy while a batch is running
+ * 2026-10-18 AW eSDOBusy while a batch waits for the channel
  * -------------------------------------------------------------*/
  
 SDOCommStates SDOHandler::GetComState()
 {
+    if(IsReserved())
+        return eSDOBusy;
     return SDORxTxState;
 }
 
@@ -109,17 +123,44 @@ void SDOHandler::SetBusyRetryMax(uint8_t value)
     BusyRetryMax = value;
 }
 
+/*--------------------------------------------------------------
+ * void SetRespTimeOut(uint16_t)
+ * Time in ms a response may take before the request is retried or
+ * timed out. Default is SDORespTimeOut, which fits 115200 Bd; slower
+ * lines or drives need more.
+ * 
+ * 2026-10-18 AW Done
+ * --------------------------------------------------------------*/
+ 
+void SDOHandler::SetRespTimeOut(uint16_t value)
+{
+    RespTimeOut = (value > 0) ? value : SDORespTimeOut;
+}
+
 /*----------------------------------------------
  * void SDOHandler::ResetComState()
  * to be called after each interaction to 
  * move the SDORxTxState from eDone to eIdle
+ * A running batch is left alone, as it belongs to its owner only;
+ * see CancelBatch(). So is a shared read on the wire, which has no
+ * owner and ends by its response or its timeout.
  * 
  * 2020-10-16 AW inital
+ * 2026-10-18 AW a running batch is not reset
+ * 2026-10-18 AW a shared read on the wire is not reset
  * ---------------------------------------------*/
 
 void SDOHandler::ResetComState()
 {
+    if(isBatchActive)
+        return;
+    if(isSharedRq && (SDORxTxState == eSDOWaiting))
+        return;
+
     SDORxTxState = eSDOIdle;
+    isSharedRq = false;
+    isTimerActive = false;
+    PendingCmd = eInvalidCmdCode;
     TORetryCounter = 0;
     BusyRetryCounter = 0;
     //Handler should not be reset, as it could be used by different
@@ -148,15 +189,41 @@ void SDOHandler::ResetComState()
  * will only unlock it the actual service failed.
  * Successful servie will unlock in OnRxHandler().
  * 
+ * --> eSDOBusy while a batch is running
+ * 
  * 2020-11-18 AW Done
+ * 2026-10-18 AW counted in the stats
+ * 2026-10-18 AW sent by SendReadRq()
+ * 2026-10-18 AW busy while a batch is running
  * -------------------------------------------------------------*/
 
 SDOCommStates SDOHandler::ReadSDO(uint16_t Idx, uint8_t SubIdx)
 {
+    if(IsReserved())
+        return eSDOBusy;
+
+    return SendReadRq(Idx, SubIdx, false);
+}
+
+/*-------------------------------------------------------------
+ * SDOCommStates SendReadRq(uint16_t Idx, uint8_t SubIdx, bool isShared)
+ * the step sequence of ReadSDO(), for a request of a single owner
+ * or a shared one
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+SDOCommStates SDOHandler::SendReadRq(uint16_t Idx, uint8_t SubIdx, bool isShared)
+{
+    //a resend of the same object keeps the sequence number its waiters hold
+    bool isResend = (SDORxTxState == eSDORetry) && (RxRqMsg.Idx == Idx) && (RxRqMsg.SubIdx == SubIdx);
+
     switch(SDORxTxState)
     {
         case eSDOIdle:
         case eSDORetry:
+            isSharedRq = isShared;
+
             //fill header
             RxRqMsg.u8Len = 7;
             RxRqMsg.u8Cmd = eSdoReadReq;
@@ -169,8 +236,12 @@ SDOCommStates SDOHandler::ReadSDO(uint16_t Idx, uint8_t SubIdx)
                 if(Handler->SendMsg(Channel,(MCMsg *)&RxRqMsg))
                 {
                     SDORxTxState = eSDOWaiting;
+                    PendingCmd = eSdoReadReq;
+                    if(!isResend)
+                        RqSeq++;
 
                     BusyRetryCounter = 0;
+                    Stats.Requests++;
                     
                     #if(DEBUG_SDO & DEBUG_RREQ)
                     std::printf("SDO: N %d RxReq ok: %X --> eSDOWaiting\n", Handler->GetNodeId(Channel), Idx);
@@ -187,9 +258,10 @@ SDOCommStates SDOHandler::ReadSDO(uint16_t Idx, uint8_t SubIdx)
 
                     //didn't work
                     BusyRetryCounter++;
+                    Stats.BusyRetries++;
                     if(BusyRetryCounter > BusyRetryMax)
                     {
-                        SDORxTxState = eSDOError;
+                        FailRequest(eSDOError);
                         #if(DEBUG_SDO & DEBUG_ERROR)
                         std::printf("SDO: N %d RxReq failed --> eError\n", Handler->GetNodeId(Channel));
                         #endif
@@ -208,6 +280,116 @@ SDOCommStates SDOHandler::ReadSDO(uint16_t Idx, uint8_t SubIdx)
     return SDORxTxState;
 }
 
+/*-------------------------------------------------------------
+ * SDOCommStates ReadSDOShared(uint16_t Idx, uint8_t SubIdx, uint32_t *Ticket, uint32_t *Value)
+ * Read an object on behalf of one of several waiters which might all
+ * be interested in the same object.
+ * Each waiter holds its own Ticket which has to be 0 when starting to wait.
+ * If a read of the same object is already on the wire, the waiter joins
+ * it instead of sending another request. Otherwise a new request is
+ * sent as soon as the channel is idle.
+ * Any read response is kept with the sequence number of its request, so
+ * every joined waiter is completed by the single response.
+ * 
+ * In contrast to ReadSDO() a shared read does not end up in eSDODone
+ * but switches back to eSDOIdle as soon as the response is received.
+ * The value is handed over directly instead.
+ * 
+ * --> eSDODone: value is in *Value, Ticket is reset to 0
+ * --> eSDOWaiting: request of this object is on the wire
+ * --> eSDOBusy: channel is used for another request or a batch - just retry
+ * --> eSDOError/eSDOTimeout: the request waited for has failed, Ticket
+ *     is reset to 0. The state of the channel is left to the owner of
+ *     the request; a shared one has none and has been dropped already.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW a failure gives up the ticket only
+ * 2026-10-18 AW busy while a batch is running
+ * -------------------------------------------------------------*/
+
+SDOCommStates SDOHandler::ReadSDOShared(uint16_t Idx, uint8_t SubIdx, uint32_t *Ticket, uint32_t *Value)
+{
+    if(*Ticket != 0)
+    {
+        for(uint8_t i = 0; i < SDOSharedRxSlots; i++)
+        {
+            if((SharedRx[i].Idx == Idx) && (SharedRx[i].SubIdx == SubIdx) && 
+                (SharedRx[i].Seq != 0) && ((int32_t)(SharedRx[i].Seq - *Ticket) >= 0))
+            {
+                *Value = SharedRx[i].Value;
+                *Ticket = 0;
+                return eSDODone;
+            }
+        }
+
+        //the request waited for has failed, or has been dropped by its owner
+        if((*Ticket == FailedSeq) || (*Ticket != RqSeq) ||
+            (SDORxTxState == eSDOError) || (SDORxTxState == eSDOTimeout))
+        {
+            SDOCommStates Failure = (*Ticket == FailedSeq) ? FailedState : SDORxTxState;
+
+            *Ticket = 0;
+            return (Failure == eSDOTimeout) ? eSDOTimeout : eSDOError;
+        }
+    }
+
+    if(IsReserved())
+        return eSDOBusy;
+
+    bool isSameRq = (PendingCmd == eSdoReadReq) && (RxRqMsg.Idx == Idx) && (RxRqMsg.SubIdx == SubIdx);
+
+    switch(SDORxTxState)
+    {
+        case eSDOWaiting:
+            if(!isSameRq)
+                return eSDOBusy;
+
+            //join the request on the wire
+            *Ticket = RqSeq;
+            return eSDOWaiting;
+        case eSDORetry:
+            //only a shared request may be resent by any of its waiters
+            if(!(isSameRq && isSharedRq))
+                return eSDOBusy;
+            [[fallthrough]];
+        case eSDOIdle:
+            {
+                bool isNew = (SDORxTxState == eSDOIdle);
+
+                switch(SendReadRq(Idx, SubIdx, true))
+                {
+                    case eSDOWaiting:
+                        *Ticket = RqSeq;
+
+                        #if(DEBUG_SDO & DEBUG_RREQ)
+                        std::printf("SDO: N %d shared RxReq %X seq %u\n", Handler->GetNodeId(Channel), Idx, RqSeq);
+                        #endif
+                        return eSDOWaiting;
+                    case eSDORetry:
+                        //nobody waits for a request which hasn't been sent
+                        if(isNew)
+                        {
+                            SDORxTxState = eSDOIdle;
+                            isSharedRq = false;
+                            BusyRetryCounter = 0;
+                        }
+                        return eSDOBusy;
+                    default:
+                        break;
+                }
+                //the resend has failed for good
+                if((*Ticket != 0) && (*Ticket == FailedSeq))
+                {
+                    *Ticket = 0;
+                    return FailedState;
+                }
+            }
+            return eSDOBusy;
+        default:
+            return eSDOBusy;
+    }
+}
+
 /*-------------------------------------------------------------
  * SDOCommStates WriteSDO(uint16_t Idx, uint8_t SubIdx,uint32_t *Data,uint8_t len)
  * Try to write a drive parameter identified by its Idx and SubIdx.
@@ -223,15 +405,36 @@ SDOCommStates SDOHandler::ReadSDO(uint16_t Idx, uint8_t SubIdx)
  * will only unlock it the actual service failed.
  * Successful servie will unlock in OnRxHandler().
  * 
+ * --> eSDOBusy while a batch is running
+ * 
  * 2020-11-18 AW Done
+ * 2026-10-18 AW counted in the stats
+ * 2026-10-18 AW busy while a batch is running
  * -------------------------------------------------------------*/
 
 SDOCommStates SDOHandler::WriteSDO(uint16_t Idx, uint8_t SubIdx, uint32_t *Data,uint8_t len)
+{
+    if(IsReserved())
+        return eSDOBusy;
+
+    return SendWriteRq(Idx, SubIdx, Data, len);
+}
+
+/*-------------------------------------------------------------
+ * SDOCommStates SendWriteRq(uint16_t Idx, uint8_t SubIdx, uint32_t *Data, uint8_t len)
+ * the step sequence of WriteSDO(), used by the batch too
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+SDOCommStates SDOHandler::SendWriteRq(uint16_t Idx, uint8_t SubIdx, uint32_t *Data, uint8_t len)
 {
     switch(SDORxTxState)
     {
         case eSDOIdle:
         case eSDORetry:
+            isSharedRq = false;
+
         //fill header
             TxRqMsg.u8Len = 7 + len;
             TxRqMsg.u8Cmd = eSdoWriteReq;
@@ -251,7 +454,9 @@ SDOCommStates SDOHandler::WriteSDO(uint16_t Idx, uint8_t SubIdx, uint32_t *Data,
                 if(Handler->SendMsg(Channel,(MCMsg *)&TxRqMsg))
                 {
                     SDORxTxState = eSDOWaiting;
+                    PendingCmd = eSdoWriteReq;
                     BusyRetryCounter = 0;
+                    Stats.Requests++;
                     
                     #if(DEBUG_SDO & DEBUG_WREQ)
                     std::printf("SDO: N %d TxReq ok %X\n", Handler->GetNodeId(Channel), Idx);
@@ -266,9 +471,10 @@ SDOCommStates SDOHandler::WriteSDO(uint16_t Idx, uint8_t SubIdx, uint32_t *Data,
                     hasMsgHandlerLocked = false;
 
                     BusyRetryCounter++;
+                    Stats.BusyRetries++;
                     if(BusyRetryCounter > BusyRetryMax)
                     {
-                        SDORxTxState = eSDOError;
+                        FailRequest(eSDOError);
                         #if(DEBUG_SDO & DEBUG_ERROR)
                         std::printf("SDO: N %d TxReq failed\n", Handler->GetNodeId(Channel));
                         #endif
@@ -287,6 +493,135 @@ SDOCommStates SDOHandler::WriteSDO(uint16_t Idx, uint8_t SubIdx, uint32_t *Data,
     return SDORxTxState;
 }
 
+/*-------------------------------------------------------------
+ * SDOCommStates RunBatch(SDOBatchEntry *Entries, uint8_t count)
+ * Work on a fixed chain of read and write requests as a whole.
+ * The first request is sent as soon as the channel is idle. Each
+ * following one is sent directly from within the OnRxHandler() when
+ * the response of its predecessor has been received, so no cycle of
+ * the caller is lost in between.
+ * Values read are stored in the Value of their entry.
+ * The first failing request stops the batch with eSDOError or eSDOTimeout;
+ * GetBatchIdx() tells which one it was.
+ * 
+ * The first call reserves the channel for the batch: no new request of
+ * anyone else is accepted any longer, while a request already on its
+ * way is left to end for its owner. Then the batch owns the channel
+ * until its end is reported: all other services report eSDOBusy and
+ * a ResetComState() doesn't touch it, so no one else can take its state
+ * as their own. The end is reported once and the channel is idle again
+ * right away, so there is no ResetComState() needed. Only the owner can
+ * stop a batch early, see CancelBatch().
+ * 
+ * Has to be called cyclically with the same Entries until finished.
+ * --> eSDOWaiting while the batch is waiting for the channel or running
+ * --> eSDODone/eSDOError/eSDOTimeout once when it has ended
+ * --> eSDOBusy is reported while another batch has the channel
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW the batch owns the channel
+ * 2026-10-18 AW the channel is reserved by the first call
+ * -------------------------------------------------------------*/
+
+SDOCommStates SDOHandler::RunBatch(SDOBatchEntry *Entries, uint8_t count)
+{
+    if((Entries == NULL) || (count == 0))
+        return eSDOError;
+
+    if(Batch == NULL)
+    {
+        Batch = Entries;
+        BatchCount = count;
+        BatchIdx = 0;
+        isBatchActive = false;
+        isBatchRq = false;
+    }
+    if(Batch != Entries)
+        return eSDOBusy;
+
+    if(!isBatchActive)
+    {
+        //the request on its way ends for its owner first
+        if(SDORxTxState != eSDOIdle)
+            return eSDOWaiting;
+        isBatchActive = true;
+    }
+
+    //an entry not sent yet or to be resent
+    if((SDORxTxState == eSDOIdle) || (SDORxTxState == eSDORetry))
+        SendBatchEntry();
+
+    switch(SDORxTxState)
+    {
+        case eSDODone:
+        case eSDOError:
+        case eSDOTimeout:
+            {
+                SDOCommStates State = SDORxTxState;
+
+                Batch = NULL;
+                isBatchActive = false;
+                ResetComState();
+                return State;
+            }
+        default:
+            return eSDOWaiting;
+    }
+}
+
+/*-------------------------------------------------------------
+ * void CancelBatch(SDOBatchEntry *Entries)
+ * Stop the batch of Entries if it is running and release the channel.
+ * A late response of its request is counted only. A batch still
+ * waiting for the channel just gives up its reservation. NULL stops
+ * any batch, e.g. when the node has booted and nothing is on the wire.
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+void SDOHandler::CancelBatch(SDOBatchEntry *Entries)
+{
+    if((Batch == NULL) || ((Entries != NULL) && (Entries != Batch)))
+        return;
+
+    #if(DEBUG_SDO & DEBUG_BATCH)
+    std::printf("SDO: N %d batch cancelled at %u/%u\n", Handler->GetNodeId(Channel), BatchIdx, BatchCount);
+    #endif
+
+    bool wasActive = isBatchActive;
+
+    Batch = NULL;
+    isBatchActive = false;
+    //a request on its way before the batch is left to its owner
+    if(wasActive)
+        ResetComState();
+}
+
+/*-------------------------------------------------------------
+ * bool IsReserved()
+ * no new request is to be accepted, as a batch is running or waiting
+ * for the request on its way to end
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+bool SDOHandler::IsReserved()
+{
+    return (Batch != NULL) && (isBatchActive || (SDORxTxState == eSDOIdle));
+}
+
+/*-------------------------------------------------------------
+ * uint8_t GetBatchIdx()
+ * index of the entry of the running or stopped batch
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+uint8_t SDOHandler::GetBatchIdx()
+{
+    return BatchIdx;
+}
+
 /*-----------------------------------------------------
  * uint32_t GetObjValue()
  * Acutally read the last received object value.
@@ -311,6 +646,172 @@ uint32_t SDOHandler::GetObjValue()
 //-------------------------------------------------------------------
 //--- private calls ---
 
+/*-------------------------------------------------------------
+ * void StartStream(uint16_t Idx, uint8_t SubIdx, uint8_t Len)
+ * Prepare the write request of a single object which is to be written
+ * cyclically by StreamValue(). The frame is encoded once; per value only
+ * the data and the CRC change.
+ * The responses of streamed writes are counted by the OnRxHandler()
+ * and don't change the SDORxTxState, so the normal services can still
+ * be used in between. As each value holds the bus until its response,
+ * a stream is a sequence of full request/response exchanges.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW drop a lease still held
+ * -------------------------------------------------------------*/
+
+void SDOHandler::StartStream(uint16_t Idx, uint8_t SubIdx, uint8_t Len)
+{
+    StreamMsg.u8Len = 7 + Len;
+    StreamMsg.u8Cmd = eSdoWriteReq;
+    StreamMsg.Idx = Idx;
+    StreamMsg.SubIdx = SubIdx;
+    StreamLen = Len;
+
+    ReleaseStream();
+
+    StreamSent = 0;
+    StreamAcks = 0;
+    StreamErrors = 0;
+    isStreaming = true;
+
+    #if(DEBUG_SDO & DEBUG_STREAM)
+    std::printf("SDO: N %d stream %X.%X\n", Handler->GetNodeId(Channel), Idx, SubIdx);
+    #endif
+}
+
+/*-------------------------------------------------------------
+ * bool StreamValue(uint32_t Value)
+ * Send the next value of the stream right away.
+ * The bus must not be in use by a request waiting for its response,
+ * as the responses would collide otherwise. If it is, the value
+ * is not sent and false is returned.
+ * As for WriteSDO() the lease of the MsgHandler is kept until the
+ * response has been received or is timed out, so no other request
+ * can be sent in between. The value before still waiting for its
+ * response is reported as not sent too.
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW lease held until the response
+ * -------------------------------------------------------------*/
+
+bool SDOHandler::StreamValue(uint32_t Value)
+{
+    bool isSent = false;
+
+    if(!isStreaming || isStreamPending)
+        return false;
+
+    for(uint8_t i = 0; i < StreamLen; i++)
+        StreamMsg.u8UserData[i] = (uint8_t)(Value >> (8 * i));
+
+    if(Handler->LockHandler())
+    {
+        isSent = Handler->SendMsg(Channel, (MCMsg *)&StreamMsg);
+        if(isSent)
+        {
+            isStreamPending = true;
+            StreamSentAt = actTime;
+        }
+        else
+            Handler->UnLockHandler();
+    }
+
+    if(isSent)
+        StreamSent++;
+
+    #if(DEBUG_SDO & DEBUG_STREAM)
+    if(!isSent)
+        std::printf("SDO: N %d stream busy\n", Handler->GetNodeId(Channel));
+    #endif
+
+    return isSent;
+}
+
+void SDOHandler::StopStream()
+{
+    ReleaseStream();
+    isStreaming = false;
+}
+
+/*-------------------------------------------------------------
+ * void ReleaseStream()
+ * give back the lease of a streamed value still waiting for its
+ * response.
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+void SDOHandler::ReleaseStream()
+{
+    if(isStreamPending)
+    {
+        Handler->UnLockHandler();
+        isStreamPending = false;
+    }
+}
+
+uint32_t SDOHandler::GetStreamSent()
+{
+    return StreamSent;
+}
+
+uint32_t SDOHandler::GetStreamAcks()
+{
+    return StreamAcks;
+}
+
+uint32_t SDOHandler::GetStreamErrors()
+{
+    return StreamErrors;
+}
+
+/*-------------------------------------------------------------
+ * void GetStats(SDOStats *ThisStats)
+ * copy of the counters of this channel. Differences of two copies
+ * give the requests in between.
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+void SDOHandler::GetStats(SDOStats *ThisStats)
+{
+    *ThisStats = Stats;
+}
+
+/*-------------------------------------------------------------
+ * uint32_t GetRttPercentile(const SDOStats *ThisStats, uint8_t Percent)
+ * RTT in ms which Percent of the responses have not exceeded.
+ * The last bin covers all longer ones, so its value is RttMax.
+ * --> 0 if there are no responses yet
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+uint32_t SDOHandler::GetRttPercentile(const SDOStats *ThisStats, uint8_t Percent)
+{
+    uint32_t Total = 0;
+    uint32_t Sum = 0;
+
+    for(uint8_t i = 0; i < SDORttBins; i++)
+        Total += ThisStats->RttBins[i];
+    if(Total == 0)
+        return 0;
+
+    //rank of the sample searched for, rounded up
+    uint64_t Rank = ((uint64_t)Total * Percent + 99) / 100;
+    if(Rank == 0)
+        Rank = 1;
+
+    for(uint8_t i = 0; i < SDORttBins - 1; i++)
+    {
+        Sum += ThisStats->RttBins[i];
+        if(Sum >= Rank)
+            return i;
+    }
+    return ThisStats->RttMax;
+}
+
 /*-------------------------------------------------------------------
  * void OnRxHandler(MCMsg *Msg)
  * The actual handler for any SDO services received by the MsgHandler
@@ -318,13 +819,26 @@ uint32_t SDOHandler::GetObjValue()
  * requenst and will switch these to eDone.
  * Other will transit to eError.
  * 
+ * A response while no request is pending, e.g. a late one after a
+ * timeout, is counted only.
+ * A batch is continued only by the response of the entry it has sent.
+ * 
  * 2020-11-18 AW Done
+ * 2026-10-18 AW counted in the stats
+ * 2026-10-18 AW responses not waited for don't fail the channel
+ * 2026-10-18 AW batch continued by its own responses only
+ * 2026-10-18 AW streamed lease given back
+ * 2026-10-18 AW only the response of a streamed value waited for
  * -----------------------------------------------------------------*/
 
 void SDOHandler::OnRxHandler(MCMsg *Msg)
 {
     MCMsgCommands Cmd = Msg->Hdr.u8Cmd;
     SDOMaxMsg *SDO = (SDOMaxMsg *)Msg;
+    bool isPending = (SDORxTxState == eSDOWaiting) || (SDORxTxState == eSDORetry);
+    //only the response of the entry sent continues a batch
+    bool isBatchRsp = (Batch != NULL) && isBatchRq && (Batch[BatchIdx].Cmd == Cmd) &&
+        (Batch[BatchIdx].Idx == SDO->Idx) && (Batch[BatchIdx].SubIdx == SDO->SubIdx);
 
     #if(DEBUG_SDO  & DEBUG_RXMSG)
     std::printf("S: Rx in S:%d\n", SDORxTxState);
@@ -337,6 +851,22 @@ void SDOHandler::OnRxHandler(MCMsg *Msg)
     }	
     #endif
     
+    //responses of streamed writes are counted only, an error answering
+    //a normal request of the same object is left to that request
+    bool isStreamRsp = isStreamPending && (SDO->Idx == StreamMsg.Idx) && (SDO->SubIdx == StreamMsg.SubIdx) &&
+        ((Cmd == eSdoWriteReq) ||
+        ((Cmd == eSdoError) && !(isPending && (RxRqMsg.Idx == SDO->Idx) && (RxRqMsg.SubIdx == SDO->SubIdx))));
+
+    if(isStreamRsp)
+    {
+        if(Cmd == eSdoWriteReq)
+            StreamAcks++;
+        else
+            StreamErrors++;
+        ReleaseStream();
+        return;
+    }
+
     switch(Cmd)
     {
         case eSdoReadReq:
@@ -352,19 +882,34 @@ void SDOHandler::OnRxHandler(MCMsg *Msg)
                 RxLen = (SDO->u8Len) - 7;
                 
                 isTimerActive = false;
+                StoreRtt();
                 
                 //on Cortex this has to be done byte wise as u8UserData is not aligned to 32 bits
                 RxData.u8[0] = SDO->u8UserData[0];
                 RxData.u8[1] = SDO->u8UserData[1];
                 RxData.u8[2] = SDO->u8UserData[2];
                 RxData.u8[3] = SDO->u8UserData[3];
+
+                StoreSharedRx(SDO->Idx, SDO->SubIdx, RxData.u32);
                 
                 //switch transfer to eDone state and unlock the 
-                //used MsgHandler    
-                SDORxTxState = eSDODone;
+                //used MsgHandler
+                //a shared read has handed over its value already
+                if(isSharedRq)
+                {
+                    SDORxTxState = eSDOIdle;
+                    isSharedRq = false;
+                    TORetryCounter = 0;
+                }
+                else
+                    SDORxTxState = eSDODone;
+                PendingCmd = eInvalidCmdCode;
                 Handler->UnLockHandler();
                 hasMsgHandlerLocked = false;
 
+                if(isBatchRsp)
+                    ContinueBatch();
+
                 #if(DEBUG_SDO  & DEBUG_RXMSG)
                 std::printf("SDO: Rx Idx %X :%X\n", SDO->Idx, RxData.u32);
                 #endif
@@ -372,7 +917,9 @@ void SDOHandler::OnRxHandler(MCMsg *Msg)
             else
             {
                 //wrong answer
-                SDORxTxState = eSDOError;
+                Stats.Errors++;
+                if(isPending)
+                    FailRequest(eSDOError);
                 
                 #if(DEBUG_SDO & DEBUG_ERROR)
                 std::printf("SDO: Rx Error! Idx: %X. %X >> %d\n", SDO->Idx, SDO->SubIdx, SDORxTxState);
@@ -391,10 +938,15 @@ void SDOHandler::OnRxHandler(MCMsg *Msg)
                 //switch the state to the eDone and unlock the underlying 
                 //MsgHandler
                 SDORxTxState = eSDODone;
+                PendingCmd = eInvalidCmdCode;
                 Handler->UnLockHandler();
                 hasMsgHandlerLocked = false;
                 
                 isTimerActive = false;
+                StoreRtt();
+
+                if(isBatchRsp)
+                    ContinueBatch();
 
                 #if(DEBUG_SDO  & DEBUG_RXMSG)
                 std::printf("SDO: Tx Idx %X ok\n", SDO->Idx);
@@ -403,7 +955,9 @@ void SDOHandler::OnRxHandler(MCMsg *Msg)
             else
             {
                 //wrong answer
-                SDORxTxState = eSDOError;    
+                Stats.Errors++;
+                if(isPending)
+                    FailRequest(eSDOError);
                             
                 #if(DEBUG_SDO & DEBUG_ERROR)
                 std::printf("SDO: Tx Error! Idx: %X. %X >> %d\n", SDO->Idx, SDO->SubIdx, SDORxTxState);
@@ -412,10 +966,13 @@ void SDOHandler::OnRxHandler(MCMsg *Msg)
             break;
         default:
             //what's this? --> transit to eError
-            SDORxTxState = eSDOError;
-                #if(DEBUG_SDO & DEBUG_ERROR)
-                std::printf("SDO: Rx wrong CMD Error!");
-                #endif                
+            Stats.Errors++;
+            if(isPending)
+                FailRequest(eSDOError);
+
+            #if(DEBUG_SDO & DEBUG_ERROR)
+            std::printf("SDO: Rx wrong CMD Error!");
+            #endif
             break;
     }
 }
@@ -427,6 +984,8 @@ void SDOHandler::OnRxHandler(MCMsg *Msg)
  * is timed out and call the OnTimeOut() if so.
  * 
  * 2020-11-18 AW Done
+ * 2026-10-18 AW configurable timeout
+ * 2026-10-18 AW timeout of a streamed value
  * -----------------------------------------------------------*/
 
 void SDOHandler::SetActTime(uint32_t time)
@@ -437,12 +996,19 @@ void SDOHandler::SetActTime(uint32_t time)
     
     actTime = time;
     
-    if((isTimerActive) && ((RequestSentAt + SDORespTimeOut) < actTime))    
+    if((isTimerActive) && ((RequestSentAt + RespTimeOut) < actTime))    
     {    
         OnTimeOut();
         isTimerActive = false;
     }
 
+    //a streamed value without response is counted as an error
+    if(isStreamPending && ((StreamSentAt + RespTimeOut) < actTime))
+    {
+        StreamErrors++;
+        ReleaseStream();
+    }
+
 }
 
 /*----------------------------------------------------------
@@ -452,6 +1018,8 @@ void SDOHandler::SetActTime(uint32_t time)
  * the retry counter or switch to final state eTimeout.
  * 
  * 2020-11-18 AW Done
+ * 2026-10-18 AW counted in the stats
+ * 2026-10-18 AW by FailRequest()
  * -------------------------------------------------------------*/
 
 void SDOHandler::OnTimeOut()
@@ -464,6 +1032,7 @@ void SDOHandler::OnTimeOut()
     {
         SDORxTxState = eSDORetry;
         TORetryCounter++;
+        Stats.Retries++;
         
         if(hasMsgHandlerLocked)
         {
@@ -478,11 +1047,145 @@ void SDOHandler::OnTimeOut()
     }
     else
     {    
-        SDORxTxState = eSDOTimeout;
         TORetryCounter = 0;
+        Stats.TimeOuts++;
+        FailRequest(eSDOTimeout);
 
         #if(DEBUG_SDO & DEBUG_TO)
         std::printf("final\n");
         #endif
     }
 }
+
+/*----------------------------------------------------------
+ * void FailRequest(SDOCommStates State)
+ * End the pending request with eSDOError or eSDOTimeout. A request of
+ * a single owner keeps the state until the owner resets it. A shared
+ * one has no owner, so the channel is released right away; its waiters
+ * are told by the sequence number of the request.
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+void SDOHandler::FailRequest(SDOCommStates State)
+{
+    if(!isSharedRq)
+    {
+        SDORxTxState = State;
+        return;
+    }
+
+    FailedSeq = RqSeq;
+    FailedState = State;
+
+    isSharedRq = false;
+    isTimerActive = false;
+    PendingCmd = eInvalidCmdCode;
+    TORetryCounter = 0;
+    BusyRetryCounter = 0;
+    if(hasMsgHandlerLocked)
+    {
+        Handler->UnLockHandler();
+        hasMsgHandlerLocked = false;
+    }
+    SDORxTxState = eSDOIdle;
+}
+
+/*----------------------------------------------------------
+ * void StoreSharedRx(uint16_t Idx, uint8_t SubIdx, uint32_t Value)
+ * Keep a received value together with the sequence number of the
+ * request for any waiters of a shared read. An existing slot of
+ * the same object is overwritten, otherwise the oldest one.
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+void SDOHandler::StoreSharedRx(uint16_t Idx, uint8_t SubIdx, uint32_t Value)
+{
+    uint8_t slot = SharedRxNext;
+
+    for(uint8_t i = 0; i < SDOSharedRxSlots; i++)
+    {
+        if((SharedRx[i].Idx == Idx) && (SharedRx[i].SubIdx == SubIdx))
+        {
+            slot = i;
+            break;
+        }
+    }
+    if(slot == SharedRxNext)
+        SharedRxNext = (SharedRxNext + 1) % SDOSharedRxSlots;
+
+    SharedRx[slot].Idx = Idx;
+    SharedRx[slot].SubIdx = SubIdx;
+    SharedRx[slot].Value = Value;
+    SharedRx[slot].Seq = RqSeq;
+}
+
+/*----------------------------------------------------------
+ * void SendBatchEntry()
+ * send the actual entry of the batch the same way as the standard
+ * services, which are busy for everyone else meanwhile
+ * 
+ * 2026-10-18 AW Done
+ * 2026-10-18 AW past the busy check of the services
+ * -------------------------------------------------------------*/
+
+void SDOHandler::SendBatchEntry()
+{
+    SDOBatchEntry *Entry = &Batch[BatchIdx];
+
+    if(Entry->Cmd == eSdoWriteReq)
+        SendWriteRq(Entry->Idx, Entry->SubIdx, &(Entry->Value), Entry->Len);
+    else
+        SendReadRq(Entry->Idx, Entry->SubIdx, false);
+
+    if(SDORxTxState == eSDOWaiting)
+        isBatchRq = true;
+
+    #if(DEBUG_SDO & DEBUG_BATCH)
+    std::printf("SDO: N %d batch %u/%u %X --> %d\n", Handler->GetNodeId(Channel), BatchIdx, BatchCount, Entry->Idx, SDORxTxState);
+    #endif
+}
+
+/*----------------------------------------------------------
+ * void ContinueBatch()
+ * called from the OnRxHandler() after a matching response of the
+ * actual entry. Stores a read value and sends the next request
+ * right away. After the last one the state stays in eSDODone until
+ * RunBatch() reports it.
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+void SDOHandler::ContinueBatch()
+{
+    if(Batch[BatchIdx].Cmd == eSdoReadReq)
+        Batch[BatchIdx].Value = RxData.u32;
+
+    if(++BatchIdx < BatchCount)
+    {
+        SDORxTxState = eSDOIdle;
+        TORetryCounter = 0;
+        isBatchRq = false;
+        SendBatchEntry();
+    }
+    else
+        SDORxTxState = eSDODone;
+}
+
+/*----------------------------------------------------------
+ * void StoreRtt()
+ * count a matching response with the time since its request
+ * 
+ * 2026-10-18 AW Done
+ * -------------------------------------------------------------*/
+
+void SDOHandler::StoreRtt()
+{
+    uint32_t Rtt = actTime - RequestSentAt;
+
+    Stats.Responses++;
+    Stats.RttBins[(Rtt < SDORttBins) ? Rtt : SDORttBins - 1]++;
+    if(Rtt > Stats.RttMax)
+        Stats.RttMax = Rtt;
+}
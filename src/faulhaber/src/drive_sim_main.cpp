@@ -0,0 +1,112 @@
+/*---------------------------------------------------
+ * drive_sim_main.cpp
+ * runs a MCDriveSim on its own, so the plugins or any
+ * other client can attach to its PTY like to a real port
+ *
+ *   faulhaber_drive_sim [-b baud] [-l latency_us] [-s scale]
+ *                       [-p link] NodeId...
+ *
+ * The PTY is printed and optionally linked to a fixed path.
+ * Runs until SIGINT or SIGTERM.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "faulhaber/MCDriveSim.h"
+
+//--- local defines ---
+
+static volatile sig_atomic_t isStopped = 0;
+
+static void OnSignal(int)
+{
+	isStopped = 1;
+}
+
+static void Usage(const char *Name)
+{
+	std::fprintf(stderr, "usage: %s [-b baud] [-l latency_us] [-s scale] [-p link] NodeId...\n", Name);
+}
+
+int main(int argc, char **argv)
+{
+	MCDriveSim Sim;
+	uint32_t Baud = 115200;
+	uint16_t Latency = 500;
+	uint16_t Scale = 1;
+	const char *Link = NULL;
+	int Opt;
+
+	while((Opt = getopt(argc, argv, "b:l:s:p:h")) != -1)
+	{
+		switch(Opt)
+		{
+			case 'b':
+				Baud = (uint32_t)std::strtoul(optarg, NULL, 0);
+				break;
+			case 'l':
+				Latency = (uint16_t)std::strtoul(optarg, NULL, 0);
+				break;
+			case 's':
+				Scale = (uint16_t)std::strtoul(optarg, NULL, 0);
+				break;
+			case 'p':
+				Link = optarg;
+				break;
+			default:
+				Usage(argv[0]);
+				return 1;
+		}
+	}
+
+	if(optind >= argc)
+	{
+		Usage(argv[0]);
+		return 1;
+	}
+
+	Sim.Configure(Baud, Latency, Scale);
+	for(int i = optind; i < argc; i++)
+	{
+		if(!Sim.AddNode((uint8_t)std::strtoul(argv[i], NULL, 0)))
+		{
+			std::fprintf(stderr, "at most %u nodes\n", MCSimMaxNodes);
+			return 1;
+		}
+	}
+
+	if(!Sim.Start())
+	{
+		std::fprintf(stderr, "can't open a PTY\n");
+		return 1;
+	}
+	if((Link != NULL) && !Sim.LinkPort(Link))
+	{
+		std::fprintf(stderr, "can't link %s\n", Link);
+		Sim.Stop();
+		return 1;
+	}
+
+	std::printf("%s\n", Sim.GetPortName());
+	std::fflush(stdout);
+
+	std::signal(SIGINT, OnSignal);
+	std::signal(SIGTERM, OnSignal);
+	while(!isStopped)
+		pause();
+
+	Sim.Stop();
+	if(Link != NULL)
+		unlink(Link);
+	std::printf("rx %u, tx %u frames\n", Sim.GetRxFrames(), Sim.GetTxFrames());
+
+	return 0;
+}
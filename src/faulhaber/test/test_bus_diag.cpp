@@ -0,0 +1,75 @@
+/*---------------------------------------------------
+ * test_bus_diag.cpp
+ * checks the diagnostics of a MCBus against drives
+ * simulated by a MCDriveSim at a baud rate other than
+ * the default one
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "faulhaber/MCBus.h"
+#include "faulhaber/MCDriveSim.h"
+
+//--- local defines ---
+
+const uint32_t TestBaudRate = 19200;
+const uint16_t TestPollRate = 10;
+//time the polls run before the diagnostics are taken
+const uint32_t TestRunMs = 1500;
+
+//position and speed of 2 axes, each read 9 + 13 bytes of 10 bits on the
+//wire: 11458 us at 19200 Bd, once per 100 ms --> 114 permille per read
+const uint16_t TestPollLoadPermille = 4 * 114;
+//the same reads at 115200 Bd, which a wrong baud rate would report
+const uint16_t TestDefaultLoadPermille = 4 * 19;
+
+//--- local functions ---
+
+static bool WaitForPhase(MCBus &Bus, MCBusPhases Phase, uint32_t TimeOut)
+{
+	for(uint32_t t = 0; t < TimeOut; t += 10)
+	{
+		if(Bus.GetPhase() == Phase)
+			return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return false;
+}
+
+//--- tests ---
+
+TEST(MCBusDiag, LoadAtTheBaudRateOpened)
+{
+	MCDriveSim Sim;
+	MCBus Bus;
+	MCBusDiagnostics Diag;
+
+	Sim.Configure(TestBaudRate, 500, 1);
+	Sim.AddNode(1);
+	Sim.AddNode(2);
+	ASSERT_TRUE(Sim.Start()) << "simulation not started";
+
+	Bus.AddAxis(1);
+	Bus.AddAxis(2);
+	Bus.SetPollRate(TestPollRate);
+	ASSERT_TRUE(Bus.Open(Sim.GetPortName(), TestBaudRate));
+	ASSERT_TRUE(WaitForPhase(Bus, eBusIdle, 5000));
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(TestRunMs));
+	ASSERT_TRUE(Bus.GetDiagnostics(&Diag));
+
+	EXPECT_EQ(Diag.PollLoadPermille, TestPollLoadPermille);
+	//the reads actually on the line, well above their share at 115200 Bd
+	EXPECT_GT(Diag.LoadPermille, 2 * TestDefaultLoadPermille);
+
+	Bus.Close();
+	Sim.Stop();
+}
@@ -0,0 +1,430 @@
+/*---------------------------------------------------
+ * test_bus_rt.cpp
+ * checks the control path of a MCBus against drives
+ * simulated by a MCDriveSim: in steady state the calls
+ * of the control loop neither allocate nor print nor
+ * lock nor make a blocking system call, and the worker
+ * doesn't allocate either
+ *
+ * The calls of the caller are counted per thread, only
+ * while the test thread is within SetCommands(),
+ * GetStates(), GetPolls() and GetDiagnostics(). The
+ * simulation runs in a child process, so the allocations
+ * counted for the process are the ones of the bus.
+ * The bus is built with FAULHABER_RT_SAFE.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <dlfcn.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <sys/select.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "faulhaber/MCBus.h"
+#include "faulhaber/MCDriveSim.h"
+
+//--- local defines ---
+
+//time the bus runs before and while counting
+const uint32_t TestWarmUpMs = 500;
+const uint32_t TestWindowMs = 1000;
+//cycle of the caller, like the controller_manager
+const uint32_t TestCallerCycleMs = 2;
+
+//--- hooks ---
+
+//what the caller has done within the calls of the bus
+typedef struct TestCallerCounts {
+	uint32_t Allocs;
+	uint32_t Locks;
+	uint32_t Syscalls;      //blocking ones: I/O, waits and sleeps
+	uint32_t Stdio;
+} TestCallerCounts;
+
+static thread_local bool isCallerPath = false;
+static thread_local TestCallerCounts Caller = {};
+
+//allocations of the whole process, while isCounting
+static std::atomic<bool> isCounting{false};
+static std::atomic<uint32_t> Allocs{0};
+
+static void CountAlloc()
+{
+	if(isCallerPath)
+		Caller.Allocs++;
+	if(isCounting.load(std::memory_order_relaxed))
+		Allocs.fetch_add(1, std::memory_order_relaxed);
+}
+
+//the originals, looked up at their first call; constant initialized
+//so they can be called before any static constructor has run
+#define TEST_ORIGINAL(Name) \
+	static decltype(&::Name) Real_##Name() \
+	{ \
+		static decltype(&::Name) Fn = NULL; \
+		if(Fn == NULL) \
+			Fn = (decltype(&::Name))dlsym(RTLD_NEXT, #Name); \
+		return Fn; \
+	}
+
+TEST_ORIGINAL(pthread_mutex_lock)
+TEST_ORIGINAL(pthread_mutex_trylock)
+TEST_ORIGINAL(pthread_rwlock_rdlock)
+TEST_ORIGINAL(pthread_rwlock_wrlock)
+TEST_ORIGINAL(pthread_cond_wait)
+TEST_ORIGINAL(sem_wait)
+TEST_ORIGINAL(read)
+TEST_ORIGINAL(write)
+TEST_ORIGINAL(poll)
+TEST_ORIGINAL(select)
+TEST_ORIGINAL(nanosleep)
+TEST_ORIGINAL(clock_nanosleep)
+TEST_ORIGINAL(vfprintf)
+TEST_ORIGINAL(fputs)
+TEST_ORIGINAL(fwrite)
+TEST_ORIGINAL(fputc)
+
+extern "C" void *__libc_malloc(size_t);
+extern "C" void *__libc_calloc(size_t, size_t);
+extern "C" void *__libc_realloc(void *, size_t);
+extern "C" void *__libc_memalign(size_t, size_t);
+
+//operator new of libstdc++ ends up here as well
+extern "C" void *malloc(size_t Size)
+{
+	CountAlloc();
+	return __libc_malloc(Size);
+}
+
+extern "C" void *calloc(size_t Count, size_t Size)
+{
+	CountAlloc();
+	return __libc_calloc(Count, Size);
+}
+
+extern "C" void *realloc(void *Ptr, size_t Size)
+{
+	CountAlloc();
+	return __libc_realloc(Ptr, Size);
+}
+
+extern "C" int posix_memalign(void **Ptr, size_t Align, size_t Size)
+{
+	CountAlloc();
+	*Ptr = __libc_memalign(Align, Size);
+	return (*Ptr != NULL) ? 0 : ENOMEM;
+}
+
+extern "C" void *aligned_alloc(size_t Align, size_t Size)
+{
+	CountAlloc();
+	return __libc_memalign(Align, Size);
+}
+
+//std::mutex and friends end up here
+extern "C" int pthread_mutex_lock(pthread_mutex_t *Mutex)
+{
+	Caller.Locks += isCallerPath;
+	return Real_pthread_mutex_lock()(Mutex);
+}
+
+extern "C" int pthread_mutex_trylock(pthread_mutex_t *Mutex)
+{
+	Caller.Locks += isCallerPath;
+	return Real_pthread_mutex_trylock()(Mutex);
+}
+
+extern "C" int pthread_rwlock_rdlock(pthread_rwlock_t *Lock)
+{
+	Caller.Locks += isCallerPath;
+	return Real_pthread_rwlock_rdlock()(Lock);
+}
+
+extern "C" int pthread_rwlock_wrlock(pthread_rwlock_t *Lock)
+{
+	Caller.Locks += isCallerPath;
+	return Real_pthread_rwlock_wrlock()(Lock);
+}
+
+extern "C" int pthread_cond_wait(pthread_cond_t *Cond, pthread_mutex_t *Mutex)
+{
+	Caller.Locks += isCallerPath;
+	return Real_pthread_cond_wait()(Cond, Mutex);
+}
+
+extern "C" int sem_wait(sem_t *Sem)
+{
+	Caller.Locks += isCallerPath;
+	return Real_sem_wait()(Sem);
+}
+
+extern "C" ssize_t read(int fd, void *Buf, size_t Len)
+{
+	Caller.Syscalls += isCallerPath;
+	return Real_read()(fd, Buf, Len);
+}
+
+extern "C" ssize_t write(int fd, const void *Buf, size_t Len)
+{
+	Caller.Syscalls += isCallerPath;
+	return Real_write()(fd, Buf, Len);
+}
+
+extern "C" int poll(struct pollfd *Fds, nfds_t Count, int TimeOut)
+{
+	Caller.Syscalls += isCallerPath;
+	return Real_poll()(Fds, Count, TimeOut);
+}
+
+extern "C" int select(int Count, fd_set *Rd, fd_set *Wr, fd_set *Ex, struct timeval *TimeOut)
+{
+	Caller.Syscalls += isCallerPath;
+	return Real_select()(Count, Rd, Wr, Ex, TimeOut);
+}
+
+extern "C" int nanosleep(const struct timespec *Req, struct timespec *Rem)
+{
+	Caller.Syscalls += isCallerPath;
+	return Real_nanosleep()(Req, Rem);
+}
+
+extern "C" int clock_nanosleep(clockid_t Clock, int Flags, const struct timespec *Req, struct timespec *Rem)
+{
+	Caller.Syscalls += isCallerPath;
+	return Real_clock_nanosleep()(Clock, Flags, Req, Rem);
+}
+
+//the debug output of the bus: printf() and its variants, puts() and putchar()
+extern "C" int vfprintf(FILE *Stream, const char *Format, va_list Args)
+{
+	Caller.Stdio += isCallerPath;
+	return Real_vfprintf()(Stream, Format, Args);
+}
+
+extern "C" int vprintf(const char *Format, va_list Args)
+{
+	return vfprintf(stdout, Format, Args);
+}
+
+extern "C" int printf(const char *Format, ...)
+{
+	va_list Args;
+
+	va_start(Args, Format);
+	int Len = vfprintf(stdout, Format, Args);
+	va_end(Args);
+	return Len;
+}
+
+extern "C" int fprintf(FILE *Stream, const char *Format, ...)
+{
+	va_list Args;
+
+	va_start(Args, Format);
+	int Len = vfprintf(Stream, Format, Args);
+	va_end(Args);
+	return Len;
+}
+
+extern "C" int fputs(const char *Text, FILE *Stream)
+{
+	Caller.Stdio += isCallerPath;
+	return Real_fputs()(Text, Stream);
+}
+
+extern "C" int puts(const char *Text)
+{
+	Caller.Stdio += isCallerPath;
+	if(Real_fputs()(Text, stdout) < 0)
+		return EOF;
+	return Real_fputc()('\n', stdout);
+}
+
+extern "C" size_t fwrite(const void *Ptr, size_t Size, size_t Count, FILE *Stream)
+{
+	Caller.Stdio += isCallerPath;
+	return Real_fwrite()(Ptr, Size, Count, Stream);
+}
+
+extern "C" int fputc(int c, FILE *Stream)
+{
+	Caller.Stdio += isCallerPath;
+	return Real_fputc()(c, Stream);
+}
+
+extern "C" int putchar(int c)
+{
+	return fputc(c, stdout);
+}
+
+//--- local functions ---
+
+/*---------------------------------------------------------------------
+ * pid_t StartSim(uint8_t Nodes, std::string &Port, int &Stop)
+ * Fork a child running a MCDriveSim with the nodes 1..Nodes. The child
+ * runs until Stop is closed. To be called before any thread has been
+ * started.
+ * --> pid of the child, -1 if the simulation couldn't be started
+ *
+ * 2026-10-18 AW Done
+ *--------------------------------------------------------------------*/
+
+static pid_t StartSim(uint8_t Nodes, std::string &Port, int &Stop)
+{
+	int ToParent[2];
+	int ToChild[2];
+	char Name[64] = {};
+
+	if((pipe(ToParent) != 0) || (pipe(ToChild) != 0))
+		return -1;
+
+	pid_t Pid = fork();
+	if(Pid == 0)
+	{
+		MCDriveSim Sim;
+		char c;
+
+		close(ToParent[0]);
+		close(ToChild[1]);
+		Sim.Configure(115200, 500, 1);
+		for(uint8_t i = 1; i <= Nodes; i++)
+			Sim.AddNode(i);
+		if(Sim.Start())
+			std::strncpy(Name, Sim.GetPortName(), sizeof(Name) - 1);
+		if(::write(ToParent[1], Name, sizeof(Name)) != sizeof(Name))
+			_exit(1);
+		while(::read(ToChild[0], &c, 1) > 0)
+			;
+		Sim.Stop();
+		_exit(0);
+	}
+
+	close(ToParent[1]);
+	close(ToChild[0]);
+	if((Pid < 0) || (::read(ToParent[0], Name, sizeof(Name)) != sizeof(Name)) || (Name[0] == 0))
+	{
+		close(ToParent[0]);
+		close(ToChild[1]);
+		return -1;
+	}
+	close(ToParent[0]);
+	Port = Name;
+	Stop = ToChild[1];
+	return Pid;
+}
+
+static bool WaitForPhase(MCBus &Bus, MCBusPhases Phase, uint32_t TimeOut)
+{
+	for(uint32_t t = 0; t < TimeOut; t += 10)
+	{
+		if(Bus.GetPhase() == Phase)
+			return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return false;
+}
+
+static bool WaitForSwitch(MCBus &Bus, uint32_t TimeOut)
+{
+	for(uint32_t t = 0; t < TimeOut; t++)
+	{
+		if(Bus.GetSwitchState() == eBusSwitchDone)
+			return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+//cycles of the caller: new speeds in, the latest states out
+static void RunCaller(MCBus &Bus, uint32_t Ms, uint32_t &Step)
+{
+	MCBusCommand Cmd[2];
+	MCBusState State[2];
+	MCBusPollValue Poll[1];
+	MCBusDiagnostics Diag;
+
+	for(uint32_t t = 0; t < Ms; t += TestCallerCycleMs)
+	{
+		Step++;
+		Cmd[0] = {eBusCmdVelocity, 0, (int32_t)(Step % 200)};
+		Cmd[1] = {eBusCmdVelocity, 0, -(int32_t)(Step % 100)};
+
+		isCallerPath = true;
+		Bus.SetCommands(Cmd, 2);
+		Bus.GetStates(State, 2);
+		Bus.GetPolls(Poll, 1);
+		Bus.GetDiagnostics(&Diag);
+		isCallerPath = false;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(TestCallerCycleMs));
+	}
+}
+
+//--- tests ---
+
+TEST(MCBusRt, ControlPathWithoutAllocationLockStdioOrSyscall)
+{
+	std::string Port;
+	int Stop = -1;
+	pid_t Sim = StartSim(2, Port, Stop);
+	ASSERT_GT(Sim, 0) << "simulation not started";
+
+	MCBus Bus;
+	uint32_t Step = 0;
+
+	Bus.AddAxis(1);
+	Bus.AddAxis(2);
+	Bus.SetPollRate(50);
+	ASSERT_TRUE(Bus.Open(Port.c_str(), 115200));
+	ASSERT_TRUE(WaitForPhase(Bus, eBusIdle, 3000));
+	Bus.Activate();
+	ASSERT_TRUE(WaitForPhase(Bus, eBusRunning, 3000));
+
+	MCBusCmdModes Modes[2] = {eBusCmdVelocity, eBusCmdVelocity};
+	ASSERT_TRUE(Bus.SwitchModes(Modes, 2));
+	ASSERT_TRUE(WaitForSwitch(Bus, 1000));
+
+	RunCaller(Bus, TestWarmUpMs, Step);
+
+	Caller = {};
+	isCounting.store(true);
+	RunCaller(Bus, TestWindowMs, Step);
+	isCounting.store(false);
+
+	TestCallerCounts Counts = Caller;
+
+	EXPECT_GT(Step, 0u);
+	EXPECT_EQ(Counts.Allocs, 0u) << "allocations by the caller";
+	EXPECT_EQ(Counts.Locks, 0u) << "locks taken by the caller";
+	EXPECT_EQ(Counts.Syscalls, 0u) << "blocking system calls of the caller";
+	EXPECT_EQ(Counts.Stdio, 0u) << "output of the caller";
+	//the worker doesn't allocate in steady state either
+	EXPECT_EQ(Allocs.load(), 0u) << "allocations of the process";
+
+	Bus.Deactivate();
+	WaitForPhase(Bus, eBusIdle, 2000);
+	Bus.Close();
+
+	close(Stop);
+	waitpid(Sim, NULL, 0);
+}
@@ -0,0 +1,135 @@
+/*---------------------------------------------------
+ * test_move_frames.cpp
+ * compares the frames and the wire time the start of a
+ * PP move takes by StartAbsMove() and by FastMovePP(),
+ * with a drive simulated by a MCDriveSim
+ *
+ * The full path is taken twice: right after the enable,
+ * where it switches to PP first, and again with PP already
+ * reported, where it sends as many frames as the fast path
+ * but waits for the SW in between. The numbers of all are
+ * recorded as properties of the test, so the before/after
+ * figures are part of its result.
+ *
+ * 2026-10-18 AW Frame
+ *
+ *--------------------------------------------------------------*/
+
+//--- includes ---
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "faulhaber/MCDrive.h"
+#include "faulhaber/MCDriveSim.h"
+
+//--- local defines ---
+
+const uint8_t TestNodeId = 1;
+//time a single step of the drive may take
+const uint32_t TestStepTimeOutMs = 5000;
+//targets close to each other, so the moves finish quickly
+const int32_t TestTarget[3] = {200, 400, 600};
+
+//--- local functions ---
+
+class MoveFrames : public ::testing::Test {
+	protected:
+		void SetUp() override
+		{
+			Sim.Configure(115200, 500, 1);
+			Sim.AddNode(TestNodeId);
+			ASSERT_TRUE(Sim.Start()) << "simulation not started";
+
+			Start = std::chrono::steady_clock::now();
+			Handler.Open(Sim.GetPortName(), 115200);
+			Drive.SetNodeId(TestNodeId);
+			Drive.Connect2MsgHandler(&Handler);
+		}
+
+		void TearDown() override
+		{
+			Handler.Close();
+			Sim.Stop();
+		}
+
+		uint32_t Now()
+		{
+			return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - Start).count();
+		}
+
+		//cycle the line and the drive until Step is no longer waiting
+		DriveCommStates Run(const std::function<DriveCommStates()> &Step)
+		{
+			DriveCommStates State = eMCWaiting;
+			uint32_t Until = Now() + TestStepTimeOutMs;
+
+			while((State == eMCWaiting) && (Now() < Until))
+			{
+				uint32_t t = Now();
+
+				Handler.Update(t);
+				Drive.SetActTime(t);
+				State = Step();
+				if(State == eMCWaiting)
+					std::this_thread::sleep_for(std::chrono::microseconds(200));
+			}
+			Drive.ResetComState();
+			return State;
+		}
+
+		MCDriveSim Sim;
+		MsgHandler Handler;
+		MCDrive Drive;
+		std::chrono::steady_clock::time_point Start;
+};
+
+//--- tests ---
+
+TEST_F(MoveFrames, FastMovePPUsesFewerFramesAndLessWireTime)
+{
+	MCMoveStats Cold;
+	MCMoveStats Full;
+	MCMoveStats Fast;
+
+	ASSERT_EQ(Run([this]{ return Drive.SendReset(); }), eMCDone);
+	ASSERT_EQ(Run([this]{ return Drive.EnableDrive(); }), eMCDone);
+
+	//the first move switches to PP too
+	ASSERT_EQ(Run([this]{ return Drive.StartAbsMove(TestTarget[0], true); }), eMCDone);
+	Drive.GetLastMoveStats(&Cold);
+	ASSERT_EQ(Run([this]{ return Drive.IsInPos(); }), eMCDone);
+
+	ASSERT_EQ(Run([this]{ return Drive.StartAbsMove(TestTarget[1], true); }), eMCDone);
+	Drive.GetLastMoveStats(&Full);
+	ASSERT_EQ(Run([this]{ return Drive.IsInPos(); }), eMCDone);
+
+	//the fast path relies on the OpMode and SW known
+	ASSERT_EQ(Run([this]{ return Drive.UpdateDriveStatus(); }), eMCDone);
+	ASSERT_EQ(Run([this]{ return Drive.FastMovePP(TestTarget[2], true, false); }), eMCDone);
+	Drive.GetLastMoveStats(&Fast);
+	ASSERT_EQ(Run([this]{ return Drive.IsInPos(); }), eMCDone);
+
+	RecordProperty("ColdTxFrames", (int)Cold.TxFrames);
+	RecordProperty("ColdRxFrames", (int)Cold.RxFrames);
+	RecordProperty("ColdWireUs", (int)Cold.WireUs);
+	RecordProperty("FullTxFrames", (int)Full.TxFrames);
+	RecordProperty("FullRxFrames", (int)Full.RxFrames);
+	RecordProperty("FullWireUs", (int)Full.WireUs);
+	RecordProperty("FastTxFrames", (int)Fast.TxFrames);
+	RecordProperty("FastRxFrames", (int)Fast.RxFrames);
+	RecordProperty("FastWireUs", (int)Fast.WireUs);
+
+	EXPECT_FALSE(Full.isFastPath);
+	EXPECT_TRUE(Fast.isFastPath);
+	EXPECT_LT(Fast.TxFrames, Cold.TxFrames);
+	EXPECT_LT(Fast.WireUs, Cold.WireUs);
+	//with PP known the full path saves the OpMode write too
+	EXPECT_LE(Fast.TxFrames, Full.TxFrames);
+	EXPECT_LT(Fast.TxFrames + Fast.RxFrames, Full.TxFrames + Full.RxFrames);
+	EXPECT_LT(Fast.WireUs, Full.WireUs);
+}